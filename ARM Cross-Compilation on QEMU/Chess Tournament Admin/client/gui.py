@@ -67,6 +67,7 @@ class ChessGUI:
         self.clock      = ChessClock(300, 0)
         self.tournament: Tournament | None = None
         self._move_uci_log: list[str] = []
+        self.state_seq  = -1      # server state version; -1 until the first STATE
         self._white_rating = 1500
         self._black_rating = 1500
 
@@ -175,7 +176,7 @@ class ChessGUI:
     # ── Mode ──────────────────────────────────────────────────────────────────
     def _build_mode_screen(self):
         self._clear()
-        self.root.geometry("500x400")
+        self.root.geometry("500x460")
         tk.Label(self.root, text=f"Welcome, {self.username}! ♟",
                  font=("Helvetica", 16, "bold"), bg=BG, fg=ACCENT).pack(pady=(28, 4))
         tk.Label(self.root, text="Choose your opponent",
@@ -185,6 +186,7 @@ class ChessGUI:
                  relief="flat", cursor="hand2", padx=14, pady=10, width=28)
         tk.Button(self.root, text="🧑  Play vs Player",         command=self._mode_pvp,        **b).pack(pady=5)
         tk.Button(self.root, text="🤖  Play vs Engine (GitHub)",command=self._mode_engine,     **b).pack(pady=5)
+        tk.Button(self.root, text="🖥  Play vs Server Engine",  command=self._mode_server_engine, **b).pack(pady=5)
         tk.Button(self.root, text="🏆  Start Tournament",       command=self._mode_tournament, **b).pack(pady=5)
 
         self._mode_status = tk.Label(self.root, text="", bg=BG, fg=DANGER,
@@ -212,11 +214,18 @@ class ChessGUI:
             if eng is None:
                 self.root.after(0, lambda: self._mode_status.config(text="❌ Engine load failed", fg=DANGER))
                 return
+            # Runs locally; the server sees a pvp game
             self.engine = eng; self.opponent = "Engine 🤖"
-            self.mode = "engine"; self.client.set_mode("engine")
+            self.mode = "engine"
             self.root.after(0, self._build_game_screen)
         threading.Thread(target=_load, daemon=True).start()
 
+    def _mode_server_engine(self):
+        # The server seats its own engine (chess_server --engine) in the
+        # free colour and plays its moves as MOVE broadcasts
+        self.opponent = "Server engine 🖥"
+        self.mode = "engine"; self.client.set_mode("engine"); self._build_game_screen()
+
     def _mode_tournament(self):
         self.tournament = Tournament(f"{self.username}'s Tournament")
         self.tournament.add_player(self.username, self._white_rating)
@@ -558,6 +567,7 @@ class ChessGUI:
         elif msg.startswith("STATE:"):
             try:
                 d = json.loads(msg[6:])
+                self.state_seq = d.get("seq", 0)
                 self.board = chess.Board(d["fen"])
                 if "white_ms" in d and not self.clock.unlimited:
                     self.clock.white_time = d["white_ms"] / 1000
@@ -565,8 +575,29 @@ class ChessGUI:
                 self._draw_board(); self._update_info()
             except Exception: pass
 
+        elif msg.startswith("DELTA:"):
+            # DELTA:<seq>:<uci>:<fen> follows every MOVE; the move itself is
+            # applied from MOVE above. A skipped seq, or a board that no
+            # longer matches the server's FEN, means we missed something —
+            # ask for a full snapshot instead of guessing.
+            parts = msg.split(":", 3)
+            try: seq = int(parts[1])
+            except (IndexError, ValueError): return
+            in_sync = (self.state_seq < 0 or seq == self.state_seq + 1) and (
+                len(parts) < 4 or
+                self.board.fen().split()[:3] == parts[3].split()[:3])
+            if in_sync:
+                self.state_seq = seq
+            else:
+                self.client.request_status()
+                self.state_seq = -1     # the STATE reply sets it again
+
         elif msg.startswith("GAMEOVER:"):
             w = msg.split(":")[1]
+            if w == "draw":
+                self._end("1/2-1/2", None)
+                messagebox.showinfo("Game Over", "🤝 Draw (stalemate)")
+                return
             r = "1-0" if w == "white" else "0-1"
             self._end(r, w)
             messagebox.showinfo("Game Over",
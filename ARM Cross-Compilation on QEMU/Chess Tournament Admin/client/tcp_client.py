@@ -32,6 +32,10 @@ class ChessTCPClient:
         if self.connected:
             self.sock.sendall((msg.strip() + "\n").encode())
 
+    def join(self, game_id: str):
+        """Switch to another game room (the server starts you in 'main')."""
+        self.send(f"JOIN:{game_id}")
+
     def auth(self, username: str):
         self.send(f"AUTH:{username}")
 
@@ -18,4 +18,4 @@ sudo chmod +x "$MOUNT/root/chess_server"
 sudo umount "$MOUNT"
 
 echo "[+] Done! chess_server is at /root/chess_server inside the image."
-echo "    Boot QEMU and run: /root/chess_server 5000"
+echo "    Boot QEMU and run: /root/chess_server 5000 --journal /root/chess.journal"
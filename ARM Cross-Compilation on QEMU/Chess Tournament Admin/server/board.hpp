@@ -0,0 +1,547 @@
+#pragma once
+/**
+ * Chess rules for the server: bitboard position, legal moves, FEN.
+ *
+ * Squares are a1 = 0 … h8 = 63. A Position keeps one bitboard per piece
+ * type and per colour plus a 64-square mailbox; make() updates them in
+ * place, so the next FEN is one walk over the board however long the
+ * game is. Sliding attacks are magic-bitboard lookups. The magics are
+ * searched once at startup from fixed seeds (~40 ms natively), which
+ * keeps 128 constants out of the source and behaves the same on the ARM
+ * target, where PEXT does not exist anyway.
+ *
+ * Legality: moves are generated pseudo-legally and most are accepted as
+ * they are. Only king moves, en passant, pinned pieces and every move
+ * while in check are verified, the last three by playing them on a copy.
+ * Checked with perft (perft.cpp).
+ */
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace chess {
+
+using Bitboard = uint64_t;
+
+enum Color : uint8_t { WHITE, BLACK };
+enum PieceType : uint8_t { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NO_TYPE };
+constexpr uint8_t NO_PIECE = 12;           // mailbox holds color * 6 + type
+
+enum : uint8_t { CASTLE_WK = 1, CASTLE_WQ = 2, CASTLE_BK = 4, CASTLE_BQ = 8 };
+enum : uint8_t { MOVE_CAPTURE = 1, MOVE_EP = 2, MOVE_CASTLE = 4, MOVE_DOUBLE = 8 };
+
+constexpr Bitboard bit(int sq) { return 1ULL << sq; }
+inline int lsb(Bitboard b)       { return __builtin_ctzll(b); }
+inline int popcount(Bitboard b)  { return __builtin_popcountll(b); }
+inline int pop_lsb(Bitboard& b)  { int s = lsb(b); b &= b - 1; return s; }
+
+constexpr Bitboard RANK_1 = 0xFFULL,  RANK_8 = RANK_1 << 56;
+constexpr Bitboard FILE_A = 0x0101010101010101ULL, FILE_H = FILE_A << 7;
+
+struct Move {
+    uint8_t from;
+    uint8_t to;
+    uint8_t promo;   // KNIGHT … QUEEN when promoting, else NO_TYPE
+    uint8_t flags;
+
+    std::string uci() const {
+        std::string s = {char('a' + from % 8), char('1' + from / 8),
+                         char('a' + to % 8),   char('1' + to / 8)};
+        if (promo != NO_TYPE) s += "pnbrqk"[promo];
+        return s;
+    }
+};
+
+struct MoveList {
+    Move moves[256];
+    int  size = 0;
+
+    void add(int from, int to, uint8_t flags, uint8_t promo = NO_TYPE) {
+        moves[size++] = Move{uint8_t(from), uint8_t(to), promo, flags};
+    }
+    const Move* begin() const { return moves; }
+    const Move* end()   const { return moves + size; }
+};
+
+// ── Attack tables ─────────────────────────────────────────────────────────────
+namespace detail {
+
+constexpr int ROOK_DIRS[4][2]   = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+constexpr int BISHOP_DIRS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Slow reference: walk each ray up to and including the first blocker
+inline Bitboard ray_attacks(int sq, Bitboard occ, const int (*dirs)[2]) {
+    Bitboard a = 0;
+    for (int d = 0; d < 4; ++d) {
+        int f = sq % 8 + dirs[d][0], r = sq / 8 + dirs[d][1];
+        while (f >= 0 && f < 8 && r >= 0 && r < 8) {
+            a |= bit(r * 8 + f);
+            if (occ & bit(r * 8 + f)) break;
+            f += dirs[d][0];
+            r += dirs[d][1];
+        }
+    }
+    return a;
+}
+
+struct Magic {
+    Bitboard  mask;       // relevant blockers (board edges excluded)
+    Bitboard  magic;
+    Bitboard* attacks;    // 1 << popcount(mask) entries
+    unsigned  shift;
+
+    Bitboard lookup(Bitboard occ) const { return attacks[((occ & mask) * magic) >> shift]; }
+};
+
+struct Tables {
+    Bitboard knight[64], king[64], pawn[2][64];   // pawn[c][sq]: squares a c-pawn on sq attacks
+    Bitboard between[64][64];                     // strictly between two aligned squares
+    uint8_t  castle_mask[64];                     // rights kept when a move touches the square
+    Magic    rook[64], bishop[64];
+    std::vector<Bitboard> rook_table, bishop_table;
+
+    Tables() {
+        const int knight_steps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2},
+                                        {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        const int king_steps[8][2]   = {{1, 0}, {1, 1}, {0, 1}, {-1, 1},
+                                        {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+        auto on_board = [](int f, int r) { return f >= 0 && f < 8 && r >= 0 && r < 8; };
+
+        for (int sq = 0; sq < 64; ++sq) {
+            const int f = sq % 8, r = sq / 8;
+            knight[sq] = king[sq] = pawn[WHITE][sq] = pawn[BLACK][sq] = 0;
+            for (auto& s : knight_steps)
+                if (on_board(f + s[0], r + s[1])) knight[sq] |= bit((r + s[1]) * 8 + f + s[0]);
+            for (auto& s : king_steps)
+                if (on_board(f + s[0], r + s[1])) king[sq] |= bit((r + s[1]) * 8 + f + s[0]);
+            for (int df : {-1, 1}) {
+                if (on_board(f + df, r + 1)) pawn[WHITE][sq] |= bit((r + 1) * 8 + f + df);
+                if (on_board(f + df, r - 1)) pawn[BLACK][sq] |= bit((r - 1) * 8 + f + df);
+            }
+
+            for (int to = 0; to < 64; ++to) between[sq][to] = 0;
+            for (auto& s : king_steps) {
+                Bitboard path = 0;
+                for (int cf = f + s[0], cr = r + s[1]; on_board(cf, cr); cf += s[0], cr += s[1]) {
+                    between[sq][cr * 8 + cf] = path;
+                    path |= bit(cr * 8 + cf);
+                }
+            }
+            castle_mask[sq] = 0xF;
+        }
+        castle_mask[4]  = uint8_t(~(CASTLE_WK | CASTLE_WQ) & 0xF);   // e1
+        castle_mask[7]  = uint8_t(~CASTLE_WK & 0xF);                 // h1
+        castle_mask[0]  = uint8_t(~CASTLE_WQ & 0xF);                 // a1
+        castle_mask[60] = uint8_t(~(CASTLE_BK | CASTLE_BQ) & 0xF);   // e8
+        castle_mask[63] = uint8_t(~CASTLE_BK & 0xF);                 // h8
+        castle_mask[56] = uint8_t(~CASTLE_BQ & 0xF);                 // a8
+
+        init_magics(rook, rook_table, ROOK_DIRS);
+        init_magics(bishop, bishop_table, BISHOP_DIRS);
+    }
+
+private:
+    // Plain magic bitboards: per square, try sparse random multipliers until
+    // every blocker subset hashes to a slot holding its own attack set
+    static void init_magics(Magic* magics, std::vector<Bitboard>& table,
+                            const int (*dirs)[2]) {
+        auto relevant = [dirs](int sq) {
+            const Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (sq / 8 * 8)))
+                                 | ((FILE_A | FILE_H) & ~(FILE_A << (sq % 8)));
+            return ray_attacks(sq, 0, dirs) & ~edges;
+        };
+        size_t total = 0;
+        for (int sq = 0; sq < 64; ++sq) total += size_t(1) << popcount(relevant(sq));
+        table.assign(total, 0);
+
+        // xorshift64*, re-seeded per square from its rank: these seeds are
+        // known to reach a working magic within a few hundred tries
+        static constexpr uint64_t SEEDS[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+        uint64_t seed = 0;
+        auto rng = [&seed] {
+            seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+            return seed * 2685821657736338717ULL;
+        };
+
+        std::vector<Bitboard> occ(4096), ref(4096);
+        std::vector<int>      epoch(4096, 0);
+        int attempt = 0;
+        Bitboard* next = table.data();
+        for (int sq = 0; sq < 64; ++sq) {
+            Magic& m  = magics[sq];
+            m.mask    = relevant(sq);
+            m.shift   = 64 - unsigned(popcount(m.mask));
+            m.attacks = next;
+
+            size_t n = 0;
+            Bitboard b = 0;
+            do {                        // every subset of mask (carry-rippler)
+                occ[n] = b;
+                ref[n] = ray_attacks(sq, b, dirs);
+                ++n;
+                b = (b - m.mask) & m.mask;
+            } while (b);
+            next += n;
+
+            seed = SEEDS[sq / 8];
+            for (size_t i = 0; i < n; ) {
+                do m.magic = rng() & rng() & rng();
+                while (popcount((m.mask * m.magic) >> 56) < 6);
+                ++attempt;
+                for (i = 0; i < n; ++i) {
+                    const size_t idx = (occ[i] * m.magic) >> m.shift;
+                    if (epoch[idx] < attempt) {
+                        epoch[idx]     = attempt;
+                        m.attacks[idx] = ref[i];
+                    } else if (m.attacks[idx] != ref[i]) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
+inline const Tables TABLES;   // built once at program start
+
+} // namespace detail
+
+inline Bitboard rook_attacks(int sq, Bitboard occ)   { return detail::TABLES.rook[sq].lookup(occ); }
+inline Bitboard bishop_attacks(int sq, Bitboard occ) { return detail::TABLES.bishop[sq].lookup(occ); }
+
+// ── Position ──────────────────────────────────────────────────────────────────
+class Position {
+public:
+    static constexpr const char* START_FEN =
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    Position() {
+        clear();
+        set_fen(START_FEN);
+    }
+
+    // false (position unchanged) if malformed or without one king per side
+    bool set_fen(const std::string& fen) {
+        Position p = *this;
+        p.clear();
+        size_t i = 0;
+        int f = 0, r = 7;
+        for (; i < fen.size() && fen[i] != ' '; ++i) {
+            const char c = fen[i];
+            if (c == '/') {
+                if (f != 8 || r == 0) return false;
+                f = 0; --r;
+            } else if (c >= '1' && c <= '8') {
+                f += c - '0';
+                if (f > 8) return false;
+            } else {
+                static const std::string NAMES = "PNBRQKpnbrqk";
+                const size_t k = NAMES.find(c);
+                if (k == std::string::npos || f > 7) return false;
+                p.put(r * 8 + f, uint8_t(k));
+                ++f;
+            }
+        }
+        if (f != 8 || r != 0) return false;
+        if (popcount(p.pieces(WHITE, KING)) != 1 || popcount(p.pieces(BLACK, KING)) != 1) return false;
+
+        auto field = [&fen, &i]() {
+            while (i < fen.size() && fen[i] == ' ') ++i;
+            const size_t start = i;
+            while (i < fen.size() && fen[i] != ' ') ++i;
+            return fen.substr(start, i - start);
+        };
+        const std::string side = field(), castling = field(), ep = field();
+        const std::string half = field(), full = field();
+        if (side != "w" && side != "b") return false;
+        p.side_ = side == "w" ? WHITE : BLACK;
+        for (char c : castling) {
+            if      (c == 'K') p.castling_ |= CASTLE_WK;
+            else if (c == 'Q') p.castling_ |= CASTLE_WQ;
+            else if (c == 'k') p.castling_ |= CASTLE_BK;
+            else if (c == 'q') p.castling_ |= CASTLE_BQ;
+            else if (c != '-') return false;
+        }
+        if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && (ep[1] == '3' || ep[1] == '6'))
+            p.ep_ = int8_t((ep[1] - '1') * 8 + ep[0] - 'a');
+        else if (!ep.empty() && ep != "-")
+            return false;
+        p.halfmove_ = half.empty() ? 0 : uint16_t(std::atoi(half.c_str()));
+        p.fullmove_ = full.empty() ? 1 : uint16_t(std::max(1, std::atoi(full.c_str())));
+        *this = p;
+        return true;
+    }
+
+    std::string fen() const {
+        std::string s;
+        s.reserve(90);
+        for (int r = 7; r >= 0; --r) {
+            int empty = 0;
+            for (int f = 0; f < 8; ++f) {
+                const uint8_t p = board_[r * 8 + f];
+                if (p == NO_PIECE) { ++empty; continue; }
+                if (empty) { s += char('0' + empty); empty = 0; }
+                s += "PNBRQKpnbrqk"[p];
+            }
+            if (empty) s += char('0' + empty);
+            if (r) s += '/';
+        }
+        s += side_ == WHITE ? " w " : " b ";
+        if (castling_ & CASTLE_WK) s += 'K';
+        if (castling_ & CASTLE_WQ) s += 'Q';
+        if (castling_ & CASTLE_BK) s += 'k';
+        if (castling_ & CASTLE_BQ) s += 'q';
+        if (!castling_) s += '-';
+        s += ' ';
+        if (ep_ >= 0) { s += char('a' + ep_ % 8); s += char('1' + ep_ / 8); }
+        else          s += '-';
+        s += ' ';
+        s += std::to_string(halfmove_);
+        s += ' ';
+        s += std::to_string(fullmove_);
+        return s;
+    }
+
+    Color side_to_move() const { return side_; }
+
+    bool in_check() const {
+        const int ksq = lsb(pieces(side_, KING));
+        return attackers_to(ksq, occupied()) & by_color_[side_ ^ 1];
+    }
+
+    void legal_moves(MoveList& out) const {
+        MoveList pseudo;
+        pseudo_moves(pseudo);
+        const Color    them     = Color(side_ ^ 1);
+        const int      ksq      = lsb(pieces(side_, KING));
+        const Bitboard occ      = occupied();
+        const bool     checked  = attackers_to(ksq, occ) & by_color_[them];
+        const Bitboard pins     = pinned();
+        out.size = 0;
+        for (const Move& m : pseudo) {
+            if (m.from == ksq) {
+                // Castling was fully checked when generated
+                if ((m.flags & MOVE_CASTLE) || !(attackers_to(m.to, occ ^ bit(ksq)) & by_color_[them]))
+                    out.moves[out.size++] = m;
+            } else if (!checked && !(pins & bit(m.from)) && !(m.flags & MOVE_EP)) {
+                out.moves[out.size++] = m;
+            } else {
+                Position next = *this;
+                next.make(m);
+                if (!(next.attackers_to(ksq, next.occupied()) & next.by_color_[them]))
+                    out.moves[out.size++] = m;
+            }
+        }
+    }
+
+    // The legal move named by uci (e2e4, e7e8q, e1g1 for castling)
+    bool find_move(const std::string& uci, Move& out) const {
+        if (uci.size() != 4 && uci.size() != 5) return false;
+        auto square = [&uci](size_t i) {
+            const char f = char(std::tolower(static_cast<unsigned char>(uci[i])));
+            const char r = uci[i + 1];
+            return (f >= 'a' && f <= 'h' && r >= '1' && r <= '8') ? (r - '1') * 8 + (f - 'a') : -1;
+        };
+        const int from = square(0), to = square(2);
+        if (from < 0 || to < 0) return false;
+        uint8_t promo = NO_TYPE;
+        if (uci.size() == 5) {
+            switch (std::tolower(static_cast<unsigned char>(uci[4]))) {
+            case 'n': promo = KNIGHT; break;
+            case 'b': promo = BISHOP; break;
+            case 'r': promo = ROOK;   break;
+            case 'q': promo = QUEEN;  break;
+            default:  return false;
+            }
+        }
+        MoveList list;
+        legal_moves(list);
+        for (const Move& m : list) {
+            if (m.from == from && m.to == to && m.promo == promo) { out = m; return true; }
+        }
+        return false;
+    }
+
+    // Play a move from legal_moves() (or pseudo_moves(), for legality tests)
+    void make(const Move& m) {
+        const Color   us    = side_;
+        const Color   them  = Color(us ^ 1);
+        const uint8_t piece = board_[m.from];
+        ++halfmove_;
+        if (m.flags & MOVE_EP) {
+            remove(m.to + (us == WHITE ? -8 : 8));
+            halfmove_ = 0;
+        } else if (board_[m.to] != NO_PIECE) {
+            remove(m.to);
+            halfmove_ = 0;
+        }
+        remove(m.from);
+        put(m.to, m.promo != NO_TYPE ? uint8_t(us * 6 + m.promo) : piece);
+        if (piece % 6 == PAWN) halfmove_ = 0;
+        if (m.flags & MOVE_CASTLE) {
+            const int rook_from = m.to > m.from ? m.to + 1 : m.to - 2;
+            const int rook_to   = m.to > m.from ? m.to - 1 : m.to + 1;
+            const uint8_t rook  = board_[rook_from];
+            remove(rook_from);
+            put(rook_to, rook);
+        }
+        castling_ &= detail::TABLES.castle_mask[m.from] & detail::TABLES.castle_mask[m.to];
+        // Only record en passant when a pawn could actually take
+        ep_ = -1;
+        if (m.flags & MOVE_DOUBLE) {
+            const int e = (m.from + m.to) / 2;
+            if (detail::TABLES.pawn[us][e] & pieces(them, PAWN)) ep_ = int8_t(e);
+        }
+        if (us == BLACK) ++fullmove_;
+        side_ = them;
+    }
+
+private:
+    void clear() {
+        for (auto& b : by_type_)  b = 0;
+        for (auto& b : by_color_) b = 0;
+        for (auto& p : board_)    p = NO_PIECE;
+        side_ = WHITE; castling_ = 0; ep_ = -1; halfmove_ = 0; fullmove_ = 1;
+    }
+
+    void put(int sq, uint8_t p) {
+        board_[sq] = p;
+        by_type_[p % 6] |= bit(sq);
+        by_color_[p / 6] |= bit(sq);
+    }
+
+    void remove(int sq) {
+        const uint8_t p = board_[sq];
+        by_type_[p % 6] &= ~bit(sq);
+        by_color_[p / 6] &= ~bit(sq);
+        board_[sq] = NO_PIECE;
+    }
+
+    Bitboard pieces(Color c, PieceType t) const { return by_color_[c] & by_type_[t]; }
+    Bitboard occupied() const { return by_color_[WHITE] | by_color_[BLACK]; }
+
+    // Pieces of either colour attacking sq, given occupancy occ
+    Bitboard attackers_to(int sq, Bitboard occ) const {
+        const auto& t = detail::TABLES;
+        return (t.pawn[BLACK][sq] & pieces(WHITE, PAWN))
+             | (t.pawn[WHITE][sq] & pieces(BLACK, PAWN))
+             | (t.knight[sq] & by_type_[KNIGHT])
+             | (t.king[sq] & by_type_[KING])
+             | (bishop_attacks(sq, occ) & (by_type_[BISHOP] | by_type_[QUEEN]))
+             | (rook_attacks(sq, occ) & (by_type_[ROOK] | by_type_[QUEEN]));
+    }
+
+    // Side-to-move pieces that are the only blocker between their king and a slider
+    Bitboard pinned() const {
+        const Color them = Color(side_ ^ 1);
+        const int   ksq  = lsb(pieces(side_, KING));
+        const Bitboard occ = occupied();
+        Bitboard snipers = (rook_attacks(ksq, 0)   & (pieces(them, ROOK)   | pieces(them, QUEEN)))
+                         | (bishop_attacks(ksq, 0) & (pieces(them, BISHOP) | pieces(them, QUEEN)));
+        Bitboard pins = 0;
+        while (snipers) {
+            const Bitboard b = detail::TABLES.between[ksq][pop_lsb(snipers)] & occ;
+            if (b && !(b & (b - 1)) && (b & by_color_[side_])) pins |= b;
+        }
+        return pins;
+    }
+
+    void pseudo_moves(MoveList& out) const {
+        const auto&    t     = detail::TABLES;
+        const Color    us    = side_;
+        const Color    them  = Color(us ^ 1);
+        const Bitboard occ   = occupied();
+        const Bitboard own   = by_color_[us];
+        const Bitboard enemy = by_color_[them];
+        const int      up    = us == WHITE ? 8 : -8;
+        const Bitboard last  = us == WHITE ? RANK_8 : RANK_1;
+        const Bitboard third = us == WHITE ? RANK_1 << 16 : RANK_1 << 40;
+        auto shift_up = [us](Bitboard b) { return us == WHITE ? b << 8 : b >> 8; };
+        auto add_pawn = [&out, last](int from, int to, uint8_t flags) {
+            if (bit(to) & last) {
+                for (uint8_t p : {QUEEN, ROOK, BISHOP, KNIGHT}) out.add(from, to, flags, p);
+            } else {
+                out.add(from, to, flags);
+            }
+        };
+
+        // Pawns
+        const Bitboard pawns = pieces(us, PAWN);
+        Bitboard single = shift_up(pawns) & ~occ;
+        Bitboard dbl    = shift_up(single & third) & ~occ;
+        while (single) { const int to = pop_lsb(single); add_pawn(to - up, to, 0); }
+        while (dbl)    { const int to = pop_lsb(dbl);    out.add(to - 2 * up, to, MOVE_DOUBLE); }
+        for (Bitboard b = pawns; b; ) {
+            const int from = pop_lsb(b);
+            for (Bitboard caps = t.pawn[us][from] & enemy; caps; )
+                add_pawn(from, pop_lsb(caps), MOVE_CAPTURE);
+        }
+        if (ep_ >= 0) {
+            for (Bitboard b = t.pawn[them][ep_] & pawns; b; )
+                out.add(pop_lsb(b), ep_, MOVE_CAPTURE | MOVE_EP);
+        }
+
+        // Pieces
+        auto add_targets = [&out, enemy](int from, Bitboard targets) {
+            while (targets) {
+                const int to = pop_lsb(targets);
+                out.add(from, to, (enemy & bit(to)) ? MOVE_CAPTURE : 0);
+            }
+        };
+        for (Bitboard b = pieces(us, KNIGHT); b; ) { const int s = pop_lsb(b); add_targets(s, t.knight[s] & ~own); }
+        for (Bitboard b = pieces(us, BISHOP); b; ) { const int s = pop_lsb(b); add_targets(s, bishop_attacks(s, occ) & ~own); }
+        for (Bitboard b = pieces(us, ROOK);   b; ) { const int s = pop_lsb(b); add_targets(s, rook_attacks(s, occ) & ~own); }
+        for (Bitboard b = pieces(us, QUEEN);  b; ) {
+            const int s = pop_lsb(b);
+            add_targets(s, (rook_attacks(s, occ) | bishop_attacks(s, occ)) & ~own);
+        }
+        const int ksq = lsb(pieces(us, KING));
+        add_targets(ksq, t.king[ksq] & ~own);
+
+        // Castling: rights, empty path, rook in place, king not passing through check
+        const uint8_t k_right = us == WHITE ? CASTLE_WK : CASTLE_BK;
+        const uint8_t q_right = us == WHITE ? CASTLE_WQ : CASTLE_BQ;
+        const int     base    = us == WHITE ? 0 : 56;
+        const uint8_t rook    = uint8_t(us * 6 + ROOK);
+        auto safe = [&](int sq) { return !(attackers_to(sq, occ) & enemy); };
+        if ((castling_ & (k_right | q_right)) && ksq == base + 4 && safe(ksq)) {
+            if ((castling_ & k_right) && board_[base + 7] == rook
+                && !(occ & (bit(base + 5) | bit(base + 6)))
+                && safe(base + 5) && safe(base + 6))
+                out.add(ksq, base + 6, MOVE_CASTLE);
+            if ((castling_ & q_right) && board_[base] == rook
+                && !(occ & (bit(base + 1) | bit(base + 2) | bit(base + 3)))
+                && safe(base + 3) && safe(base + 2))
+                out.add(ksq, base + 2, MOVE_CASTLE);
+        }
+    }
+
+    Bitboard by_type_[6];
+    Bitboard by_color_[2];
+    uint8_t  board_[64];
+    Color    side_;
+    uint8_t  castling_;
+    int8_t   ep_;           // en passant target square, -1 if none
+    uint16_t halfmove_;
+    uint16_t fullmove_;
+};
+
+// Leaf count of the legal move tree; depth 1 counts moves without playing them
+inline uint64_t perft(const Position& pos, int depth) {
+    if (depth <= 0) return 1;
+    MoveList list;
+    pos.legal_moves(list);
+    if (depth == 1) return uint64_t(list.size);
+    uint64_t nodes = 0;
+    for (const Move& m : list) {
+        Position next = pos;
+        next.make(m);
+        nodes += perft(next, depth - 1);
+    }
+    return nodes;
+}
+
+} // namespace chess
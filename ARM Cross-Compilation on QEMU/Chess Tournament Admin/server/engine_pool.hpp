@@ -0,0 +1,344 @@
+#pragma once
+/**
+ * UCI engines for PLAYER_VS_ENGINE games.
+ *
+ * The pool starts --engines N processes of --engine PATH once, at server
+ * start, and lends one to a game the first time that game needs an engine
+ * move. It takes the engine back when the game ends, switches to pvp or
+ * loses its last member; ucinewgame + isready reset it before the next
+ * game. Games asking while every engine is busy wait in a FIFO.
+ *
+ * Each Engine speaks UCI over two pipes wrapped in posix::stream_descriptor
+ * and serialised on its own strand. go() only queues the command — the
+ * search runs in the engine process, bestmove comes back as an ordinary
+ * read completion and the callback posts it to the game's strand, so an
+ * engine thinking for seconds never holds an I/O thread. A request that
+ * times out, or an engine that exits, fails the pending callback and the
+ * process is killed; dead engines are replaced with a fresh process when
+ * they are returned.
+ *
+ * A replacement that cannot start, or fails the handshake, is retried
+ * after a backoff that doubles up to MAX_BACKOFF. The pool counts the
+ * engines that are actually up: with none left and the last start
+ * failed, enabled() turns false and waiting games get a null engine
+ * instead of waiting forever.
+ */
+#include <boost/asio.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ── Engine ────────────────────────────────────────────────────────────────────
+class Engine : public std::enable_shared_from_this<Engine> {
+public:
+    // ok = false: engine died or timed out. arg: the move for bestmove.
+    using Done = std::function<void(bool ok, const std::string& arg)>;
+
+    Engine(boost::asio::io_context& io, int id)
+        : strand_(boost::asio::make_strand(io)),
+          to_engine_(strand_), from_engine_(strand_), timer_(strand_), id_(id) {}
+
+    ~Engine() {
+        boost::system::error_code ignore;
+        to_engine_.close(ignore);
+        from_engine_.close(ignore);
+        if (pid_ > 0) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+        }
+    }
+
+    // fork/exec path with its stdin/stdout on our pipes
+    bool spawn(const std::string& path) {
+        int in[2], out[2];
+        if (pipe2(in, O_CLOEXEC) < 0) return false;
+        if (pipe2(out, O_CLOEXEC) < 0) {
+            close(in[0]); close(in[1]);
+            return false;
+        }
+        const long max_fd = std::min(sysconf(_SC_OPEN_MAX), 65536L);
+        pid_ = fork();
+        if (pid_ == 0) {
+            // Child: only async-signal-safe calls until exec
+            dup2(in[0], STDIN_FILENO);
+            dup2(out[1], STDOUT_FILENO);
+            for (long fd = 3; fd < max_fd; ++fd) close(int(fd));
+            execl(path.c_str(), path.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(in[0]);
+        close(out[1]);
+        if (pid_ < 0) {
+            close(in[1]); close(out[0]);
+            return false;
+        }
+        to_engine_.assign(in[1]);
+        from_engine_.assign(out[0]);
+        return true;
+    }
+
+    // uci → uciok, isready → readyok
+    void handshake(std::function<void(bool)> done) {
+        boost::asio::post(strand_, [self = shared_from_this(), done = std::move(done)] {
+            self->do_read();
+            self->request("uci\n", "uciok", HANDSHAKE_TIMEOUT,
+                [self, done](bool ok, const std::string&) {
+                    if (!ok) { done(false); return; }
+                    self->request("isready\n", "readyok", HANDSHAKE_TIMEOUT,
+                        [done](bool ok, const std::string&) { done(ok); });
+                });
+        });
+    }
+
+    // Forget the last game before the engine is lent out again
+    void new_game(std::function<void(bool)> done) {
+        boost::asio::post(strand_, [self = shared_from_this(), done = std::move(done)] {
+            self->request("ucinewgame\nisready\n", "readyok", HANDSHAKE_TIMEOUT,
+                [done](bool ok, const std::string&) { done(ok); });
+        });
+    }
+
+    // commands: the position and go lines; done gets bestmove's move
+    void go(std::string commands, std::chrono::milliseconds timeout, Done done) {
+        boost::asio::post(strand_,
+            [self = shared_from_this(), commands = std::move(commands), timeout, done = std::move(done)] {
+                self->request(commands, "bestmove", timeout, done);
+            });
+    }
+
+    int  id() const { return id_; }
+    bool dead() const { return dead_; }
+    const std::string& name() const { return name_; }   // "id name" from the engine
+
+    static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{10};
+
+private:
+    // One request at a time; the caller (pool or game) never overlaps them
+    void request(std::string commands, std::string token, std::chrono::milliseconds timeout,
+                 Done done) {
+        if (dead_) { done(false, ""); return; }
+        token_   = std::move(token);
+        pending_ = std::move(done);
+        timer_.expires_after(timeout);
+        timer_.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+            if (ec || !self->pending_) return;
+            std::cout << "[!] Engine " << self->id_ << ": no " << self->token_ << ", stopping it\n";
+            self->fail();
+        });
+        write(std::move(commands));
+    }
+
+    void write(std::string data) {
+        out_.push_back(std::move(data));
+        if (out_.size() == 1) do_write();
+    }
+
+    void do_write() {
+        boost::asio::async_write(to_engine_, boost::asio::buffer(out_.front()),
+            [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+                if (ec) { self->fail(); return; }
+                self->out_.pop_front();
+                if (!self->out_.empty()) self->do_write();
+            });
+    }
+
+    void do_read() {
+        boost::asio::async_read_until(from_engine_, buf_, '\n',
+            [self = shared_from_this()](boost::system::error_code ec, std::size_t n) {
+                if (ec) { self->fail(); return; }
+                std::string line(boost::asio::buffer_cast<const char*>(self->buf_.data()), n - 1);
+                self->buf_.consume(n);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                self->handle_line(line);
+                self->do_read();
+            });
+    }
+
+    void handle_line(const std::string& line) {
+        if (line.rfind("id name ", 0) == 0) { name_ = line.substr(8); return; }
+        if (!pending_ || line.compare(0, token_.size(), token_) != 0) return;
+        if (line.size() > token_.size() && line[token_.size()] != ' ') return;
+        // bestmove <move> [ponder <move>]
+        std::string arg;
+        if (line.size() > token_.size() + 1) {
+            arg = line.substr(token_.size() + 1);
+            arg = arg.substr(0, arg.find(' '));
+        }
+        timer_.cancel();
+        Done done = std::move(pending_);
+        pending_  = nullptr;
+        done(true, arg);
+    }
+
+    // The process is unusable from here on; the pool replaces it. A stuck
+    // one may still be searching, so it is killed now rather than when the
+    // last reference goes.
+    void fail() {
+        if (!dead_) std::cout << "[!] Engine " << id_ << " lost\n";
+        dead_ = true;
+        boost::system::error_code ignore;
+        to_engine_.close(ignore);
+        from_engine_.close(ignore);
+        timer_.cancel();
+        if (pid_ > 0) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+            pid_ = -1;
+        }
+        if (pending_) {
+            Done done = std::move(pending_);
+            pending_  = nullptr;
+            done(false, "");
+        }
+    }
+
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::posix::stream_descriptor to_engine_;     // engine stdin
+    boost::asio::posix::stream_descriptor from_engine_;   // engine stdout
+    boost::asio::steady_timer timer_;
+    boost::asio::streambuf    buf_;
+    std::deque<std::string>   out_;
+    std::string               token_;     // line that completes pending_
+    Done                      pending_;
+    std::string               name_ = "engine";
+    pid_t                     pid_  = -1;
+    int                       id_;
+    std::atomic<bool>         dead_{false};   // read by the pool from other strands
+};
+
+// ── EnginePool ────────────────────────────────────────────────────────────────
+class EnginePool {
+public:
+    // engine is null when the pool has none left to give
+    using Ready = std::function<void(std::shared_ptr<Engine>)>;
+
+    static constexpr std::chrono::seconds MAX_BACKOFF{60};
+
+    explicit EnginePool(boost::asio::io_context& io)
+        : io_(io), strand_(boost::asio::make_strand(io)) {}
+
+    // Before io.run(); size 0 leaves engine games disabled
+    void start(const std::string& path, int size) {
+        path_ = path;
+        size_ = size;
+        for (int i = 0; i < size; ++i) add_engine();
+    }
+
+    bool configured() const { return size_ > 0; }
+
+    // Any thread: an engine is up, or the first ones are still starting
+    bool enabled() const { return live_ > 0 || (starting_ > 0 && failures_ == 0); }
+
+    // ready(engine) runs on the pool strand as soon as an engine is free,
+    // or with null once no engine can be had
+    void acquire(Ready ready) {
+        boost::asio::post(strand_, [this, ready = std::move(ready)]() mutable {
+            while (!idle_.empty() && idle_.front()->dead()) {   // died while idle
+                idle_.pop_front();
+                lost();
+            }
+            if (!idle_.empty()) {
+                auto e = std::move(idle_.front());
+                idle_.pop_front();
+                ready(std::move(e));
+            } else if (enabled()) {
+                waiters_.push_back(std::move(ready));
+            } else {
+                ready(nullptr);
+            }
+        });
+    }
+
+    void release(std::shared_ptr<Engine> e) {
+        if (e->dead()) {
+            boost::asio::post(strand_, [this] { lost(); });
+            return;
+        }
+        e->new_game([this, e](bool ok) {
+            boost::asio::post(strand_, [this, e, ok] {
+                if (ok) make_available(e);
+                else    lost();
+            });
+        });
+    }
+
+private:
+    // Pool strand (or before run)
+    void add_engine() {
+        auto e = std::make_shared<Engine>(io_, ++next_id_);
+        if (!e->spawn(path_)) {
+            std::cout << "[!] Engine " << e->id() << ": cannot start " << path_ << "\n";
+            start_failed();
+            return;
+        }
+        starting_++;
+        e->handshake([this, e](bool ok) {
+            boost::asio::post(strand_, [this, e, ok] {
+                starting_--;
+                if (!ok) {
+                    std::cout << "[!] Engine " << e->id() << ": no UCI handshake from " << path_ << "\n";
+                    start_failed();
+                    return;
+                }
+                failures_ = 0;
+                live_++;
+                std::cout << "[+] Engine " << e->id() << " ready: " << e->name() << "\n";
+                make_available(e);
+            });
+        });
+    }
+
+    // A live engine was discarded: replace it at once, like a fresh start
+    void lost() {
+        live_--;
+        add_engine();
+    }
+
+    // Spawn or handshake failed: try the slot again later, and stop
+    // anyone waiting if nothing is left to wait for
+    void start_failed() {
+        failures_++;
+        const auto delay = std::min<std::chrono::seconds>(
+            std::chrono::seconds(1L << std::min(failures_.load() - 1, 6)), MAX_BACKOFF);
+        auto retry = std::make_shared<boost::asio::steady_timer>(strand_, delay);
+        retry->async_wait([this, retry](boost::system::error_code ec) {
+            if (!ec) add_engine();
+        });
+        if (!enabled()) {
+            std::cout << "[!] Engine pool: no engine available, retrying in "
+                      << delay.count() << " s\n";
+            auto waiters = std::move(waiters_);
+            waiters_.clear();
+            for (auto& ready : waiters) ready(nullptr);
+        }
+    }
+
+    void make_available(std::shared_ptr<Engine> e) {
+        if (waiters_.empty()) { idle_.push_back(std::move(e)); return; }
+        Ready ready = std::move(waiters_.front());
+        waiters_.pop_front();
+        ready(std::move(e));
+    }
+
+    boost::asio::io_context& io_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    std::string path_;
+    int         size_    = 0;
+    int         next_id_ = 0;
+    std::atomic<int> live_{0};       // handshake done, not yet discarded (lent or idle)
+    std::atomic<int> starting_{0};   // spawned, handshake pending
+    std::atomic<int> failures_{0};   // starts failed in a row
+    std::deque<std::shared_ptr<Engine>> idle_;      // strand only
+    std::deque<Ready>                   waiters_;   // strand only
+};
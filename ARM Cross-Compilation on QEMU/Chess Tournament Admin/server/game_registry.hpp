@@ -0,0 +1,135 @@
+#pragma once
+/**
+ * Game rooms: one GameState per game ID plus the sessions watching it.
+ *
+ * Each game owns a strand on the server's io_context. Everything that
+ * reads or changes its state or member list is posted to that strand, so
+ * a game needs no lock and pool threads never queue behind each other on
+ * one — they just pick up whichever game has work. Sessions look their
+ * game up once (JOIN) and then hold a shared_ptr to it.
+ *
+ * The ID → game map is split into SHARDS independently locked buckets;
+ * those locks cover only the map itself, never game state or I/O.
+ *
+ * With a journal set, every game the registry creates records its
+ * changes there (journal.hpp); restore() rebuilds games at startup, and
+ * a dropped game's records are forgotten so compaction can reclaim them.
+ */
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "game_state.hpp"
+#include "journal.hpp"
+
+class Session;
+class Engine;
+
+using GameStrand = boost::asio::strand<boost::asio::io_context::executor_type>;
+
+struct Game : std::enable_shared_from_this<Game> {
+    Game(std::string game_id, boost::asio::io_context& io)
+        : id(std::move(game_id)), strand(boost::asio::make_strand(io)),
+          flag_timer(strand), idle_timer(strand) {}
+
+    const std::string id;
+    GameStrand        strand;
+    GameState         state;     // strand only
+    std::set<std::shared_ptr<Session>> members;   // strand only: players + spectators
+    std::shared_ptr<const std::string> snapshot;  // strand only: cached STATE line, reset on change
+    std::atomic<int>  joining{0};   // handed out by get_or_create, not yet a member
+    Journal*          journal = nullptr;   // null without --journal
+    boost::asio::steady_timer flag_timer;    // timed games: the side to move's time runs out
+    boost::asio::steady_timer idle_timer;    // no members: the game is abandoned when it fires
+
+    // PLAYER_VS_ENGINE (strand only): the engine is borrowed from the
+    // EnginePool while the game needs it
+    std::shared_ptr<Engine> engine;
+    chess::Color engine_color     = chess::BLACK;
+    bool         engine_requested = false;   // acquire() in flight
+    bool         engine_thinking  = false;   // go() in flight
+};
+
+class GameRegistry {
+public:
+    static constexpr size_t SHARDS = 64;
+
+    explicit GameRegistry(boost::asio::io_context& io) : io_(io) {}
+
+    // Existing game, or a new empty one. The caller must post a join to
+    // game->strand that decrements joining once the session is a member.
+    std::shared_ptr<Game> get_or_create(const std::string& id) {
+        Shard& s = shard(id);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto& slot = s.games[id];
+        if (!slot) {
+            slot = std::make_shared<Game>(id, io_);
+            slot->journal = journal_;
+        }
+        slot->joining++;
+        return slot;
+    }
+
+    // Startup only, before io.run(): a game being replayed from the journal
+    std::shared_ptr<Game> restore(const std::string& id) {
+        Shard& s = shard(id);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto& slot = s.games[id];
+        if (!slot) slot = std::make_shared<Game>(id, io_);
+        return slot;
+    }
+
+    // Startup only; games created afterwards record to journal
+    void set_journal(Journal* journal) { journal_ = journal; }
+
+    // Drop a game nobody is in any more once there is nothing left to
+    // keep: it has finished, or no one took a seat and no move was made.
+    // Anything else waits for its players (or the idle timer). Runs on
+    // game->strand; a join still on its way keeps the game alive. True if
+    // the game was dropped.
+    bool release_if_idle(const std::shared_ptr<Game>& game) {
+        if (!game->members.empty() || !(game->state.game_over || unused(game->state))) return false;
+        Shard& s = shard(game->id);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto it = s.games.find(game->id);
+        if (it == s.games.end() || it->second != game || game->joining != 0) return false;
+        s.games.erase(it);
+        if (game->journal) game->journal->forget(game->id);
+        return true;
+    }
+
+    size_t size() {
+        size_t n = 0;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mtx);
+            n += s.games.size();
+        }
+        return n;
+    }
+
+private:
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::shared_ptr<Game>> games;
+    };
+
+    static bool unused(const GameState& g) {
+        if (g.seq > 0) return false;
+        for (const auto& kv : g.players)
+            if (kv.second.color != PlayerColor::SPECTATOR) return false;
+        return true;
+    }
+
+    Shard& shard(const std::string& id) {
+        return shards_[std::hash<std::string>{}(id) % SHARDS];
+    }
+
+    boost::asio::io_context&  io_;
+    std::array<Shard, SHARDS> shards_;
+    Journal*                  journal_ = nullptr;
+};
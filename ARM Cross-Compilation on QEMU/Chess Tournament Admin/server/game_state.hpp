@@ -1,8 +1,10 @@
 #pragma once
+#include <cstdint>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <map>
-#include <mutex>
+#include "board.hpp"
 
 enum class GameMode { WAITING, PLAYER_VS_PLAYER, PLAYER_VS_ENGINE };
 enum class PlayerColor { WHITE, BLACK, SPECTATOR };
@@ -15,27 +17,55 @@ struct Player {
 };
 
 struct GameState {
-    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    chess::Position board;     // authoritative position; MOVEs are validated against it
+    std::string fen = board.fen();
     std::vector<std::string> move_history;
     std::map<std::string, Player> players;
     GameMode mode = GameMode::WAITING;
     bool white_turn = true;
     bool game_over = false;
     std::string winner = "";
-    std::mutex mtx;
+    uint64_t seq = 0;          // state version: bumped once per applied move
 
-    std::string to_json() {
-        std::string json = "{";
-        json += "\"fen\":\"" + fen + "\",";
-        json += "\"white_turn\":" + std::string(white_turn ? "true" : "false") + ",";
-        json += "\"game_over\":" + std::string(game_over ? "true" : "false") + ",";
-        json += "\"winner\":\"" + winner + "\",";
-        json += "\"moves\":[";
+    // Time control (CLOCK:<base>+<inc>); base_ms == 0 means untimed. The
+    // side to move's clock runs from turn_start, once white has moved,
+    // and not while clock_paused (a game restored from the journal, until
+    // the side to move is back).
+    int64_t base_ms  = 0;
+    int64_t inc_ms   = 0;
+    int64_t white_ms = 0;
+    int64_t black_ms = 0;
+    std::chrono::steady_clock::time_point turn_start;
+    bool clock_paused = false;
+
+    // Full state as JSON, appended to out after reserving room for all of
+    // it plus a trailing newline, so the caller can build a whole message
+    // line in one string.
+    void append_json(std::string& out) const {
+        out.reserve(out.size() + 160 + fen.size() + winner.size() + move_history.size() * 8);
+        out += "{\"seq\":";
+        out += std::to_string(seq);
+        out += ",\"fen\":\"";
+        out += fen;
+        out += "\",\"white_turn\":";
+        out += white_turn ? "true" : "false";
+        out += ",\"game_over\":";
+        out += game_over ? "true" : "false";
+        out += ",\"winner\":\"";
+        out += winner;
+        out += '"';
+        if (base_ms) {
+            out += ",\"white_ms\":" + std::to_string(white_ms);
+            out += ",\"black_ms\":" + std::to_string(black_ms);
+            out += ",\"inc_ms\":"   + std::to_string(inc_ms);
+        }
+        out += ",\"moves\":[";
         for (size_t i = 0; i < move_history.size(); i++) {
-            json += "\"" + move_history[i] + "\"";
-            if (i + 1 < move_history.size()) json += ",";
+            if (i) out += ',';
+            out += '"';
+            out += move_history[i];
+            out += '"';
         }
-        json += "]}";
-        return json;
+        out += "]}";
     }
 };
@@ -0,0 +1,337 @@
+#pragma once
+/**
+ * Append-only game journal, so games survive a server restart (every
+ * QEMU reset is one).
+ *
+ * Every accepted change to a game — seat, mode, clock, move, result — is
+ * one record. Game strands only append the encoded record to an
+ * in-memory batch under a short lock; they never touch the file. The
+ * commit thread wakes on the first record of a batch, lets it fill for
+ * COMMIT_INTERVAL, then copies the whole batch into the memory-mapped
+ * file and syncs it with one msync: a group commit. A crash loses at most
+ * the last interval's records.
+ *
+ * File: an 8-byte magic, then records
+ *
+ *   [size:32][crc32:32][type:8][id length:8][game id][data]
+ *
+ * size counts from type to the end of data; native byte order, the file
+ * never leaves the machine. The file grows in GROW_BYTES steps, so the
+ * mapped tail past the last record is zero. Replay stops at the first
+ * zero size or bad checksum — a torn last batch — and the tail from there
+ * is cleared before new records go in.
+ *
+ * A game the server drops (finished or abandoned) is forget()-ten: its
+ * records so far are dead. The commit thread counts dead bytes, and once
+ * they are half the file it rewrites the file with only the live records,
+ * as compact() does at startup, so the journal does not grow with every
+ * game ever played.
+ */
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+class Journal {
+public:
+    enum class Type : uint8_t {
+        SEAT = 1,   // "white|black <username>"
+        MODE,       // "pvp" or "engine white|black"
+        CLOCK,      // "<base_ms> <inc_ms> <white_ms> <black_ms>"
+        MOVE,       // "<uci>" or "<uci> <white_ms> <black_ms>" when timed
+        END,        // "<winner>"
+    };
+
+    struct Record {
+        Type             type;
+        std::string_view game;
+        std::string_view data;
+    };
+    using Apply = std::function<void(const Record&)>;
+
+    static constexpr std::chrono::milliseconds COMMIT_INTERVAL{10};
+    static constexpr size_t GROW_BYTES  = 4 << 20;    // small steps: the QEMU rootfs is small
+    static constexpr size_t COMPACT_MIN = GROW_BYTES; // no rewrites below this file size
+    static constexpr size_t RECORD_HEAD = 10;   // size, crc, type, id length
+    static constexpr char   MAGIC[8]    = {'C', 'H', 'E', 'S', 'S', 'J', '1', '\n'};
+
+    Journal() = default;
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+    ~Journal() { close(); }
+
+    // Map path (created if missing) and run apply over every intact
+    // record, in order. Call before start(); false if the file is unusable.
+    bool open(const std::string& path, const Apply& apply, size_t& records) {
+        path_ = path;
+        return map_file(false) && scan(apply, records);
+    }
+
+    // Replace the file with just what emit appends — the live games after
+    // a replay — written to a temporary file and renamed over the old one.
+    bool compact(const std::function<void(Journal&)>& emit) {
+        Journal fresh;
+        fresh.path_ = path_ + ".tmp";
+        if (!fresh.map_file(true)) return false;
+        emit(fresh);
+        fresh.commit_pending();
+        fresh.close();
+        if (std::rename(fresh.path_.c_str(), path_.c_str()) != 0) return false;
+        unmap();
+        size_t records = 0;
+        return map_file(false) && scan(nullptr, records);
+    }
+
+    void start() { writer_ = std::thread([this] { run(); }); }
+
+    // Any thread; copies the record into the current batch. Game ids are
+    // at most 64 bytes (JOIN checks).
+    void append(Type type, const std::string& game, const std::string& data) {
+        const size_t id_len = std::min<size_t>(game.size(), 255);
+        const size_t body   = 2 + id_len + data.size();
+        std::lock_guard<std::mutex> lock(mtx_);
+        const bool first = pending_.empty();
+        const size_t at  = pending_.size();
+        pending_.resize(at + 8 + body);
+        char* p = &pending_[at];
+        const uint32_t size = uint32_t(body);
+        p[8] = char(type);
+        p[9] = char(id_len);
+        std::memcpy(p + 10, game.data(), id_len);
+        std::memcpy(p + 10 + id_len, data.data(), data.size());
+        const uint32_t crc = checksum(p + 8, body);
+        std::memcpy(p, &size, 4);
+        std::memcpy(p + 4, &crc, 4);
+        if (first) cv_.notify_one();
+    }
+
+    // Any thread; the game's records appended so far are no longer needed.
+    // Records for a new game with the same id, appended later, are kept.
+    void forget(const std::string& game) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        forgotten_.emplace_back(pending_.size(), game);
+    }
+
+    // Commit what is queued, stop the thread and unmap
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (writer_.joinable()) writer_.join();
+        commit_pending();
+        unmap();
+    }
+
+    size_t bytes() const { return end_; }
+
+private:
+    using Forgotten = std::vector<std::pair<size_t, std::string>>;
+
+    static uint32_t checksum(const char* p, size_t n) {
+        boost::crc_32_type crc;
+        crc.process_bytes(p, n);
+        return crc.checksum();
+    }
+
+    bool map_file(bool truncate) {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (fstat(fd_, &st) != 0) return false;
+        char head[sizeof MAGIC] = {};
+        if (st.st_size > 0 && (pread(fd_, head, sizeof head, 0) != ssize_t(sizeof head)
+                               || std::memcmp(head, MAGIC, sizeof MAGIC) != 0))
+            return false;   // not a journal; leave it alone
+        size_t size = size_t(st.st_size);
+        if (size < GROW_BYTES) {
+            size = GROW_BYTES;
+            if (ftruncate(fd_, off_t(size)) != 0) return false;
+        }
+        void* m = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (m == MAP_FAILED) return false;
+        map_    = static_cast<char*>(m);
+        mapped_ = size;
+        std::memcpy(map_, MAGIC, sizeof MAGIC);
+        end_ = sizeof MAGIC;
+        return true;
+    }
+
+    bool scan(const Apply& apply, size_t& records) {
+        size_t pos = sizeof MAGIC;
+        records = 0;
+        game_bytes_.clear();
+        dead_.clear();
+        dead_bytes_ = 0;
+        while (pos + RECORD_HEAD <= mapped_) {
+            uint32_t size, crc;
+            std::memcpy(&size, map_ + pos, 4);
+            std::memcpy(&crc, map_ + pos + 4, 4);
+            if (size < 2 || pos + 8 + size > mapped_) break;
+            const char* body = map_ + pos + 8;
+            if (checksum(body, size) != crc) break;
+            const size_t id_len = uint8_t(body[1]);
+            if (2 + id_len > size) break;
+            if (apply)
+                apply(Record{Type(body[0]), std::string_view(body + 2, id_len),
+                             std::string_view(body + 2 + id_len, size - 2 - id_len)});
+            game_bytes_[std::string(body + 2, id_len)] += 8 + size;
+            pos += 8 + size;
+            ++records;
+        }
+        end_ = pos;
+        // Whatever follows is a torn batch; later records must not land
+        // in front of a stale one that still checks out
+        if (std::any_of(map_ + end_, map_ + mapped_, [](char c) { return c != 0; })) {
+            std::memset(map_ + end_, 0, mapped_ - end_);
+            msync(map_, mapped_, MS_SYNC);
+        }
+        return true;
+    }
+
+    void run() {
+        std::string batch;
+        Forgotten   forgotten;
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (;;) {
+            cv_.wait(lock, [this] { return stopping_ || !pending_.empty() || !forgotten_.empty(); });
+            if (stopping_) return;   // close() commits the rest
+            cv_.wait_for(lock, COMMIT_INTERVAL, [this] { return stopping_; });
+            batch.swap(pending_);
+            forgotten.swap(forgotten_);
+            lock.unlock();
+            write(batch, forgotten);
+            if (dead_bytes_ * 2 >= end_ && end_ >= COMPACT_MIN) compact_live();
+            batch.clear();
+            forgotten.clear();
+            lock.lock();
+        }
+    }
+
+    void commit_pending() {
+        std::string batch;
+        Forgotten   forgotten;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            batch.swap(pending_);
+            forgotten.swap(forgotten_);
+        }
+        write(batch, forgotten);
+    }
+
+    // Commit thread: the batch's records go to their games' byte counts,
+    // and a forgotten game's count so far becomes dead, in batch order
+    void account(const std::string& batch, size_t at, const Forgotten& forgotten) {
+        size_t pos = 0;
+        auto f = forgotten.begin();
+        for (;;) {
+            for (; f != forgotten.end() && f->first <= pos; ++f) {
+                auto it = game_bytes_.find(f->second);
+                if (it == game_bytes_.end()) continue;   // never journaled
+                dead_bytes_ += it->second;
+                dead_[f->second] = at + pos;
+                game_bytes_.erase(it);
+            }
+            if (pos >= batch.size()) break;
+            uint32_t size;
+            std::memcpy(&size, batch.data() + pos, 4);
+            game_bytes_[batch.substr(pos + 10, uint8_t(batch[pos + 9]))] += 8 + size;
+            pos += 8 + size;
+        }
+    }
+
+    // Commit thread: rewrite the file with only the records still live —
+    // those of games never forgotten, or appended after their forget()
+    void compact_live() {
+        const size_t before = end_;
+        std::string live;
+        live.reserve(end_ - dead_bytes_);
+        for (size_t pos = sizeof MAGIC; pos < end_;) {
+            uint32_t size;
+            std::memcpy(&size, map_ + pos, 4);
+            const char* body = map_ + pos + 8;
+            auto dead = dead_.find(std::string(body + 2, uint8_t(body[1])));
+            if (dead == dead_.end() || pos >= dead->second) live.append(map_ + pos, 8 + size);
+            pos += 8 + size;
+        }
+        if (!compact([&](Journal& out) { out.pending_.swap(live); })) {
+            std::fprintf(stderr, "[!] Journal %s: compaction failed\n", path_.c_str());
+            return;
+        }
+        std::printf("[*] Journal compacted from %zu to %zu bytes\n", before, end_);
+    }
+
+    // Commit thread (or close): copy into the mapping, grow it first if
+    // needed, then one msync for the whole batch
+    void write(const std::string& batch, const Forgotten& forgotten = {}) {
+        if (!map_) return;
+        account(batch, end_, forgotten);
+        if (batch.empty()) return;
+        if (end_ + batch.size() > mapped_ && !grow(end_ + batch.size())) {
+            std::fprintf(stderr, "[!] Journal %s: cannot grow, %zu bytes dropped\n",
+                         path_.c_str(), batch.size());
+            return;
+        }
+        std::memcpy(map_ + end_, batch.data(), batch.size());
+        const size_t page  = size_t(sysconf(_SC_PAGESIZE));
+        const size_t first = end_ / page * page;
+        end_ += batch.size();
+        msync(map_ + first, end_ - first, MS_SYNC);
+    }
+
+    bool grow(size_t need) {
+        size_t size = mapped_;
+        while (size < need) size += GROW_BYTES;
+        if (ftruncate(fd_, off_t(size)) != 0 || fdatasync(fd_) != 0) return false;
+        void* m = mremap(map_, mapped_, size, MREMAP_MAYMOVE);
+        if (m == MAP_FAILED) return false;
+        map_    = static_cast<char*>(m);
+        mapped_ = size;
+        return true;
+    }
+
+    void unmap() {
+        if (map_) {
+            msync(map_, mapped_, MS_SYNC);
+            munmap(map_, mapped_);
+        }
+        if (fd_ >= 0) ::close(fd_);
+        map_ = nullptr;
+        fd_  = -1;
+    }
+
+    std::string path_;
+    int         fd_     = -1;
+    char*       map_    = nullptr;
+    size_t      mapped_ = 0;
+    size_t      end_    = 0;          // next record goes here; writer side only
+
+    // Writer side only: bytes in the file per game, and per forgotten game
+    // the offset its live records start from
+    std::unordered_map<std::string, size_t> game_bytes_;
+    std::unordered_map<std::string, size_t> dead_;
+    size_t      dead_bytes_ = 0;
+
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+    std::string             pending_;   // encoded records not yet in the file
+    Forgotten               forgotten_; // forget()s, at their offset in pending_
+    bool                    stopping_ = false;
+    std::thread             writer_;
+};
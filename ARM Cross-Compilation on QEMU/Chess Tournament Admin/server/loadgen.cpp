@@ -0,0 +1,657 @@
+/**
+ * chess-arm-tournament: load generator and latency benchmark for the game
+ * server.
+ *
+ * Opens two connections per game (white + black), JOINs each pair to its
+ * own room and AUTHs them into the seats. A player moves when the room
+ * broadcast shows the opponent's move, so every game keeps exactly one
+ * move in flight. By default they move as fast as the server answers;
+ * --rate R paces the whole run at R moves/s (each game at R/games, the
+ * openings staggered over one interval), so latency can be read at a
+ * chosen load instead of only at saturation.
+ *
+ * Latency is MOVE sent → the mover receiving its own MOVE broadcast,
+ * i.e. a full round trip through validation and the room fan-out.
+ * --status-every K also sends STATUS after every K-th own move and times
+ * STATUS → STATE, the snapshot path. Both are reported as percentiles and
+ * a histogram.
+ *
+ * Moves: without --script, knight shuffles (g1f3 g8f6 f3g1 f6g8 …), legal
+ * from the start position forever, one endless game per room. With
+ * --script FILE, each line is a game in UCI ("e2e4 e7e5 …", '#' starts a
+ * comment), checked with board.hpp at load. Rooms play the scripts in
+ * turn; when a game ends — mate, or the side to move resigning at the end
+ * of its line — both players JOIN a fresh room and start the next one.
+ * loadgen_games.txt is a ready-made file.
+ *
+ * --spectators N adds N read-only connections to every game, joined once
+ * both players are seated. They only count bytes, so latency then shows
+ * what the server's broadcast fan-out costs per move.
+ *
+ * --pid PID (the server's) adds its CPU time over the run from /proc, as
+ * a share of one core and as µs per move.
+ *
+ * --churn N plays nothing: one connection JOINs N fresh rooms in turn
+ * without taking a seat, then checks with ROOMS that the server dropped
+ * each room it left. Exit status 1 if the room count grew.
+ *
+ * Usage:
+ *   loadgen [--host 127.0.0.1] [--port 5000] [--games 500]
+ *           [--spectators 0] [--seconds 10] [--threads 1]
+ *           [--rate 0] [--status-every 0] [--script FILE] [--pid PID]
+ *   loadgen [--host 127.0.0.1] [--port 5000] --churn N
+ * Start the server with -q so its per-message log is not the bottleneck.
+ */
+
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "board.hpp"
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    std::string host    = "127.0.0.1";
+    std::string port    = "5000";
+    int         games   = 500;
+    int         spectators = 0;   // per game
+    double      seconds = 10;
+    int         threads = 1;
+    double      rate    = 0;      // moves/s over all games; 0 = as fast as answered
+    int         status_every = 0; // STATUS after every K-th own move; 0 = never
+    std::string script;
+    int         pid     = 0;
+    int         churn   = 0;      // rooms to join and leave instead of playing
+};
+
+// One scripted game: its moves, and whether the last one ends it (mate or
+// stalemate), so the server's GAMEOVER is due rather than a resignation
+struct Script {
+    std::vector<std::string> moves;
+    bool                     final = false;
+};
+
+const char* const WHITE_MOVES[] = {"g1f3", "f3g1"};
+const char* const BLACK_MOVES[] = {"g8f6", "f6g8"};
+
+std::atomic<int>  g_ready{0};        // players seated
+std::atomic<bool> g_running{false};  // measuring; no new moves once false
+std::atomic<int>  g_errors{0};
+std::atomic<int>  g_watching{0};     // spectators that have received their first bytes
+std::atomic<uint64_t> g_spectator_bytes{0};
+std::atomic<uint64_t> g_games_done{0};
+
+uint32_t micros_since(Clock::time_point t) {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t).count());
+}
+
+// ── Client ────────────────────────────────────────────────────────────────────
+// Each connection runs on its own strand, so --threads > 1 is safe; the
+// partner (white's black) is only reached through a post.
+class Client : public std::enable_shared_from_this<Client> {
+public:
+    Client(boost::asio::io_context& io, std::string game, bool white, int index,
+           const std::vector<Script>& scripts, const Options& opt)
+        : socket_(boost::asio::make_strand(io)), timer_(socket_.get_executor()),
+          game_(std::move(game)), white_(white), name_(game_ + (white ? "w" : "b")),
+          index_(index), scripts_(scripts), status_every_(opt.status_every) {
+        // Each player moves every other ply of its game
+        if (opt.rate > 0)
+            interval_ = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(2.0 * opt.games / opt.rate));
+    }
+
+    void set_partner(std::shared_ptr<Client> black) { partner_ = std::move(black); }
+
+    void start(const tcp::resolver::results_type& endpoints,
+               std::function<void()> on_seated) {
+        on_seated_ = std::move(on_seated);
+        auto self = shared_from_this();
+        boost::asio::async_connect(socket_, endpoints,
+            [this, self](boost::system::error_code ec, const tcp::endpoint&) {
+                if (ec) { fail("connect: " + ec.message()); return; }
+                socket_.set_option(tcp::no_delay(true));
+                enter_room();
+                send("AUTH:" + name_ + "\n");
+                do_read();
+            });
+    }
+
+    // White opens once both seats are taken, after delay (the stagger)
+    void open(Clock::duration delay) {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this(), delay] {
+            self->next_move_at_ = Clock::now() + delay;
+            self->your_turn();
+        });
+    }
+
+    void finish() {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            self->timer_.cancel();
+            if (self->white_) self->send("RESIGN\n");
+        });
+    }
+
+    void close() {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            boost::system::error_code ignore;
+            self->timer_.cancel();
+            self->socket_.shutdown(tcp::socket::shutdown_both, ignore);
+            self->socket_.close(ignore);
+        });
+    }
+
+    std::vector<uint32_t> latencies_us;   // read after the io threads stop
+    std::vector<uint32_t> status_us;
+    uint64_t              moves = 0;
+
+private:
+    // Round 0 is the room main seated us in; later rounds get a fresh room
+    // each. The server re-seats a known username on JOIN by itself.
+    void enter_room() {
+        room_ = round_ ? game_ + "_" + std::to_string(round_) : game_;
+        in_room_   = false;
+        ply_       = 0;
+        own_moves_ = 0;
+        status_sent_.clear();
+        send("JOIN:" + room_ + "\n");
+    }
+
+    // Black, posted by white once white holds the new room's first seat
+    void follow(unsigned round) {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this(), round] {
+            self->round_ = round;
+            self->enter_room();
+        });
+    }
+
+    const Script* script() const {
+        return scripts_.empty() ? nullptr
+                                : &scripts_[(size_t(index_) + round_) % scripts_.size()];
+    }
+
+    void your_turn() {
+        if (!g_running) return;
+        if (interval_ == Clock::duration::zero() || next_move_at_ <= Clock::now()) {
+            send_move();
+            return;
+        }
+        timer_.expires_at(next_move_at_);
+        timer_.async_wait([self = shared_from_this(), room = room_](boost::system::error_code ec) {
+            if (!ec && self->room_ == room) self->send_move();
+        });
+    }
+
+    void send_move() {
+        if (!g_running) return;
+        std::string move;
+        if (const Script* s = script()) {
+            if (ply_ >= s->moves.size()) {
+                // A final position ends the game by itself; otherwise the
+                // side left to move gives up
+                if (!s->final) send("RESIGN\n");
+                return;
+            }
+            move = s->moves[ply_];
+        } else {
+            move = (white_ ? WHITE_MOVES : BLACK_MOVES)[own_moves_ % 2];
+        }
+        sent_at_      = Clock::now();
+        next_move_at_ = sent_at_ + interval_;
+        ++own_moves_;
+        std::string msg = "MOVE:" + move + "\n";
+        if (status_every_ > 0 && own_moves_ % unsigned(status_every_) == 0) {
+            msg += "STATUS\n";
+            status_sent_.push_back(sent_at_);
+        }
+        send(std::move(msg));
+    }
+
+    void send(std::string msg) {
+        out_.push_back(std::move(msg));
+        if (out_.size() == 1) do_write();
+    }
+
+    void do_write() {
+        auto self = shared_from_this();
+        boost::asio::async_write(socket_, boost::asio::buffer(out_.front()),
+            [this, self](boost::system::error_code ec, std::size_t) {
+                if (ec) { fail("write: " + ec.message()); return; }
+                out_.pop_front();
+                if (!out_.empty()) do_write();
+            });
+    }
+
+    void do_read() {
+        auto self = shared_from_this();
+        boost::asio::async_read_until(socket_, buf_, '\n',
+            [this, self](boost::system::error_code ec, std::size_t n) {
+                if (ec) {
+                    if (g_running) fail("read: " + ec.message());
+                    return;
+                }
+                const char* data = boost::asio::buffer_cast<const char*>(buf_.data());
+                handle_line(std::string(data, n - 1));
+                buf_.consume(n);
+                do_read();
+            });
+    }
+
+    // Everything before GAME:<room> belongs to the previous room. In the
+    // room: MOVE:<user>:<uci> — ours closes a round trip, the opponent's is
+    // our cue; the first STATE answers the JOIN, later ones a STATUS.
+    void handle_line(const std::string& line) {
+        if (line.rfind("GAME:", 0) == 0) {
+            in_room_     = line.compare(5, std::string::npos, room_) == 0;
+            join_state_  = in_room_;
+        } else if (!in_room_) {
+            return;
+        } else if (line.rfind("ASSIGNED:", 0) == 0) {
+            const bool ok = line == (white_ ? "ASSIGNED:white" : "ASSIGNED:black");
+            if (!ok) { fail("seat: " + line); return; }
+            if (round_ == 0) {
+                g_ready++;
+                if (on_seated_) on_seated_();
+            } else if (white_) {
+                partner_->follow(round_);
+            } else {
+                partner_->post_turn();   // black seated: white opens the new game
+            }
+        } else if (line.rfind("MOVE:", 0) == 0) {
+            ++ply_;
+            const bool mine = line.compare(5, name_.size(), name_) == 0
+                           && line.size() > 5 + name_.size() && line[5 + name_.size()] == ':';
+            if (mine) {
+                if (g_running) {
+                    latencies_us.push_back(micros_since(sent_at_));
+                    moves++;
+                }
+            } else {
+                your_turn();
+            }
+        } else if (line.rfind("STATE:", 0) == 0) {
+            if (join_state_) {
+                join_state_ = false;
+            } else if (!status_sent_.empty()) {
+                if (g_running) status_us.push_back(micros_since(status_sent_.front()));
+                status_sent_.pop_front();
+            }
+        } else if (line.rfind("GAMEOVER:", 0) == 0) {
+            // White leads both players into the next room
+            timer_.cancel();
+            if (white_ && g_running) {
+                g_games_done++;
+                ++round_;
+                enter_room();
+            }
+        } else if (line.rfind("ERROR:", 0) == 0 && g_running) {
+            fail(line);   // after the run, moves racing RESIGN are expected
+        }
+    }
+
+    void post_turn() {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            self->your_turn();
+        });
+    }
+
+    void fail(const std::string& what) {
+        if (g_errors++ < 5) std::cerr << "[!] " << name_ << ": " << what << "\n";
+    }
+
+    tcp::socket                socket_;
+    boost::asio::steady_timer  timer_;
+    boost::asio::streambuf     buf_;
+    std::deque<std::string>    out_;
+    std::string                game_;
+    bool                       white_;
+    std::string                name_;
+    int                        index_;
+    const std::vector<Script>& scripts_;
+    int                        status_every_;
+    Clock::duration            interval_{};
+    std::shared_ptr<Client>    partner_;    // white → black and back; the cycle lives for the run
+    std::function<void()>      on_seated_;
+    std::string                room_;
+    unsigned                   round_     = 0;
+    bool                       in_room_   = false;
+    bool                       join_state_ = false;
+    size_t                     ply_       = 0;   // moves seen in this room
+    unsigned                   own_moves_ = 0;
+    Clock::time_point          sent_at_;
+    Clock::time_point          next_move_at_;
+    std::deque<Clock::time_point> status_sent_;
+};
+
+// ── Spectator ─────────────────────────────────────────────────────────────────
+class Spectator : public std::enable_shared_from_this<Spectator> {
+public:
+    Spectator(boost::asio::io_context& io, std::string game)
+        : socket_(boost::asio::make_strand(io)), game_(std::move(game)) {}
+
+    void start(const tcp::resolver::results_type& endpoints) {
+        auto self = shared_from_this();
+        boost::asio::async_connect(socket_, endpoints,
+            [this, self](boost::system::error_code ec, const tcp::endpoint&) {
+                if (ec) { if (g_errors++ < 5) std::cerr << "[!] spectator: " << ec.message() << "\n"; return; }
+                join_ = "JOIN:" + game_ + "\n";
+                boost::asio::async_write(socket_, boost::asio::buffer(join_),
+                    [](boost::system::error_code, std::size_t) {});
+                do_read();
+            });
+    }
+
+    void close() {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            boost::system::error_code ignore;
+            self->socket_.close(ignore);
+        });
+    }
+
+private:
+    void do_read() {
+        auto self = shared_from_this();
+        socket_.async_read_some(boost::asio::buffer(buf_),
+            [this, self](boost::system::error_code ec, std::size_t n) {
+                if (ec) return;
+                if (!seen_) { seen_ = true; g_watching++; }
+                if (g_running) g_spectator_bytes += n;
+                do_read();
+            });
+    }
+
+    tcp::socket          socket_;
+    std::string          game_;
+    std::string          join_;
+    std::array<char, 65536> buf_;
+    bool                 seen_ = false;
+};
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val  = i + 1 < argc;
+        if      (a == "--host"    && has_val) opt.host    = argv[++i];
+        else if (a == "--port"    && has_val) opt.port    = argv[++i];
+        else if (a == "--games"   && has_val) opt.games   = std::atoi(argv[++i]);
+        else if (a == "--spectators" && has_val) opt.spectators = std::atoi(argv[++i]);
+        else if (a == "--seconds" && has_val) opt.seconds = std::atof(argv[++i]);
+        else if (a == "--threads" && has_val) opt.threads = std::atoi(argv[++i]);
+        else if (a == "--rate"    && has_val) opt.rate    = std::atof(argv[++i]);
+        else if (a == "--status-every" && has_val) opt.status_every = std::atoi(argv[++i]);
+        else if (a == "--script"  && has_val) opt.script  = argv[++i];
+        else if (a == "--pid"     && has_val) opt.pid     = std::atoi(argv[++i]);
+        else if (a == "--churn"   && has_val) opt.churn   = std::atoi(argv[++i]);
+        else return false;
+    }
+    return opt.games > 0 && opt.spectators >= 0 && opt.seconds > 0 && opt.threads > 0
+        && opt.rate >= 0 && opt.status_every >= 0 && opt.churn >= 0;
+}
+
+// One game per line; every move is checked, so a typo fails here rather
+// than as a server ERROR halfway through the run
+bool load_scripts(const std::string& path, std::vector<Script>& out) {
+    std::ifstream f(path);
+    if (!f) { std::cerr << "[!] cannot read " << path << "\n"; return false; }
+    std::string line;
+    for (int n = 1; std::getline(f, line); ++n) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+        Script s;
+        chess::Position pos;
+        chess::Move m;
+        for (std::string uci; in >> uci; s.moves.push_back(uci)) {
+            if (!pos.find_move(uci, m)) {
+                std::cerr << "[!] " << path << ":" << n << ": illegal move " << uci << "\n";
+                return false;
+            }
+            pos.make(m);
+        }
+        if (s.moves.empty()) continue;
+        chess::MoveList replies;
+        pos.legal_moves(replies);
+        s.final = replies.size == 0;
+        out.push_back(std::move(s));
+    }
+    if (out.empty()) std::cerr << "[!] no games in " << path << "\n";
+    return !out.empty();
+}
+
+// utime + stime of a process from /proc/<pid>/stat, in seconds; -1 if gone
+double cpu_seconds(int pid) {
+    std::ifstream f("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat;
+    if (!pid || !std::getline(f, stat)) return -1;
+    std::istringstream in(stat.substr(stat.rfind(')') + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && in >> field; ++i) {   // fields 14, 15 of stat(5)
+        if (i == 14) utime = std::stoull(field);
+        if (i == 15) stime = std::stoull(field);
+    }
+    return double(utime + stime) / double(sysconf(_SC_CLK_TCK));
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void print_latency(const char* what, const std::vector<uint32_t>& sorted) {
+    std::printf("[LOAD] %s: p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n", what,
+                percentile(sorted, 50), percentile(sorted, 90), percentile(sorted, 99),
+                percentile(sorted, 99.9), sorted.empty() ? 0u : sorted.back());
+    if (sorted.empty()) return;
+    // Roughly 1-2-5 buckets; the bar is the share of samples
+    static const uint32_t EDGES[] = {100, 200, 500, 1000, 2000, 5000, 10000,
+                                     20000, 50000, 100000, UINT32_MAX};
+    static const char* const LABELS[] = {"< 100 µs", "< 200 µs", "< 500 µs", "< 1 ms",
+                                         "< 2 ms", "< 5 ms", "< 10 ms", "< 20 ms",
+                                         "< 50 ms", "< 100 ms", ">= 100 ms"};
+    auto from = sorted.begin();
+    for (size_t b = 0; b < std::size(EDGES) && from != sorted.end(); ++b) {
+        auto to = std::lower_bound(from, sorted.end(), EDGES[b]);
+        const double share = double(to - from) / double(sorted.size());
+        if (to != from)
+            std::printf("[LOAD]   %-10s %9zu %5.1f%% %s\n", LABELS[b], size_t(to - from),
+                        100 * share, std::string(size_t(share * 40 + 0.5), '#').c_str());
+        from = to;
+    }
+}
+
+// --churn: rooms left with no seat and no move must not pile up on the
+// server. ROOMS after the run may exceed ROOMS before by the one room
+// the connection is still in.
+int run_churn(boost::asio::io_context& io, const tcp::resolver::results_type& endpoints,
+              const std::string& run, int n) {
+    tcp::socket socket(io);
+    boost::asio::connect(socket, endpoints);
+    socket.set_option(tcp::no_delay(true));
+    boost::asio::streambuf buf;
+    std::istream in(&buf);
+    // Replies to earlier JOINs are read and skipped on the way
+    auto rooms = [&] {
+        boost::asio::write(socket, boost::asio::buffer("ROOMS\n", 6));
+        for (std::string line;;) {
+            boost::asio::read_until(socket, buf, '\n');
+            std::getline(in, line);
+            if (line.rfind("ROOMS:", 0) == 0) return std::atol(line.c_str() + 6);
+        }
+    };
+
+    const long before = rooms();
+    const auto t0 = Clock::now();
+    constexpr int BATCH = 256;   // JOINs per write; their replies are read by rooms()
+    for (int i = 0; i < n; i += BATCH) {
+        std::string joins;
+        for (int j = i; j < std::min(n, i + BATCH); ++j)
+            joins += "JOIN:" + run + "churn" + std::to_string(j) + "\n";
+        boost::asio::write(socket, boost::asio::buffer(joins));
+        rooms();
+    }
+    // The last leaves may still be on their game strands
+    long after = rooms();
+    while (after > before + 1 && Clock::now() - t0 < std::chrono::seconds(30)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        after = rooms();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    const bool ok = after <= before + 1;
+    std::printf("[LOAD] churn           : %d rooms joined and left in %.2f s\n", n, elapsed);
+    std::printf("[LOAD] rooms           : %ld before, %ld after: %s\n", before, after,
+                ok ? "ok" : "LEAK");
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+// ── main ──────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::cerr << "usage: " << argv[0] << " [--host H] [--port P] [--games N]"
+                     " [--spectators N] [--seconds S] [--threads T]"
+                     " [--rate MOVES_PER_S] [--status-every K] [--script FILE] [--pid PID]"
+                     " [--churn N]\n";
+        return 2;
+    }
+    std::vector<Script> scripts;
+    if (!opt.script.empty() && !load_scripts(opt.script, scripts)) return 2;
+
+    boost::asio::io_context io;
+    auto work = boost::asio::make_work_guard(io);
+    tcp::resolver resolver(io);
+    const auto endpoints = resolver.resolve(opt.host, opt.port);
+
+    // Room names unique per run, so stale games on the server never collide
+    const std::string run = "lg" + std::to_string(getpid()) + "_";
+    if (opt.churn > 0) {
+        try {
+            return run_churn(io, endpoints, run, opt.churn);
+        } catch (const std::exception& e) {
+            std::cerr << "[!] churn: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    std::vector<std::shared_ptr<Client>> clients;
+    std::vector<std::string> game_ids;
+    clients.reserve(static_cast<size_t>(opt.games) * 2);
+    for (int g = 0; g < opt.games; ++g) {
+        const std::string game = run + std::to_string(g);
+        game_ids.push_back(game);
+        auto white = std::make_shared<Client>(io, game, true, g, scripts, opt);
+        auto black = std::make_shared<Client>(io, game, false, g, scripts, opt);
+        white->set_partner(black);
+        black->set_partner(white);
+        clients.push_back(white);
+        clients.push_back(black);
+        // Black joins only after white holds the first seat
+        white->start(endpoints, [black, &endpoints] { black->start(endpoints, nullptr); });
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < opt.threads; ++i)
+        threads.emplace_back([&io] { io.run(); });
+
+    // Wait for every seat and spectator, then let white open on every board
+    const auto setup0 = Clock::now();
+    auto wait_for = [&](const std::atomic<int>& count, int want, const char* what) {
+        while (count < want && g_errors == 0
+               && Clock::now() - setup0 < std::chrono::seconds(30))
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (count >= want) return true;
+        std::cerr << "[!] only " << count << " of " << want << " " << what << "\n";
+        work.reset();
+        io.stop();
+        for (auto& t : threads) t.join();
+        return false;
+    };
+    if (!wait_for(g_ready, opt.games * 2, "players seated")) return 1;
+
+    std::vector<std::shared_ptr<Spectator>> spectators;
+    for (const auto& game : game_ids) {
+        for (int i = 0; i < opt.spectators; ++i) {
+            spectators.push_back(std::make_shared<Spectator>(io, game));
+            spectators.back()->start(endpoints);
+        }
+    }
+    if (!wait_for(g_watching, static_cast<int>(spectators.size()), "spectators joined")) return 1;
+    const double setup_s = std::chrono::duration<double>(Clock::now() - setup0).count();
+
+    // Paced runs spread the openings over one move interval (1/rate apart)
+    // instead of sending every game's first move at once
+    g_running = true;
+    const double cpu0 = cpu_seconds(opt.pid);
+    const auto t0 = Clock::now();
+    for (size_t i = 0; i < clients.size(); i += 2) {
+        const double delay = opt.rate > 0 ? double(i / 2) / opt.rate : 0;
+        clients[i]->open(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(delay)));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(opt.seconds));
+    g_running = false;
+    const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    const double cpu = cpu_seconds(opt.pid) - cpu0;
+
+    // Resign so the server can drop the rooms, then hang up
+    for (size_t i = 0; i < clients.size(); i += 2) clients[i]->finish();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    for (auto& c : clients) c->close();
+    for (auto& s : spectators) s->close();
+    work.reset();
+    for (auto& t : threads) t.join();
+    for (auto& c : clients) c->set_partner(nullptr);
+
+    std::vector<uint32_t> lat, status;
+    uint64_t moves = 0;
+    for (auto& c : clients) {
+        lat.insert(lat.end(), c->latencies_us.begin(), c->latencies_us.end());
+        status.insert(status.end(), c->status_us.begin(), c->status_us.end());
+        moves += c->moves;
+    }
+    std::sort(lat.begin(), lat.end());
+    std::sort(status.begin(), status.end());
+
+    std::printf("[LOAD] games           : %d (%zu connections, seated in %.2f s)\n",
+                opt.games, clients.size() + spectators.size(), setup_s);
+    if (!scripts.empty())
+        std::printf("[LOAD] scripted games  : %zu in %s, %llu completed\n", scripts.size(),
+                    opt.script.c_str(), static_cast<unsigned long long>(g_games_done.load()));
+    if (!spectators.empty())
+        std::printf("[LOAD] spectators      : %d per game, %.1f MB/s received\n",
+                    opt.spectators, g_spectator_bytes / elapsed / 1e6);
+    std::printf("[LOAD] moves           : %llu in %.1f s = %.0f moves/s",
+                static_cast<unsigned long long>(moves), elapsed, moves / elapsed);
+    if (opt.rate > 0) std::printf(" (target %.0f)", opt.rate);
+    std::printf("\n");
+    print_latency("move → echo µs  ", lat);
+    if (opt.status_every > 0) print_latency("STATUS reply µs ", status);
+    if (opt.pid && cpu >= 0)
+        std::printf("[LOAD] server CPU      : %.2f s = %.0f%% of a core, %.1f µs per move\n",
+                    cpu, 100 * cpu / elapsed, moves ? 1e6 * cpu / double(moves) : 0.0);
+    else if (opt.pid)
+        std::printf("[LOAD] server CPU      : pid %d not readable\n", opt.pid);
+    std::printf("[LOAD] errors          : %d\n", g_errors.load());
+    return g_errors == 0 && moves > 0 ? 0 : 1;
+}
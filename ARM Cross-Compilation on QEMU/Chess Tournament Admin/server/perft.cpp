@@ -0,0 +1,174 @@
+/**
+ * chess-arm-tournament: perft suite and move generator benchmark.
+ *
+ * Default run: counts the legal move tree of the six standard perft
+ * positions (chessprogramming.org "Perft Results") and compares each
+ * depth with the published node count. Any mismatch fails the run, so
+ * this is the check to run after touching board.hpp.
+ *
+ *   perft                 suite at quick depths (~25 M nodes)
+ *   perft --deep          suite at full published depths
+ *   perft --bench         perft throughput from the start position, plus
+ *                         the server's per-MOVE cost: find_move + make +
+ *                         fen + game-end check
+ *   perft --fen F --depth N   node count for one position, split per move
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Case {
+    const char* name;
+    const char* fen;
+    std::vector<uint64_t> nodes;   // nodes[d - 1] = perft(d)
+    int quick;                     // depth for the default run
+};
+
+const std::vector<Case>& suite() {
+    static const std::vector<Case> cases = {
+        {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+         {20, 400, 8902, 197281, 4865609, 119060324}, 5},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         {48, 2039, 97862, 4085603, 193690690}, 4},
+        {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         {14, 191, 2812, 43238, 674624, 11030083}, 6},
+        {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+         {6, 264, 9467, 422333, 15833292}, 4},
+        {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+         {44, 1486, 62379, 2103487, 89941194}, 4},
+        {"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+         {46, 2079, 89890, 3894594, 164075551}, 4},
+    };
+    return cases;
+}
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int run_suite(bool deep) {
+    int failures = 0;
+    uint64_t total = 0;
+    const auto t0 = Clock::now();
+    for (const Case& c : suite()) {
+        chess::Position pos;
+        if (!pos.set_fen(c.fen)) {
+            std::printf("[PERFT] %-10s : bad FEN\n", c.name);
+            ++failures;
+            continue;
+        }
+        const int max_depth = deep ? int(c.nodes.size()) : c.quick;
+        for (int d = 1; d <= max_depth; ++d) {
+            const uint64_t got  = chess::perft(pos, d);
+            const uint64_t want = c.nodes[size_t(d - 1)];
+            total += got;
+            if (got != want) {
+                std::printf("[PERFT] %-10s : depth %d  %llu, expected %llu  FAIL\n", c.name, d,
+                            static_cast<unsigned long long>(got),
+                            static_cast<unsigned long long>(want));
+                ++failures;
+            }
+        }
+        if (!failures) std::printf("[PERFT] %-10s : depth 1-%d ok\n", c.name, max_depth);
+    }
+    const double s = seconds_since(t0);
+    std::printf("[PERFT] %s: %llu nodes in %.2f s (%.1f M nodes/s)\n",
+                failures ? "FAILED" : "all ok", static_cast<unsigned long long>(total), s,
+                total / s / 1e6);
+    return failures ? 1 : 0;
+}
+
+// Per-move split, for tracking a mismatch down against another engine
+int run_divide(const std::string& fen, int depth) {
+    chess::Position pos;
+    if (!pos.set_fen(fen)) {
+        std::fprintf(stderr, "[!] bad FEN\n");
+        return 2;
+    }
+    chess::MoveList list;
+    pos.legal_moves(list);
+    uint64_t total = 0;
+    for (const chess::Move& m : list) {
+        chess::Position next = pos;
+        next.make(m);
+        const uint64_t n = chess::perft(next, depth - 1);
+        std::printf("%s: %llu\n", m.uci().c_str(), static_cast<unsigned long long>(n));
+        total += n;
+    }
+    std::printf("\nNodes: %llu\n", static_cast<unsigned long long>(total));
+    return 0;
+}
+
+int run_bench(int depth) {
+    chess::Position start;
+    const auto t0 = Clock::now();
+    const uint64_t nodes = chess::perft(start, depth);
+    const double s = seconds_since(t0);
+    std::printf("[BENCH] perft(%d) start    : %llu nodes in %.2f s = %.1f M nodes/s\n", depth,
+                static_cast<unsigned long long>(nodes), s, nodes / s / 1e6);
+
+    // What Session::handle_message does per MOVE, over random legal games
+    std::mt19937 rng(1);
+    std::vector<std::string> game;
+    uint64_t moves = 0;
+    double   busy  = 0;
+    for (int g = 0; g < 2000; ++g) {
+        chess::Position pos;
+        game.clear();
+        for (int ply = 0; ply < 200; ++ply) {
+            chess::MoveList list;
+            pos.legal_moves(list);
+            if (!list.size) break;
+            game.push_back(list.moves[rng() % unsigned(list.size)].uci());
+            const std::string& uci = game.back();
+
+            const auto m0 = Clock::now();
+            chess::Move m;
+            if (!pos.find_move(uci, m)) return 1;
+            pos.make(m);
+            const std::string fen = pos.fen();
+            chess::MoveList replies;
+            pos.legal_moves(replies);
+            const bool over = replies.size == 0 && pos.in_check();
+            busy += seconds_since(m0);
+            ++moves;
+            if (fen.empty() || over) break;
+        }
+    }
+    std::printf("[BENCH] server MOVE path  : %.2f us per move (%llu moves from random games)\n",
+                busy / moves * 1e6, static_cast<unsigned long long>(moves));
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool deep = false, bench = false;
+    int depth = 0;
+    std::string fen;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_val = i + 1 < argc;
+        if      (!std::strcmp(argv[i], "--deep"))             deep  = true;
+        else if (!std::strcmp(argv[i], "--bench"))            bench = true;
+        else if (!std::strcmp(argv[i], "--depth") && has_val) depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--fen")   && has_val) fen   = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--deep] [--bench [--depth N]] [--fen FEN --depth N]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    if (!fen.empty()) return run_divide(fen, depth > 0 ? depth : 1);
+    if (bench)        return run_bench(depth > 0 ? depth : 6);
+    return run_suite(deep);
+}
@@ -0,0 +1,469 @@
+/**
+ * chess-arm-tournament: text vs binary protocol benchmark.
+ *
+ * Part 1 (always, no server needed): the server's cost to pick one
+ * inbound MOVE out of the byte stream, three ways —
+ *   streambuf   the old path: read_until '\n' + getline copy + rfind chain
+ *   arena text  memchr for '\n' in the session arena + proto::parse_text
+ *   arena frame 4-byte header in the session arena (protocol.hpp)
+ * plus the bytes each message costs on the wire in either format.
+ *
+ * Part 2 (with --port): plays --games rooms against a running server at a
+ * fixed --rate of moves per second, once over the text protocol and once
+ * with BINARY negotiated, and reports per mode the achieved rate, bytes
+ * per move in each direction, MOVE → echo latency and — given the
+ * server's --pid — server CPU per move.
+ *
+ * Before that, with --port, a check that switching is ordered: one write
+ * carries JOIN, STATUS, BINARY and a framed STATUS, and the replies to
+ * the text commands must all arrive as text ahead of PROTO:binary, with
+ * the framed STATUS answered by a frame. Repeated --check-rounds times;
+ * a failure makes the exit status 1.
+ *
+ * Usage:
+ *   protobench [--port 5000 [--host 127.0.0.1] [--pid PID]]
+ *              [--rate 10000] [--games 100] [--seconds 5] [--check-rounds 200]
+ */
+
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+#include "protocol.hpp"
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    std::string host    = "127.0.0.1";
+    std::string port;                 // empty: parse benchmark only
+    int         pid     = 0;
+    double      rate    = 10000;
+    int         games   = 100;
+    double      seconds = 5;
+    int         check_rounds = 200;
+};
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// ── Part 1: parse cost ────────────────────────────────────────────────────────
+const char* const MOVES[] = {"g1f3", "g8f6", "f3g1", "f6g8", "e2e4", "e7e5", "e7e8q", "b1c3"};
+constexpr int PARSE_ROUNDS = 2000000;
+
+volatile size_t g_sink;   // keeps the parsed results alive
+
+// One message per read, as at 10k moves/s spread over many connections
+double parse_streambuf(const std::vector<std::string>& wire) {
+    boost::asio::streambuf buf;
+    size_t sink = 0;
+    const auto t0 = Clock::now();
+    for (int i = 0; i < PARSE_ROUNDS; ++i) {
+        const std::string& m = wire[size_t(i) % wire.size()];
+        buf.sputn(m.data(), std::streamsize(m.size()));
+        // async_read_until's search, then Session's getline + prefix chain
+        auto data = buf.data();
+        auto begin = boost::asio::buffers_begin(data), end = boost::asio::buffers_end(data);
+        sink += size_t(std::find(begin, end, '\n') - begin);
+        std::istream is(&buf);
+        std::string line;
+        std::getline(is, line);
+        if      (line.rfind("JOIN:", 0) == 0)  sink += 1;
+        else if (line.rfind("AUTH:", 0) == 0)  sink += 2;
+        else if (line.rfind("MOVE:", 0) == 0)  sink += line.substr(5).size();
+        else if (line == "RESIGN")             sink += 4;
+    }
+    g_sink = sink;
+    return seconds_since(t0) / PARSE_ROUNDS * 1e9;
+}
+
+double parse_arena(const std::vector<std::string>& wire, bool binary) {
+    std::array<char, 8192> arena;
+    size_t sink = 0;
+    const auto t0 = Clock::now();
+    for (int i = 0; i < PARSE_ROUNDS; ++i) {
+        const std::string& m = wire[size_t(i) % wire.size()];
+        std::memcpy(arena.data(), m.data(), m.size());   // the read
+        proto::Op op;
+        std::string_view arg;
+        if (binary) {
+            size_t len;
+            proto::get_header(arena.data(), op, len);
+            arg = std::string_view(arena.data() + proto::HEADER_SIZE, len);
+        } else {
+            const char* nl = static_cast<const char*>(std::memchr(arena.data(), '\n', m.size()));
+            op = proto::parse_text(std::string_view(arena.data(), size_t(nl - arena.data())), arg);
+        }
+        sink += size_t(op) + arg.size();
+    }
+    g_sink = sink;
+    return seconds_since(t0) / PARSE_ROUNDS * 1e9;
+}
+
+void run_parse_bench() {
+    std::vector<std::string> text, frames;
+    for (const char* m : MOVES) {
+        text.push_back(std::string("MOVE:") + m + "\n");
+        frames.push_back(proto::frame(proto::Op::MOVE, m));
+    }
+    const double sb = parse_streambuf(text);
+    const double at = parse_arena(text, false);
+    const double ab = parse_arena(frames, true);
+    std::printf("[PARSE] inbound MOVE   : streambuf %.1f ns   arena text %.1f ns   arena frame %.1f ns\n",
+                sb, at, ab);
+
+    // What one move puts on the wire: MOVE up, MOVE + DELTA down per member
+    const std::string up    = "MOVE:e2e4";
+    const std::string move  = "MOVE:player_17:e2e4";
+    const std::string delta = "DELTA:1:e2e4:rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1";
+    const size_t text_down  = move.size() + delta.size() + 2;
+    const size_t frame_down = proto::to_frame(move).size() + proto::to_frame(delta).size();
+    std::printf("[PARSE] bytes per move : text up %zu down %zu/member   binary up %zu down %zu/member\n",
+                up.size() + 1, text_down, proto::to_frame(up).size(), frame_down);
+}
+
+// ── Part 2: live ──────────────────────────────────────────────────────────────
+struct Totals {
+    uint64_t moves = 0, up = 0, down = 0;
+    int      seated = 0, errors = 0;
+    bool     running = false;
+    std::vector<uint32_t> latencies_us;
+};
+
+class Player;
+std::deque<std::shared_ptr<Player>> g_ready_queue;   // whose turn it is, in order
+
+class Player : public std::enable_shared_from_this<Player> {
+public:
+    Player(boost::asio::io_context& io, Totals& t, std::string game, bool white, bool binary)
+        : socket_(io), t_(t), game_(std::move(game)), white_(white), binary_(binary),
+          name_(game_ + (white ? "w" : "b")) {}
+
+    void start(const tcp::resolver::results_type& endpoints, std::function<void()> on_seated) {
+        on_seated_ = std::move(on_seated);
+        auto self = shared_from_this();
+        boost::asio::async_connect(socket_, endpoints,
+            [this, self](boost::system::error_code ec, const tcp::endpoint&) {
+                if (ec) { fail("connect: " + ec.message()); return; }
+                socket_.set_option(tcp::no_delay(true));
+                // Frames may follow BINARY at once; the server switches per message
+                if (binary_) send("BINARY\n" + proto::frame(proto::Op::JOIN, game_)
+                                             + proto::frame(proto::Op::AUTH, name_));
+                else         send("JOIN:" + game_ + "\nAUTH:" + name_ + "\n");
+                do_read();
+            });
+    }
+
+    void send_move() {
+        const char* m = white_ ? (ply_++ % 2 ? "f3g1" : "g1f3") : (ply_++ % 2 ? "f6g8" : "g8f6");
+        sent_at_ = Clock::now();
+        send(binary_ ? proto::frame(proto::Op::MOVE, m) : std::string("MOVE:") + m + "\n");
+    }
+
+    void finish() {
+        if (white_) send(binary_ ? proto::frame(proto::Op::RESIGN, "") : std::string("RESIGN\n"));
+    }
+
+    void close() {
+        boost::system::error_code ignore;
+        socket_.close(ignore);
+    }
+
+private:
+    void send(std::string data) {
+        if (t_.running) t_.up += data.size();
+        out_.push_back(std::move(data));
+        if (out_.size() == 1) do_write();
+    }
+
+    void do_write() {
+        auto self = shared_from_this();
+        boost::asio::async_write(socket_, boost::asio::buffer(out_.front()),
+            [this, self](boost::system::error_code ec, std::size_t) {
+                if (ec) { fail("write: " + ec.message()); return; }
+                out_.pop_front();
+                if (!out_.empty()) do_write();
+            });
+    }
+
+    void do_read() {
+        auto self = shared_from_this();
+        socket_.async_read_some(boost::asio::buffer(in_.data() + in_len_, in_.size() - in_len_),
+            [this, self](boost::system::error_code ec, std::size_t n) {
+                if (ec) return;
+                if (t_.running) t_.down += n;
+                in_len_ += n;
+                size_t pos = 0;
+                for (;;) {
+                    const char* p = in_.data() + pos;
+                    const size_t avail = in_len_ - pos;
+                    proto::Op op;
+                    std::string_view arg;
+                    if (framed_) {
+                        size_t len;
+                        if (avail < proto::HEADER_SIZE) break;
+                        proto::get_header(p, op, len);
+                        if (avail < proto::HEADER_SIZE + len) break;
+                        arg = std::string_view(p + proto::HEADER_SIZE, len);
+                        pos += proto::HEADER_SIZE + len;
+                    } else {
+                        const char* nl = static_cast<const char*>(std::memchr(p, '\n', avail));
+                        if (!nl) break;
+                        op = proto::parse_text(std::string_view(p, size_t(nl - p)), arg);
+                        pos += size_t(nl - p) + 1;
+                        if (op == proto::Op::PROTO && arg == "binary") framed_ = true;
+                    }
+                    handle(op, arg);
+                }
+                std::memmove(in_.data(), in_.data() + pos, in_len_ - pos);
+                in_len_ -= pos;
+                if (in_len_ == in_.size()) { fail("message too long"); return; }
+                do_read();
+            });
+    }
+
+    void handle(proto::Op op, std::string_view arg) {
+        if (op == proto::Op::ASSIGNED) {
+            if (arg != (white_ ? "white" : "black")) { fail("seat: " + std::string(arg)); return; }
+            t_.seated++;
+            if (on_seated_) on_seated_();
+        } else if (op == proto::Op::MOVE) {
+            // <user>:<uci> — ours closes a round trip, the opponent's is our cue
+            const bool mine = arg.size() > name_.size() && arg.compare(0, name_.size(), name_) == 0
+                           && arg[name_.size()] == ':';
+            if (mine) {
+                if (t_.running) {
+                    t_.latencies_us.push_back(uint32_t(std::chrono::duration_cast<
+                        std::chrono::microseconds>(Clock::now() - sent_at_).count()));
+                    t_.moves++;
+                }
+            } else {
+                g_ready_queue.push_back(shared_from_this());
+            }
+        } else if (op == proto::Op::ERROR && t_.running) {
+            fail(std::string(arg));
+        }
+    }
+
+    void fail(const std::string& what) {
+        if (t_.errors++ < 5) std::cerr << "[!] " << name_ << ": " << what << "\n";
+    }
+
+    tcp::socket             socket_;
+    Totals&                 t_;
+    std::string             game_;
+    bool                    white_;
+    bool                    binary_;    // asked for frames
+    bool                    framed_ = false;   // reading frames (after PROTO:binary)
+    std::string             name_;
+    std::function<void()>   on_seated_;
+    std::array<char, 65536> in_;
+    size_t                  in_len_ = 0;
+    std::deque<std::string> out_;
+    unsigned                ply_ = 0;
+    Clock::time_point       sent_at_;
+};
+
+// utime + stime of pid in seconds, or -1
+double cpu_seconds(int pid) {
+    std::ifstream f("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat;
+    if (!pid || !std::getline(f, stat)) return -1;
+    std::istringstream in(stat.substr(stat.rfind(')') + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && in >> field; ++i) {   // fields 14, 15 of stat(5)
+        if (i == 14) utime = std::stoull(field);
+        if (i == 15) stime = std::stoull(field);
+    }
+    return double(utime + stime) / double(sysconf(_SC_CLK_TCK));
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+bool run_live(const Options& opt, bool binary) {
+    boost::asio::io_context io;
+    tcp::resolver resolver(io);
+    const auto endpoints = resolver.resolve(opt.host, opt.port);
+    Totals t;
+    g_ready_queue.clear();
+
+    const std::string run = "pb" + std::to_string(getpid()) + (binary ? "b_" : "t_");
+    std::vector<std::shared_ptr<Player>> players;
+    for (int g = 0; g < opt.games; ++g) {
+        auto white = std::make_shared<Player>(io, t, run + std::to_string(g), true, binary);
+        auto black = std::make_shared<Player>(io, t, run + std::to_string(g), false, binary);
+        players.push_back(white);
+        players.push_back(black);
+        white->start(endpoints, [black, &endpoints] { black->start(endpoints, nullptr); });
+    }
+    const auto setup0 = Clock::now();
+    while (t.seated < opt.games * 2 && !t.errors && seconds_since(setup0) < 30)
+        io.run_for(std::chrono::milliseconds(10));
+    if (t.seated < opt.games * 2) {
+        std::cerr << "[!] only " << t.seated << " of " << opt.games * 2 << " players seated\n";
+        return false;
+    }
+
+    // Every white to move; a 1 ms tick releases rate/1000 moves from the queue
+    for (size_t i = 0; i < players.size(); i += 2) g_ready_queue.push_back(players[i]);
+    t.running = true;
+    const double cpu0 = cpu_seconds(opt.pid);
+    const auto t0 = Clock::now();
+    auto last = t0;
+    double credit = 0;
+    while (seconds_since(t0) < opt.seconds) {
+        io.run_for(std::chrono::microseconds(500));
+        const auto now = Clock::now();
+        credit = std::min(credit + opt.rate * std::chrono::duration<double>(now - last).count(),
+                          opt.rate / 100);   // no catch-up burst beyond 10 ms worth
+        last = now;
+        while (credit >= 1 && !g_ready_queue.empty()) {
+            g_ready_queue.front()->send_move();
+            g_ready_queue.pop_front();
+            credit -= 1;
+        }
+    }
+    t.running = false;
+    const double elapsed = seconds_since(t0);
+    const double cpu = cpu_seconds(opt.pid) - cpu0;
+
+    for (size_t i = 0; i < players.size(); i += 2) players[i]->finish();
+    io.run_for(std::chrono::milliseconds(200));
+    for (auto& p : players) p->close();
+    io.run_for(std::chrono::milliseconds(50));
+
+    std::sort(t.latencies_us.begin(), t.latencies_us.end());
+    const double moves = double(std::max<uint64_t>(t.moves, 1));
+    std::printf("[LIVE] %-6s : %6.0f moves/s  up %5.1f B/move  down %6.1f B/move  "
+                "p50 %u us  p99 %u us",
+                binary ? "binary" : "text", t.moves / elapsed, t.up / moves, t.down / moves,
+                percentile(t.latencies_us, 50), percentile(t.latencies_us, 99));
+    if (cpu >= 0) std::printf("  server %.1f us CPU/move", cpu / moves * 1e6);
+    std::printf("  errors %d\n", t.errors);
+    return t.errors == 0 && t.moves > 0;
+}
+
+// ── Switch order ──────────────────────────────────────────────────────────────
+// Each round is a fresh connection. Once the initial STATE (room main) is
+// in, everything else goes in one write, so the server reads BINARY in
+// the same arena pass as the commands before it. The replies must be
+//   GAME STATE STATE PROTO [STATE]
+// (text, then one frame), whatever order the strands happen to run in.
+bool check_switch_order(const Options& opt) {
+    boost::asio::io_context io;
+    tcp::resolver resolver(io);
+    const auto endpoints = resolver.resolve(opt.host, opt.port);
+    const std::string room = "pb" + std::to_string(getpid()) + "_switch";
+    const std::string burst = "JOIN:" + room + "\nSTATUS\nBINARY\n" + proto::frame(proto::Op::STATUS, "");
+    const std::string want  = "GAME STATE STATE PROTO [STATE]";
+    int bad = 0;
+    std::string first_bad;
+    for (int r = 0; r < opt.check_rounds; ++r) {
+        tcp::socket socket(io);
+        boost::system::error_code ec;
+        boost::asio::connect(socket, endpoints, ec);
+        if (ec) { std::cerr << "[!] switch check: connect: " << ec.message() << "\n"; return false; }
+        socket.set_option(tcp::no_delay(true));
+        timeval tv{2, 0};   // a missing reply fails the round instead of hanging it
+        setsockopt(socket.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+
+        std::string in, seen;
+        std::array<char, 4096> buf;
+        size_t pos = 0;
+        bool framed = false, sent = false, done = false;
+        while (!done) {
+            const size_t n = socket.read_some(boost::asio::buffer(buf), ec);
+            if (ec) break;
+            in.append(buf.data(), n);
+            for (;;) {
+                proto::Op op;
+                std::string_view arg;
+                if (!framed) {
+                    const size_t nl = in.find('\n', pos);
+                    if (nl == std::string::npos) break;
+                    op = proto::parse_text(std::string_view(in).substr(pos, nl - pos), arg);
+                    pos = nl + 1;
+                    if (!sent) {   // room main's STATE; now the burst
+                        boost::asio::write(socket, boost::asio::buffer(burst), ec);
+                        sent = true;
+                        continue;
+                    }
+                    seen += (seen.empty() ? "" : " ") + std::string(op == proto::Op::NONE ? "?" : proto::name(op));
+                    framed = op == proto::Op::PROTO;
+                } else {
+                    size_t len;
+                    if (in.size() - pos < proto::HEADER_SIZE) break;
+                    proto::get_header(in.data() + pos, op, len);
+                    if (in.size() - pos < proto::HEADER_SIZE + len) break;
+                    pos += proto::HEADER_SIZE + len;
+                    seen += " [" + std::string(proto::name(op)) + "]";
+                    done = true;
+                    break;
+                }
+            }
+        }
+        if (seen != want && bad++ == 0) first_bad = seen.empty() ? "(nothing)" : seen;
+    }
+    if (bad) std::printf("[CHECK] STATUS + BINARY in one write: %d of %d rounds out of order,"
+                         " e.g. %s (want %s)\n", bad, opt.check_rounds, first_bad.c_str(), want.c_str());
+    else     std::printf("[CHECK] STATUS + BINARY in one write: %d rounds in order\n", opt.check_rounds);
+    return bad == 0;
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val  = i + 1 < argc;
+        if      (a == "--host"    && has_val) opt.host    = argv[++i];
+        else if (a == "--port"    && has_val) opt.port    = argv[++i];
+        else if (a == "--pid"     && has_val) opt.pid     = std::atoi(argv[++i]);
+        else if (a == "--rate"    && has_val) opt.rate    = std::atof(argv[++i]);
+        else if (a == "--games"   && has_val) opt.games   = std::atoi(argv[++i]);
+        else if (a == "--seconds" && has_val) opt.seconds = std::atof(argv[++i]);
+        else if (a == "--check-rounds" && has_val) opt.check_rounds = std::atoi(argv[++i]);
+        else return false;
+    }
+    return opt.rate > 0 && opt.games > 0 && opt.seconds > 0 && opt.check_rounds >= 0;
+}
+
+} // namespace
+
+// ── main ──────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::cerr << "usage: " << argv[0] << " [--port P [--host H] [--pid PID]]"
+                     " [--rate MOVES_PER_S] [--games N] [--seconds S] [--check-rounds N]\n";
+        return 2;
+    }
+    run_parse_bench();
+    if (opt.port.empty()) return 0;
+
+    bool ok = check_switch_order(opt);
+    std::printf("[LIVE] %d games, target %.0f moves/s, %.0f s per mode\n",
+                opt.games, opt.rate, opt.seconds);
+    ok = run_live(opt, false) && ok;
+    ok = run_live(opt, true) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#pragma once
+/**
+ * Wire formats shared by the server and the benchmark clients.
+ *
+ * Text (default): one message per line, "NAME" or "NAME:<arg>" + '\n'.
+ *
+ * Binary: a connection that sends the text line BINARY gets PROTO:binary
+ * back as the last text line; after that, both directions carry frames
+ *
+ *   [ opcode:8 | payload length:24 ]  big-endian, 4 bytes
+ *   payload                           the text form's <arg>, no newline
+ *
+ * so a reader needs one 4-byte load to know what a message is and where
+ * it ends — no scan for '\n', no prefix compares. Opcodes are the same in
+ * both directions; a name means the same message as in text.
+ */
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace proto {
+
+enum class Op : uint8_t {
+    NONE,
+    // client → server
+    JOIN, AUTH, MOVE, RESIGN, STATUS, MODE, CLOCK, BINARY,
+    // server → client (MOVE, RESIGN, MODE and CLOCK go both ways)
+    GAME, ASSIGNED, JOINED, STATE, DELTA, GAMEOVER, LEFT, ERROR, PROTO,
+    // both ways; appended so earlier opcodes keep their values
+    ROOMS,
+    COUNT
+};
+
+constexpr std::string_view NAMES[size_t(Op::COUNT)] = {
+    "",
+    "JOIN", "AUTH", "MOVE", "RESIGN", "STATUS", "MODE", "CLOCK", "BINARY",
+    "GAME", "ASSIGNED", "JOINED", "STATE", "DELTA", "GAMEOVER", "LEFT", "ERROR", "PROTO",
+    "ROOMS",
+};
+
+constexpr size_t   HEADER_SIZE = 4;
+constexpr uint32_t MAX_PAYLOAD = (1u << 24) - 1;
+
+inline std::string_view name(Op op) {
+    return op < Op::COUNT ? NAMES[size_t(op)] : std::string_view();
+}
+
+// "NAME" or "NAME:<arg>" → op and arg; Op::NONE if NAME is unknown
+inline Op parse_text(std::string_view line, std::string_view& arg) {
+    const size_t colon = line.find(':');
+    const std::string_view head = line.substr(0, colon);
+    arg = colon == std::string_view::npos ? std::string_view() : line.substr(colon + 1);
+    for (size_t i = 1; i < size_t(Op::COUNT); ++i)
+        if (NAMES[i] == head) return Op(i);
+    return Op::NONE;
+}
+
+inline void put_header(char* p, Op op, size_t len) {
+    const uint32_t h = uint32_t(op) << 24 | uint32_t(len);
+    p[0] = char(h >> 24); p[1] = char(h >> 16); p[2] = char(h >> 8); p[3] = char(h);
+}
+
+inline void get_header(const char* p, Op& op, size_t& len) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    op  = Op(u[0]);
+    len = size_t(u[1]) << 16 | size_t(u[2]) << 8 | u[3];
+}
+
+// payload.size() <= MAX_PAYLOAD; the server never queues anything near it
+inline std::string frame(Op op, std::string_view payload) {
+    std::string out(HEADER_SIZE + payload.size(), '\0');
+    put_header(&out[0], op, payload.size());
+    std::memcpy(&out[HEADER_SIZE], payload.data(), payload.size());
+    return out;
+}
+
+// A text message, trailing newline optional, as the equivalent frame.
+// Every message the server builds has a known NAME.
+inline std::string to_frame(std::string_view line) {
+    if (!line.empty() && line.back() == '\n') line.remove_suffix(1);
+    std::string_view arg;
+    const Op op = parse_text(line, arg);
+    return frame(op, arg);
+}
+
+} // namespace proto
@@ -2,42 +2,133 @@
  * chess-arm-tournament: Boost.Asio TCP Game Server
  * Runs on QEMU ARM (cross-compiled) or natively on x86.
  *
+ * Every connection is in one game room at a time, "main" until it sends
+ * JOIN. Moves, state and broadcasts are per room, so one server hosts a
+ * whole tournament's boards (see game_registry.hpp). A room nobody is in
+ * is dropped at once if no seat was taken and no move made; otherwise it
+ * ends as abandoned after --idle-timeout (30 min) without members.
+ *
+ * Threading: io.run() on a pool. Nothing is locked per message — each
+ * game's state is only touched on that game's strand, and each session's
+ * socket, read buffer and write queue only on the session's own strand
+ * (the executor its socket was accepted on). A session hands a command
+ * to its game by posting to the game strand; the game answers by posting
+ * to member strands through deliver(). No handler waits on another.
+ *
+ * Output: each session queues immutable shared buffers and keeps exactly
+ * one async_write in flight, gathering everything queued since the last
+ * one into a single writev — a MOVE + STATE broadcast pair leaves in one
+ * syscall. Broadcasts are serialised once and the same buffer is queued
+ * for every member, so fan-out copies no bytes. A client that stops
+ * reading is disconnected once its queue passes MAX_QUEUED_BYTES instead
+ * of growing the server without bound.
+ *
+ * Input: each session reads into a fixed arena and handles every complete
+ * message in it where it lies — a line found with memchr, or in binary
+ * mode a frame whose 4-byte header gives opcode and length (protocol.hpp).
+ * Either way the command reaches handle_message as an opcode and a view
+ * of its argument; nothing is copied until a game needs to keep it.
+ *
+ * State sync: STATE (the full JSON, move list included) goes to a session
+ * when it joins a game and when it sends STATUS. After that each move is
+ * broadcast as DELTA:<seq>:<uci>:<fen>, whose size does not grow with the
+ * game. seq counts moves; a client that sees it skip sends STATUS and
+ * resyncs from the snapshot. The snapshot is cached per game and only
+ * rebuilt after the state has changed.
+ *
+ * Engine games: with --engine PATH the server keeps a pool of UCI engine
+ * processes (engine_pool.hpp). MODE:engine seats an engine in the free
+ * colour; when it is the engine's turn the game borrows an engine, sends
+ * it the position and the clocks, and plays its bestmove through the same
+ * path as a human MOVE. The search never blocks a pool thread.
+ *
+ * Persistence: with --journal PATH every seat, mode, clock, move and
+ * result is appended to a journal (journal.hpp) that a background thread
+ * commits in batches. At startup the journal is replayed and unfinished
+ * games come back as they were; a restored seat goes back to the same
+ * username on AUTH. AUTH proves nothing, so that is whichever connection
+ * first claims the name. Once dropped games make up half of the journal
+ * it is rewritten with only the live ones, while the server runs.
+ *
  * Protocol (newline-terminated):
  *   CLIENT → SERVER:
- *     AUTH:<lichess_username>   register player
- *     MOVE:<uci>                e.g. MOVE:e2e4
- *     RESIGN                    forfeit game
- *     STATUS                    request full game state
- *     MODE:pvp|engine           set game mode
+ *     JOIN:<game_id>            switch to game room (created on demand)
+ *     AUTH:<lichess_username>   register player, take a seat in the room
+ *     MOVE:<uci>                e.g. MOVE:e2e4, e7e8q; must be legal
+ *     RESIGN                    forfeit your own colour; seated players only
+ *     STATUS                    request full game state (also: resync after a gap)
+ *     MODE:pvp|engine           set game mode; engine takes the free seat
+ *     CLOCK:<base_s>+<inc_s>    time control, before the first move (e.g. CLOCK:180+2)
+ *     BINARY                    switch this connection to framed messages
+ *     ROOMS                     number of games the server holds
  *
  *   SERVER → CLIENT:
+ *     GAME:<game_id>
  *     ASSIGNED:white|black|spectator
  *     JOINED:<username>
  *     MOVE:<username>:<uci>
- *     STATE:<json>
+ *     STATE:<json>                full snapshot, includes "seq"
+ *     DELTA:<seq>:<uci>:<fen>     one applied move
  *     RESIGN:<username>
- *     GAMEOVER:<winner>
+ *     MODE:pvp|engine
+ *     CLOCK:<base_s>+<inc_s>
+ *     PROTO:binary                last text line before frames, both ways
+ *     ROOMS:<n>
+ *     GAMEOVER:white|black|draw  resign, checkmate, stalemate or flag fall
  *     LEFT:<username>
  *     ERROR:<reason>
  */
 
 #include <boost/asio.hpp>
+#include <array>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <set>
 #include <thread>
 #include <sstream>
-#include "game_state.hpp"
+#include <unordered_map>
+#include <vector>
+#include "engine_pool.hpp"
+#include "game_registry.hpp"
+#include "protocol.hpp"
 
 using boost::asio::ip::tcp;
 
+// One outbound message, newline included; shared, never modified once queued
+using OutBuffer = std::shared_ptr<const std::string>;
+
+static OutBuffer make_buffer(std::string msg) {
+    msg += '\n';
+    return std::make_shared<const std::string>(std::move(msg));
+}
+
+// The same message for a binary-mode session
+static OutBuffer make_frame(const std::string& text) {
+    return std::make_shared<const std::string>(proto::to_frame(text));
+}
+
 class Session;
 class Server;
 
-// ── Global game state ─────────────────────────────────────────────────────────
-GameState g_game;
+static const std::string DEFAULT_GAME = "main";
+static constexpr size_t  MAX_QUEUED_BYTES = 1 << 20;   // per session, then disconnect
+static constexpr size_t  READ_ARENA       = 8192;      // per session; a longer message disconnects
+static bool g_verbose = true;   // per-message log; -q turns it off for load tests
+static std::chrono::seconds g_idle_timeout{1800};   // --idle-timeout; 0 keeps abandoned games
+
+static const std::string ENGINE_SEAT   = "engine";     // players key of the engine's seat
+static const std::string RESTORED_SEAT = "restored:";  // + username: seat replayed from the journal
+static constexpr std::chrono::milliseconds ENGINE_MOVETIME{500};    // untimed games
+static constexpr std::chrono::milliseconds ENGINE_GRACE{5000};      // then the engine is stuck
 
 // ── Session ───────────────────────────────────────────────────────────────────
+// Members without a note run on the session strand. Those marked "game
+// strand" run on game.strand and must not touch the session's mutable
+// fields, so the username they need is passed in.
 class Session : public std::enable_shared_from_this<Session> {
 public:
     Session(tcp::socket socket, Server& server)
@@ -45,177 +136,831 @@ public:
 
     void start() {
         session_id_ = generate_id();
-        std::cout << "[+] Client connected: " << session_id_ << "\n";
+        if (g_verbose) std::cout << "[+] Client connected: " << session_id_ << "\n";
+        join_game(DEFAULT_GAME, false);
         do_read();
     }
 
-    void deliver(const std::string& msg) {
-        boost::asio::async_write(
-            socket_, boost::asio::buffer(msg + "\n"),
-            [](boost::system::error_code, std::size_t){});
+    // Thread-safe: queues msg on the session strand. A binary-mode session
+    // sends frame instead, or frames text itself if none was built.
+    void deliver(std::string msg) { deliver(make_buffer(std::move(msg))); }
+
+    void deliver(OutBuffer text, OutBuffer frame = nullptr) {
+        boost::asio::post(socket_.get_executor(),
+            [self = shared_from_this(), text = std::move(text), frame = std::move(frame)]() mutable {
+                self->enqueue(std::move(text), std::move(frame));
+            });
     }
 
     const std::string& id() const { return session_id_; }
+    bool binary() const { return binary_; }   // any thread; only ever turns on
+    tcp::socket::executor_type executor() { return socket_.get_executor(); }   // session strand
 
 private:
     void do_read() {
         auto self = shared_from_this();
-        boost::asio::async_read_until(socket_, buf_, '\n',
-            [this, self](boost::system::error_code ec, std::size_t) {
-                if (!ec) {
-                    std::istream is(&buf_);
-                    std::string line;
-                    std::getline(is, line);
-                    if (!line.empty() && line.back() == '\r') line.pop_back();
-                    handle_message(line);
-                    do_read();
-                } else {
-                    std::cout << "[-] Client disconnected: " << session_id_ << "\n";
+        socket_.async_read_some(boost::asio::buffer(in_.data() + in_len_, in_.size() - in_len_),
+            [this, self](boost::system::error_code ec, std::size_t n) {
+                if (ec) {
+                    if (g_verbose) std::cout << "[-] Client disconnected: " << session_id_ << "\n";
                     on_disconnect();
+                    return;
+                }
+                in_len_ += n;
+                const size_t used = parse_input();
+                std::memmove(in_.data(), in_.data() + used, in_len_ - used);
+                in_len_ -= used;
+                if (in_len_ == in_.size()) {
+                    std::cout << "[!] " << session_id_ << ": message over "
+                              << READ_ARENA << " bytes, disconnecting\n";
+                    close();
                 }
+                do_read();   // after close() this fails and runs on_disconnect
             });
     }
 
-    void handle_message(const std::string& msg);
+    // Handles every complete message in the arena and returns the bytes
+    // used. The views handed on point into in_ and die with this call.
+    size_t parse_input() {
+        size_t pos = 0;
+        while (!closed_) {
+            const char*  p     = in_.data() + pos;
+            const size_t avail = in_len_ - pos;
+            if (binary_in_) {
+                proto::Op op;
+                size_t    len;
+                if (avail < proto::HEADER_SIZE) break;
+                proto::get_header(p, op, len);
+                if (avail < proto::HEADER_SIZE + len) break;
+                pos += proto::HEADER_SIZE + len;
+                handle_message(op, std::string_view(p + proto::HEADER_SIZE, len));
+            } else {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', avail));
+                if (!nl) break;
+                std::string_view line(p, size_t(nl - p));
+                pos += line.size() + 1;
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                std::string_view arg;
+                const proto::Op op = proto::parse_text(line, arg);
+                if (op == proto::Op::NONE) {
+                    if (g_verbose) std::cout << "[" << session_id_ << "] " << line << "\n";
+                    deliver("ERROR:unknown command: " + std::string(line));
+                    continue;
+                }
+                handle_message(op, arg);
+            }
+        }
+        return pos;
+    }
+
+    void enqueue(OutBuffer text, OutBuffer frame = nullptr) {
+        if (closed_) return;
+        OutBuffer buf = !binary_ ? std::move(text) : frame ? std::move(frame) : make_frame(*text);
+        queued_bytes_ += buf->size();
+        out_.push_back(std::move(buf));
+        if (queued_bytes_ > MAX_QUEUED_BYTES) {
+            std::cout << "[!] Slow consumer " << session_id_ << ": "
+                      << queued_bytes_ << " bytes queued, disconnecting\n";
+            close();
+            return;
+        }
+        // Start on a later turn of the strand, so messages posted in the
+        // same burst (MOVE then STATE) join this write
+        if (!writing_ && !flush_posted_) {
+            flush_posted_ = true;
+            boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+                self->flush_posted_ = false;
+                self->do_write();
+            });
+        }
+    }
+
+    // One async_write at a time, carrying everything queued so far
+    void do_write() {
+        if (closed_ || writing_ || out_.empty()) return;
+        gather_.clear();
+        for (const auto& b : out_) gather_.push_back(boost::asio::buffer(*b));
+        in_flight_ = out_.size();
+        writing_   = true;
+        auto self = shared_from_this();
+        boost::asio::async_write(socket_, gather_,
+            [this, self](boost::system::error_code ec, std::size_t n) {
+                writing_ = false;
+                if (ec) { close(); return; }
+                queued_bytes_ -= n;
+                out_.erase(out_.begin(), out_.begin() + static_cast<std::ptrdiff_t>(in_flight_));
+                do_write();
+            });
+    }
+
+    // The pending read fails too and runs on_disconnect
+    void close() {
+        closed_ = true;
+        out_.clear();
+        queued_bytes_ = 0;
+        boost::system::error_code ignore;
+        socket_.close(ignore);
+    }
+
+    void handle_message(proto::Op op, std::string_view arg);
     void on_disconnect();
+    void join_game(const std::string& game_id, bool announce);
+    void leave_game();
+    void take_seat(Game& game, const std::string& username);   // game strand
 
     static std::string generate_id() {
         static std::atomic<int> counter{0};
         return "player_" + std::to_string(++counter);
     }
 
-    tcp::socket           socket_;
-    boost::asio::streambuf buf_;
-    Server&               server_;
-    std::string           session_id_;
-    std::string           username_;
+    tcp::socket             socket_;
+    std::array<char, READ_ARENA> in_;      // unparsed input, in_len_ bytes from the start
+    size_t                  in_len_       = 0;
+    std::deque<OutBuffer>   out_;            // queued writes, first in_flight_ being sent
+    std::vector<boost::asio::const_buffer> gather_;
+    size_t                  in_flight_    = 0;
+    size_t                  queued_bytes_ = 0;
+    bool                    writing_      = false;
+    bool                    flush_posted_ = false;
+    bool                    closed_       = false;
+    bool                    binary_in_    = false;   // reading frames
+    std::atomic<bool>       binary_{false};   // writing frames; session strand writes it
+    Server&                 server_;
+    std::string             session_id_;   // fixed once start() has run
+    std::string             username_;
+    std::shared_ptr<Game>   game_;         // room this session is in
 };
 
+// Send to every member of a game. Game strand. The message is built once;
+// every member's queue holds a reference to the same bytes.
+static void broadcast(Game& game, std::string msg) {
+    const OutBuffer buf = make_buffer(std::move(msg));
+    OutBuffer frame;   // built once, if any member reads frames
+    for (auto& s : game.members) {
+        if (!frame && s->binary()) frame = make_frame(*buf);
+        s->deliver(buf, frame);
+    }
+}
+
+// Full STATE message, rebuilt only after the game has changed. Game strand.
+static OutBuffer snapshot(Game& game) {
+    if (!game.snapshot) {
+        std::string line = "STATE:";
+        game.state.append_json(line);
+        line += '\n';
+        game.snapshot = std::make_shared<const std::string>(std::move(line));
+    }
+    return game.snapshot;
+}
+
 // ── Server ────────────────────────────────────────────────────────────────────
 class Server {
 public:
     Server(boost::asio::io_context& io, short port)
-        : acceptor_(io, tcp::endpoint(tcp::v4(), port)) {
+        : io_(io), acceptor_(io, tcp::endpoint(tcp::v4(), port)), games_(io), engines_(io) {
         std::cout << "[*] Chess Tournament Server on port " << port << "\n";
         do_accept();
     }
 
-    void broadcast(const std::string& msg, const std::string& exclude_id = "") {
-        std::lock_guard<std::mutex> lock(sessions_mtx_);
-        for (auto& s : sessions_)
-            if (s->id() != exclude_id)
-                s->deliver(msg);
-    }
-
-    void add_session(std::shared_ptr<Session> s) {
-        std::lock_guard<std::mutex> lock(sessions_mtx_);
-        sessions_.insert(s);
-    }
-
-    void remove_session(std::shared_ptr<Session> s) {
-        std::lock_guard<std::mutex> lock(sessions_mtx_);
-        sessions_.erase(s);
-    }
-
-    size_t player_count() {
-        std::lock_guard<std::mutex> lock(sessions_mtx_);
-        return sessions_.size();
-    }
+    GameRegistry& games()   { return games_; }
+    EnginePool&   engines() { return engines_; }
 
 private:
     void do_accept() {
-        acceptor_.async_accept(
+        // Each socket gets its own strand as its executor
+        acceptor_.async_accept(boost::asio::make_strand(io_),
             [this](boost::system::error_code ec, tcp::socket socket) {
                 if (!ec) {
+                    // Replies are small and often back to back (MOVE, DELTA,
+                    // STATE); without this the second waits on a delayed ACK
+                    boost::system::error_code ignore;
+                    socket.set_option(tcp::no_delay(true), ignore);
                     auto session = std::make_shared<Session>(std::move(socket), *this);
-                    add_session(session);
-                    session->start();
-                    // Send current state to new joiner
-                    {
-                        std::lock_guard<std::mutex> lock(g_game.mtx);
-                        session->deliver("STATE:" + g_game.to_json());
-                    }
+                    // start() joins the default game and sends its state
+                    boost::asio::dispatch(session->executor(), [session] { session->start(); });
                 }
                 do_accept();
             });
     }
 
-    tcp::acceptor                            acceptor_;
-    std::set<std::shared_ptr<Session>>       sessions_;
-    std::mutex                               sessions_mtx_;
+    boost::asio::io_context& io_;
+    tcp::acceptor            acceptor_;
+    GameRegistry             games_;
+    EnginePool               engines_;
 };
 
+// ── Moves and engine games ────────────────────────────────────────────────────
+// Everything here runs on the game strand.
+
+static bool seat_taken(const GameState& g, PlayerColor color) {
+    for (const auto& kv : g.players)
+        if (kv.second.color == color) return true;
+    return false;
+}
+
+static int64_t elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+// Hand the engine back to the pool. One still thinking is returned by its
+// bestmove handler, which sees the game no longer wants it.
+static void release_engine(Game& game, EnginePool& pool) {
+    if (!game.engine || game.engine_thinking) return;
+    pool.release(std::move(game.engine));
+    game.engine.reset();
+}
+
+static void record(Game& game, Journal::Type type, const std::string& data) {
+    if (game.journal) game.journal->append(type, game.id, data);
+}
+
+static void end_game(Game& game, EnginePool& pool, const std::string& winner) {
+    record(game, Journal::Type::END, winner);
+    game.state.game_over = true;
+    game.state.winner    = winner;
+    game.snapshot.reset();
+    broadcast(game, "GAMEOVER:" + winner);
+    game.flag_timer.cancel();
+    release_engine(game, pool);
+}
+
+// Time the side to move has used this turn: none before white's first
+// move or while the clock is paused.
+static int64_t turn_ms(const GameState& g) {
+    return g.seq == 0 || g.clock_paused ? 0 : elapsed_ms(g.turn_start);
+}
+
+static void arm_flag(Game& game, EnginePool& pool);
+
+// Start a paused clock from now: the side to move is back
+static void resume_clock(Game& game, EnginePool& pool) {
+    GameState& g = game.state;
+    if (!g.clock_paused) return;
+    g.clock_paused = false;
+    g.turn_start   = std::chrono::steady_clock::now();
+    arm_flag(game, pool);
+}
+
+// Timed games: the side to move loses when their time runs out, whether
+// or not they ever send another move. Armed at every turn start; a wait
+// that was cancelled or belongs to an earlier turn does nothing.
+static void arm_flag(Game& game, EnginePool& pool) {
+    const GameState& g = game.state;
+    if (!g.base_ms || g.seq == 0 || g.game_over || g.clock_paused) {
+        game.flag_timer.cancel();
+        return;
+    }
+    const int64_t left = (g.white_turn ? g.white_ms : g.black_ms) - turn_ms(g);
+    game.flag_timer.expires_after(std::chrono::milliseconds(std::max<int64_t>(left, 0)));
+    game.flag_timer.async_wait(
+        [self = game.shared_from_this(), &pool, seq = g.seq](boost::system::error_code ec) {
+            GameState& g = self->state;
+            if (ec || g.game_over || g.seq != seq) return;
+            int64_t& left = g.white_turn ? g.white_ms : g.black_ms;
+            if (left - turn_ms(g) > 0) { arm_flag(*self, pool); return; }
+            left = 0;
+            end_game(*self, pool, g.white_turn ? "black" : "white");
+        });
+}
+
+// The side to move plays uci, for a human MOVE and an engine's bestmove
+// alike: clocks, board, broadcasts, mate and stalemate. False with error
+// set if the move was not played — illegal, or the mover's flag fell
+// (the game is then over).
+static bool play_move(Game& game, EnginePool& pool, const std::string& user,
+                      const std::string& uci, std::string& error) {
+    GameState& g = game.state;
+    chess::Move m;
+    if (!g.board.find_move(uci, m)) { error = "illegal move: " + uci; return false; }
+
+    // Clocks run from white's first move; the increment follows each move
+    if (g.base_ms) {
+        int64_t& left = g.white_turn ? g.white_ms : g.black_ms;
+        left -= turn_ms(g);
+        if (left <= 0) {
+            left  = 0;
+            error = "time forfeit";
+            end_game(game, pool, g.white_turn ? "black" : "white");
+            return false;
+        }
+        if (g.seq > 0) left += g.inc_ms;
+        g.turn_start   = std::chrono::steady_clock::now();
+        g.clock_paused = false;
+    }
+
+    g.board.make(m);
+    g.fen        = g.board.fen();
+    g.white_turn = g.board.side_to_move() == chess::WHITE;
+    g.move_history.push_back(m.uci());
+    g.seq++;
+    game.snapshot.reset();
+    record(game, Journal::Type::MOVE, !g.base_ms ? g.move_history.back()
+        : g.move_history.back() + " " + std::to_string(g.white_ms) + " " + std::to_string(g.black_ms));
+    broadcast(game, "MOVE:" + user + ":" + g.move_history.back());
+    broadcast(game, "DELTA:" + std::to_string(g.seq) + ":" + g.move_history.back() + ":" + g.fen);
+
+    // No reply: mate (the side to move loses) or stalemate
+    chess::MoveList replies;
+    g.board.legal_moves(replies);
+    if (replies.size == 0)
+        end_game(game, pool, !g.board.in_check() ? "draw" : g.white_turn ? "black" : "white");
+    arm_flag(game, pool);
+    return true;
+}
+
+static bool engine_to_move(const Game& game) {
+    const GameState& g = game.state;
+    return !g.game_over && g.mode == GameMode::PLAYER_VS_ENGINE && !game.members.empty()
+        && g.board.side_to_move() == game.engine_color;
+}
+
+// If it is the engine's turn: borrow an engine if the game has none, then
+// send it the position and clocks. Both steps complete asynchronously and
+// come back to the game strand, where the state is checked again.
+static void maybe_engine_move(Game& game, EnginePool& pool) {
+    if (!engine_to_move(game) || game.engine_thinking || game.engine_requested) return;
+    auto self = game.shared_from_this();
+
+    if (!game.engine) {
+        game.engine_requested = true;
+        pool.acquire([self, &pool](std::shared_ptr<Engine> e) {
+            boost::asio::post(self->strand, [self, &pool, e] {
+                self->engine_requested = false;
+                if (!e) {   // every engine failed; the next turn or join asks again
+                    broadcast(*self, "ERROR:no engine available");
+                    return;
+                }
+                self->engine = e;
+                if (engine_to_move(*self)) maybe_engine_move(*self, pool);
+                else                       release_engine(*self, pool);
+            });
+        });
+        return;
+    }
+
+    resume_clock(game, pool);   // the engine is always back
+    const GameState& g = game.state;
+    std::string cmd = "position startpos";
+    if (!g.move_history.empty()) {
+        cmd += " moves";
+        for (const auto& m : g.move_history) { cmd += ' '; cmd += m; }
+    }
+    std::chrono::milliseconds budget = ENGINE_MOVETIME;
+    if (g.base_ms) {
+        int64_t white = g.white_ms, black = g.black_ms;
+        (g.white_turn ? white : black) -= turn_ms(g);
+        cmd += "\ngo wtime " + std::to_string(std::max<int64_t>(white, 0))
+             + " btime "     + std::to_string(std::max<int64_t>(black, 0))
+             + " winc "      + std::to_string(g.inc_ms)
+             + " binc "      + std::to_string(g.inc_ms) + "\n";
+        budget = std::chrono::milliseconds(std::max<int64_t>(g.white_turn ? white : black, 0));
+    } else {
+        cmd += "\ngo movetime " + std::to_string(ENGINE_MOVETIME.count()) + "\n";
+    }
+
+    game.engine_thinking = true;
+    const uint64_t seq = g.seq;
+    game.engine->go(std::move(cmd), budget + ENGINE_GRACE,
+        [self, &pool, seq](bool ok, const std::string& uci) {
+            boost::asio::post(self->strand, [self, &pool, seq, ok, uci] {
+                Game& game = *self;
+                game.engine_thinking = false;
+                if (!ok) {
+                    // Lost or stuck: the pool replaces it, the game borrows another
+                    pool.release(std::move(game.engine));
+                    game.engine.reset();
+                    maybe_engine_move(game, pool);
+                    return;
+                }
+                // Game over, switched to pvp, emptied or taken back meanwhile
+                if (!engine_to_move(game) || game.state.seq != seq) {
+                    release_engine(game, pool);
+                    maybe_engine_move(game, pool);
+                    return;
+                }
+                const std::string name = game.engine->name();
+                std::string error;
+                if (!play_move(game, pool, name, uci, error) && !game.state.game_over) {
+                    std::cout << "[!] Engine " << game.engine->id() << " in game " << game.id
+                              << ": " << error << ", forfeits\n";
+                    end_game(game, pool, game.engine_color == chess::WHITE ? "black" : "white");
+                }
+            });
+        });
+}
+
+// MODE:engine seats the engine in the free colour; MODE:pvp frees the seat
+static void set_mode(Session& s, Game& game, EnginePool& pool, const std::string& mode) {
+    GameState& g = game.state;
+    if (mode == "engine") {
+        if (!pool.configured()) { s.deliver("ERROR:no engine configured"); return; }
+        if (!pool.enabled())    { s.deliver("ERROR:no engine available"); return; }
+        if (g.mode != GameMode::PLAYER_VS_ENGINE) {
+            PlayerColor free;
+            if (!seat_taken(g, PlayerColor::BLACK))      free = PlayerColor::BLACK;
+            else if (!seat_taken(g, PlayerColor::WHITE)) free = PlayerColor::WHITE;
+            else { s.deliver("ERROR:both seats are taken"); return; }
+            Player p;
+            p.session_id       = ENGINE_SEAT;
+            p.lichess_username = ENGINE_SEAT;
+            p.color            = free;
+            g.players[ENGINE_SEAT] = p;
+            game.engine_color = free == PlayerColor::WHITE ? chess::WHITE : chess::BLACK;
+            g.mode = GameMode::PLAYER_VS_ENGINE;
+            record(game, Journal::Type::MODE,
+                   free == PlayerColor::WHITE ? "engine white" : "engine black");
+        }
+        broadcast(game, "MODE:engine");
+        maybe_engine_move(game, pool);
+    } else if (mode == "pvp") {
+        if (g.mode != GameMode::PLAYER_VS_PLAYER) record(game, Journal::Type::MODE, "pvp");
+        g.players.erase(ENGINE_SEAT);
+        g.mode = GameMode::PLAYER_VS_PLAYER;
+        release_engine(game, pool);
+        broadcast(game, "MODE:pvp");
+    } else {
+        s.deliver("ERROR:unknown mode: " + mode);
+    }
+}
+
+// CLOCK:<base_s>+<inc_s>, only before the first move; base 0 turns it off
+static void set_clock(Session& s, Game& game, const std::string& spec) {
+    GameState& g = game.state;
+    if (g.seq > 0) { s.deliver("ERROR:clock is set before the first move"); return; }
+    const size_t plus = spec.find('+');
+    int64_t base = -1, inc = -1;
+    try {
+        size_t end = 0;
+        base = std::stoll(spec.substr(0, plus), &end);
+        if (end != plus) base = -1;
+        inc = plus == std::string::npos ? 0 : std::stoll(spec.substr(plus + 1), &end);
+        if (plus != std::string::npos && plus + 1 + end != spec.size()) inc = -1;
+    } catch (const std::exception&) {}
+    if (base < 0 || inc < 0 || base > 24 * 3600 || inc > 3600) {
+        s.deliver("ERROR:bad clock: " + spec);
+        return;
+    }
+    g.base_ms  = base * 1000;
+    g.inc_ms   = inc * 1000;
+    g.white_ms = g.black_ms = g.base_ms;
+    game.snapshot.reset();
+    record(game, Journal::Type::CLOCK, std::to_string(g.base_ms) + " " + std::to_string(g.inc_ms)
+        + " " + std::to_string(g.white_ms) + " " + std::to_string(g.black_ms));
+    broadcast(game, "CLOCK:" + std::to_string(base) + "+" + std::to_string(inc));
+}
+
+// ── Game rooms ────────────────────────────────────────────────────────────────
+// A game left with no members but still holding seats or moves: unless
+// someone joins within the idle timeout it ends as abandoned and is
+// dropped. Game strand.
+static void arm_idle(Game& game, GameRegistry& games, EnginePool& pool) {
+    if (g_idle_timeout.count() == 0) return;
+    game.idle_timer.expires_after(g_idle_timeout);
+    game.idle_timer.async_wait(
+        [self = game.shared_from_this(), &games, &pool](boost::system::error_code ec) {
+            // Cancelled by a join, re-armed by a later leave, or a join on its way
+            if (ec || !self->members.empty() || self->joining != 0
+                || self->idle_timer.expiry() > std::chrono::steady_clock::now()) return;
+            if (!self->state.game_over) end_game(*self, pool, "abandoned");
+            games.release_if_idle(self);
+        });
+}
+
+void Session::join_game(const std::string& game_id, bool announce) {
+    leave_game();
+    game_ = server_.games().get_or_create(game_id);
+    boost::asio::post(game_->strand,
+        [self = shared_from_this(), game = game_, user = username_, announce] {
+            game->members.insert(self);
+            game->joining--;
+            game->idle_timer.cancel();
+            if (announce) self->deliver("GAME:" + game->id);
+            if (!user.empty()) self->take_seat(*game, user);
+            self->deliver(snapshot(*game));
+            maybe_engine_move(*game, self->server_.engines());   // engine let go while empty
+        });
+}
+
+void Session::leave_game() {
+    if (!game_) return;
+    std::shared_ptr<Game> game = std::move(game_);
+    boost::asio::post(game->strand,
+        [self = shared_from_this(), game, user = username_] {
+            game->members.erase(self);
+            if (!user.empty()) broadcast(*game, "LEFT:" + user);
+            EnginePool& pool = self->server_.engines();
+            if (game->members.empty()) release_engine(*game, pool);
+            if (!self->server_.games().release_if_idle(game) && game->members.empty())
+                arm_idle(*game, self->server_.games(), pool);
+        });
+}
+
+// Seats go white, black, then spectator, in AUTH order per game (an
+// engine may already hold either colour); a repeated AUTH keeps the
+// seat, and a seat restored from the journal waits for its username.
+// Game strand.
+void Session::take_seat(Game& game, const std::string& username) {
+    auto& players = game.state.players;
+    auto it = players.find(session_id_);
+    auto restored = players.find(RESTORED_SEAT + username);
+    if (it == players.end() && restored != players.end()) {
+        Player p = restored->second;
+        p.session_id = session_id_;
+        players.erase(restored);
+        it = players.emplace(session_id_, p).first;
+    } else if (it == players.end()) {
+        Player p;
+        p.session_id       = session_id_;
+        p.lichess_username = username;
+        if (!seat_taken(game.state, PlayerColor::WHITE))      p.color = PlayerColor::WHITE;
+        else if (!seat_taken(game.state, PlayerColor::BLACK)) p.color = PlayerColor::BLACK;
+        else                                                   p.color = PlayerColor::SPECTATOR;
+        it = players.emplace(session_id_, p).first;
+        if (p.color != PlayerColor::SPECTATOR)
+            record(game, Journal::Type::SEAT,
+                   (p.color == PlayerColor::WHITE ? "white " : "black ") + username);
+    } else {
+        it->second.lichess_username = username;
+    }
+    switch (it->second.color) {
+    case PlayerColor::WHITE: deliver("ASSIGNED:white");     break;
+    case PlayerColor::BLACK: deliver("ASSIGNED:black");     break;
+    default:                 deliver("ASSIGNED:spectator"); break;
+    }
+    broadcast(game, "JOINED:" + username);
+    if (it->second.color == (game.state.white_turn ? PlayerColor::WHITE : PlayerColor::BLACK))
+        resume_clock(game, server_.engines());
+}
+
 // ── Message handler ───────────────────────────────────────────────────────────
-void Session::handle_message(const std::string& raw) {
-    std::cout << "[" << session_id_ << "] " << raw << "\n";
+// Parses on the session strand; anything touching the game is posted to
+// the game strand with the session and username captured.
+void Session::handle_message(proto::Op op, std::string_view arg) {
+    using proto::Op;
+    if (g_verbose)
+        std::cout << "[" << session_id_ << "] " << proto::name(op) << (arg.empty() ? "" : ":") << arg << "\n";
+
+    auto on_game = [this](auto fn) {
+        boost::asio::post(game_->strand,
+            [self = shared_from_this(), game = game_, user = username_, fn = std::move(fn)] {
+                fn(*self, *game, user);
+            });
+    };
 
-    if (raw.rfind("AUTH:", 0) == 0) {
-        username_ = raw.substr(5);
-        std::lock_guard<std::mutex> lock(g_game.mtx);
+    switch (op) {
+    case Op::JOIN:
+        if (arg.empty() || arg.size() > 64) { deliver("ERROR:bad game id"); return; }
+        join_game(std::string(arg), true);
+        break;
+
+    case Op::BINARY:
+        // Input is framed from the next message on, including anything
+        // already in the arena. Output switches only once the game strand
+        // has run every earlier command, so their replies still go out as
+        // text ahead of PROTO:binary, the last text line.
+        if (!binary_in_) {
+            binary_in_ = true;
+            on_game([](Session& s, Game&, const std::string&) {
+                boost::asio::post(s.executor(), [self = s.shared_from_this()] {
+                    self->enqueue(make_buffer("PROTO:binary"));
+                    self->binary_ = true;
+                });
+            });
+        }
+        break;
+
+    case Op::AUTH:
+        username_ = std::string(arg);
+        on_game([](Session& s, Game& game, const std::string& user) {
+            s.take_seat(game, user);
+        });
+        break;
+
+    case Op::MOVE:
+        on_game([move = std::string(arg)](Session& s, Game& game, const std::string& user) {
+            GameState& g = game.state;
+            if (g.game_over) { s.deliver("ERROR:game is over"); return; }
+            auto it = g.players.find(s.session_id_);
+            if (it == g.players.end()) { s.deliver("ERROR:not authenticated"); return; }
+            if (it->second.color == PlayerColor::SPECTATOR) { s.deliver("ERROR:spectators cannot move"); return; }
+            bool is_white = (it->second.color == PlayerColor::WHITE);
+            if (is_white != g.white_turn) { s.deliver("ERROR:not your turn"); return; }
+            EnginePool& pool = s.server_.engines();
+            std::string error;
+            if (!play_move(game, pool, user, move, error)) { s.deliver("ERROR:" + error); return; }
+            maybe_engine_move(game, pool);
+        });
+        break;
+
+    case Op::RESIGN:
+        on_game([](Session& s, Game& game, const std::string& user) {
+            GameState& g = game.state;
+            if (g.game_over) { s.deliver("ERROR:game is over"); return; }
+            // Only a seated player resigns, and always their own colour
+            auto it = g.players.find(s.session_id_);
+            if (it == g.players.end()) { s.deliver("ERROR:not authenticated"); return; }
+            if (it->second.color == PlayerColor::SPECTATOR) { s.deliver("ERROR:spectators cannot resign"); return; }
+            const bool white = it->second.color == PlayerColor::WHITE;
+            broadcast(game, "RESIGN:" + user);
+            end_game(game, s.server_.engines(), white ? "black" : "white");
+        });
+        break;
+
+    case Op::ROOMS:
+        deliver("ROOMS:" + std::to_string(server_.games().size()));
+        break;
+
+    case Op::STATUS:
+        on_game([](Session& s, Game& game, const std::string&) {
+            s.deliver(snapshot(game));
+        });
+        break;
+
+    case Op::MODE:
+        on_game([mode = std::string(arg)](Session& s, Game& game, const std::string&) {
+            set_mode(s, game, s.server_.engines(), mode);
+        });
+        break;
+
+    case Op::CLOCK:
+        on_game([spec = std::string(arg)](Session& s, Game& game, const std::string&) {
+            set_clock(s, game, spec);
+        });
+        break;
+
+    default:   // server → client opcodes, or unknown in a frame
+        deliver("ERROR:unknown command: " + (proto::name(op).empty()
+                    ? "opcode " + std::to_string(int(op)) : std::string(proto::name(op))));
+        break;
+    }
+}
+
+void Session::on_disconnect() {
+    leave_game();
+}
+
+// ── Journal replay ────────────────────────────────────────────────────────────
+// Startup only, single-threaded, before the pool runs.
+
+static int64_t to_ms(std::string_view s) {
+    return std::strtoll(std::string(s).c_str(), nullptr, 10);
+}
+
+// One journal record onto a game's state. The board and move list are
+// rebuilt here; fen and turn are derived once the whole journal is in.
+static bool apply_record(Game& game, Journal::Type type, std::string_view data) {
+    GameState& g = game.state;
+    const size_t sp = data.find(' ');
+    const std::string_view head = data.substr(0, sp);
+    const std::string_view rest = sp == std::string_view::npos ? std::string_view() : data.substr(sp + 1);
+    switch (type) {
+    case Journal::Type::MOVE: {
+        chess::Move m;
+        if (!g.board.find_move(std::string(head), m)) return false;
+        g.board.make(m);
+        g.move_history.push_back(m.uci());
+        g.seq++;
+        if (!rest.empty()) {
+            const size_t sp2 = rest.find(' ');
+            g.white_ms = to_ms(rest.substr(0, sp2));
+            g.black_ms = to_ms(rest.substr(sp2 + 1));
+        }
+        return true;
+    }
+    case Journal::Type::SEAT: {
+        if (rest.empty()) return false;
         Player p;
-        p.session_id        = session_id_;
-        p.lichess_username  = username_;
-        if (g_game.players.empty()) {
-            p.color = PlayerColor::WHITE;
-            deliver("ASSIGNED:white");
-        } else if (g_game.players.size() == 1) {
-            p.color = PlayerColor::BLACK;
-            deliver("ASSIGNED:black");
+        p.lichess_username = std::string(rest);
+        p.session_id       = RESTORED_SEAT + p.lichess_username;
+        p.color            = head == "white" ? PlayerColor::WHITE : PlayerColor::BLACK;
+        g.players[p.session_id] = p;
+        return true;
+    }
+    case Journal::Type::MODE:
+        if (head == "pvp") {
+            g.players.erase(ENGINE_SEAT);
+            g.mode = GameMode::PLAYER_VS_PLAYER;
         } else {
-            p.color = PlayerColor::SPECTATOR;
-            deliver("ASSIGNED:spectator");
+            Player p;
+            p.session_id = p.lichess_username = ENGINE_SEAT;
+            p.color = rest == "white" ? PlayerColor::WHITE : PlayerColor::BLACK;
+            g.players[ENGINE_SEAT] = p;
+            game.engine_color = rest == "white" ? chess::WHITE : chess::BLACK;
+            g.mode = GameMode::PLAYER_VS_ENGINE;
         }
-        g_game.players[session_id_] = p;
-        server_.broadcast("JOINED:" + username_);
-
-    } else if (raw.rfind("MOVE:", 0) == 0) {
-        std::string move = raw.substr(5);
-        std::lock_guard<std::mutex> lock(g_game.mtx);
-        if (g_game.game_over) { deliver("ERROR:game is over"); return; }
-        auto it = g_game.players.find(session_id_);
-        if (it == g_game.players.end()) { deliver("ERROR:not authenticated"); return; }
-        bool is_white = (it->second.color == PlayerColor::WHITE);
-        if (is_white != g_game.white_turn) { deliver("ERROR:not your turn"); return; }
-        g_game.move_history.push_back(move);
-        g_game.white_turn = !g_game.white_turn;
-        server_.broadcast("MOVE:" + username_ + ":" + move);
-        server_.broadcast("STATE:" + g_game.to_json());
-
-    } else if (raw == "RESIGN") {
-        std::lock_guard<std::mutex> lock(g_game.mtx);
-        g_game.game_over = true;
-        g_game.winner    = (g_game.white_turn ? "black" : "white");
-        server_.broadcast("RESIGN:" + username_);
-        server_.broadcast("GAMEOVER:" + g_game.winner);
-
-    } else if (raw == "STATUS") {
-        std::lock_guard<std::mutex> lock(g_game.mtx);
-        deliver("STATE:" + g_game.to_json());
-
-    } else if (raw.rfind("MODE:", 0) == 0) {
-        std::string mode = raw.substr(5);
-        std::lock_guard<std::mutex> lock(g_game.mtx);
-        if (mode == "pvp")         g_game.mode = GameMode::PLAYER_VS_PLAYER;
-        else if (mode == "engine") g_game.mode = GameMode::PLAYER_VS_ENGINE;
-        server_.broadcast("MODE:" + mode);
+        return true;
+    case Journal::Type::CLOCK: {
+        std::istringstream in{std::string(data)};
+        return bool(in >> g.base_ms >> g.inc_ms >> g.white_ms >> g.black_ms);
+    }
+    case Journal::Type::END:
+        g.game_over = true;
+        g.winner    = std::string(head);
+        return true;
+    }
+    return false;
+}
 
-    } else {
-        deliver("ERROR:unknown command: " + raw);
+// A live game as the shortest record sequence that rebuilds it
+static void emit_game(Journal& out, const Game& game) {
+    const GameState& g = game.state;
+    if (g.base_ms)
+        out.append(Journal::Type::CLOCK, game.id, std::to_string(g.base_ms) + " " + std::to_string(g.inc_ms)
+                   + " " + std::to_string(g.white_ms) + " " + std::to_string(g.black_ms));
+    for (const auto& kv : g.players) {
+        const Player& p = kv.second;
+        if (p.color == PlayerColor::SPECTATOR || kv.first == ENGINE_SEAT) continue;
+        out.append(Journal::Type::SEAT, game.id,
+                   (p.color == PlayerColor::WHITE ? "white " : "black ") + p.lichess_username);
     }
+    if (g.mode == GameMode::PLAYER_VS_ENGINE)
+        out.append(Journal::Type::MODE, game.id,
+                   game.engine_color == chess::WHITE ? "engine white" : "engine black");
+    for (const auto& uci : g.move_history) out.append(Journal::Type::MOVE, game.id, uci);
 }
 
-void Session::on_disconnect() {
-    server_.remove_session(shared_from_this());
-    if (!username_.empty())
-        server_.broadcast("LEFT:" + username_);
+// Replay path into the registry, drop finished games and, if there were
+// any, compact the journal to the live ones. Then new changes go to it.
+// Restored clocks stay paused until the side to move takes their seat
+// back, or the engine is asked for its move. Games nobody rejoins are
+// abandoned after the idle timeout, as if everyone had just left.
+static void restore_games(Journal& journal, const std::string& path, GameRegistry& games,
+                          EnginePool& pool) {
+    const auto t0 = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, std::shared_ptr<Game>> restored;
+    size_t records = 0, rejected = 0;
+    const bool ok = journal.open(path, [&](const Journal::Record& r) {
+        auto& game = restored[std::string(r.game)];
+        if (!game) game = games.restore(std::string(r.game));
+        if (!apply_record(*game, r.type, r.data)) rejected++;
+    }, records);
+    if (!ok) throw std::runtime_error("cannot open journal " + path);
+
+    std::vector<std::shared_ptr<Game>> live;
+    for (auto& kv : restored) {
+        GameState& g = kv.second->state;
+        if (g.game_over) {
+            games.release_if_idle(kv.second);
+            continue;
+        }
+        g.fen        = g.board.fen();
+        g.white_turn = g.board.side_to_move() == chess::WHITE;
+        g.clock_paused = true;   // downtime and reconnecting are not charged
+        kv.second->journal = &journal;
+        arm_idle(*kv.second, games, pool);
+        live.push_back(kv.second);
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "[*] Journal " << path << ": " << records << " records, " << live.size()
+              << " games restored, " << restored.size() - live.size() << " finished dropped in "
+              << static_cast<int>(ms) << " ms\n";
+    if (rejected) std::cout << "[!] Journal: " << rejected << " records did not apply\n";
+
+    if (live.size() < restored.size() || rejected) {
+        if (!journal.compact([&](Journal& out) { for (auto& game : live) emit_game(out, *game); }))
+            throw std::runtime_error("cannot compact journal " + path);
+        std::cout << "[*] Journal compacted to " << journal.bytes() << " bytes\n";
+    }
+    games.set_journal(&journal);
+    journal.start();
 }
 
 // ── main ──────────────────────────────────────────────────────────────────────
+// Usage: chess_server [port] [-q] [--engine PATH [--engines N]] [--journal PATH]
+//                     [--idle-timeout S]
 int main(int argc, char* argv[]) {
     try {
-        short port = (argc > 1) ? static_cast<short>(std::stoi(argv[1])) : 5000;
+        short port = 5000;
+        std::string engine_path, journal_path;
+        int engines = 2;
+        for (int i = 1; i < argc; ++i) {
+            const bool has_val = i + 1 < argc;
+            if (std::strcmp(argv[i], "-q") == 0) g_verbose = false;
+            else if (std::strcmp(argv[i], "--engine") == 0 && has_val)  engine_path = argv[++i];
+            else if (std::strcmp(argv[i], "--engines") == 0 && has_val) engines = std::stoi(argv[++i]);
+            else if (std::strcmp(argv[i], "--journal") == 0 && has_val) journal_path = argv[++i];
+            else if (std::strcmp(argv[i], "--idle-timeout") == 0 && has_val)
+                g_idle_timeout = std::chrono::seconds(std::stoi(argv[++i]));
+            else port = static_cast<short>(std::stoi(argv[i]));
+        }
+        // A write to an engine that has exited must fail, not kill the server
+        std::signal(SIGPIPE, SIG_IGN);
+
+        Journal journal;   // outlives the pool threads; commits the rest on exit
         boost::asio::io_context io;
         Server server(io, port);
+        if (!journal_path.empty()) restore_games(journal, journal_path, server.games(), server.engines());
+        if (!engine_path.empty() && engines > 0) {
+            std::cout << "[*] Engine pool: " << engines << " x " << engine_path << "\n";
+            server.engines().start(engine_path, engines);
+        }
+
+        // Ctrl-C / kill: stop the pool so the journal gets its last batch
+        boost::asio::signal_set signals(io, SIGINT, SIGTERM);
+        signals.async_wait([&io](boost::system::error_code ec, int) {
+            if (!ec) io.stop();
+        });
 
         unsigned int n = std::max(2u, std::thread::hardware_concurrency());
         std::cout << "[*] Thread pool: " << n << " threads\n";
@@ -0,0 +1,105 @@
+/**
+ * chess-arm-tournament: minimal UCI engine for testing engine games.
+ *
+ * Speaks just enough UCI for the server's EnginePool — uci, isready,
+ * ucinewgame, position startpos|fen ... [moves ...], go, quit — and
+ * answers go with a legal move from board.hpp: a mate in one if there is
+ * one, otherwise a random move. No search; the point is a predictable
+ * engine process on boards (or CI boxes) where Stockfish is not installed.
+ *
+ *   stub_engine [--delay-ms N] [--seed N]
+ *
+ * --delay-ms holds every bestmove back by N ms, standing in for a real
+ * search so a test can check that other games keep moving meanwhile.
+ *
+ *   chess_server_native --engine ./stub_engine --engines 2
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "board.hpp"
+
+namespace {
+
+// "position startpos moves e2e4 ..." or "position fen <6 fields> moves ..."
+bool set_position(chess::Position& pos, std::istringstream& in) {
+    std::string word;
+    in >> word;
+    if (word == "startpos") {
+        pos = chess::Position();
+        in >> word;
+    } else if (word == "fen") {
+        std::string fen, field;
+        while (in >> field && field != "moves") fen += (fen.empty() ? "" : " ") + field;
+        if (!pos.set_fen(fen)) return false;
+        word = field;
+    } else {
+        return false;
+    }
+    if (word != "moves") return true;
+    chess::Move m;
+    while (in >> word) {
+        if (!pos.find_move(word, m)) return false;
+        pos.make(m);
+    }
+    return true;
+}
+
+std::string choose(const chess::Position& pos, std::mt19937& rng) {
+    chess::MoveList list;
+    pos.legal_moves(list);
+    if (!list.size) return "0000";
+    for (const chess::Move& m : list) {
+        chess::Position next = pos;
+        next.make(m);
+        chess::MoveList replies;
+        next.legal_moves(replies);
+        if (!replies.size && next.in_check()) return m.uci();
+    }
+    return list.moves[rng() % unsigned(list.size)].uci();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int delay_ms = 0;
+    unsigned seed = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        const bool has_val = i + 1 < argc;
+        if      (!std::strcmp(argv[i], "--delay-ms") && has_val) delay_ms = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed")     && has_val) seed     = unsigned(std::atol(argv[++i]));
+        else {
+            std::cerr << "usage: " << argv[0] << " [--delay-ms N] [--seed N]\n";
+            return 2;
+        }
+    }
+    std::mt19937 rng(seed);
+    chess::Position pos;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string cmd;
+        in >> cmd;
+        if (cmd == "uci") {
+            std::cout << "id name stub_engine\nid author chess-arm-tournament\nuciok" << std::endl;
+        } else if (cmd == "isready") {
+            std::cout << "readyok" << std::endl;
+        } else if (cmd == "ucinewgame") {
+            pos = chess::Position();
+        } else if (cmd == "position") {
+            if (!set_position(pos, in)) std::cerr << "[!] bad position: " << line << "\n";
+        } else if (cmd == "go") {
+            if (delay_ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            std::cout << "bestmove " << choose(pos, rng) << std::endl;
+        } else if (cmd == "quit") {
+            break;
+        }
+    }
+    return 0;
+}
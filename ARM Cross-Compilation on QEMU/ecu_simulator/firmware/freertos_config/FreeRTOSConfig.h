@@ -36,7 +36,15 @@
 // ── Hook functions ─────────────────────────────
 #define configCHECK_FOR_STACK_OVERFLOW          2   // Method 2: pattern check
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
+#define configUSE_TRACE_FACILITY                1   // uxTaskGetSystemState()
+
+// ── Run-time stats clock ───────────────────────
+// CLINT mtime (10 MHz, free-running from reset) in µs.
+// Must match HAL::micros() in hal/hal_timer.hpp.
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() \
+    ( ( uint32_t ) ( *( volatile uint64_t * ) 0x0200BFF8UL / 10UL ) )
 
 // ── Co-routine definitions ─────────────────────
 #define configUSE_CO_ROUTINES                   0
@@ -59,7 +67,7 @@
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
 #define INCLUDE_uxTaskGetStackHighWaterMark     1
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_xTaskGetIdleTaskHandle          1
 #define INCLUDE_eTaskGetState                   1
 #define INCLUDE_xEventGroupSetBitFromISR        0
 #define INCLUDE_xTimerPendFunctionCall          0
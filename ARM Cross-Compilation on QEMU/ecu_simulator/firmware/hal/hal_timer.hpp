@@ -0,0 +1,42 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  HAL: Timer — QEMU sifive_u (RISC-V)
+//
+//  The CLINT mtime register is a free-running 64-bit
+//  counter that starts at reset. QEMU clocks it at
+//  10 MHz on sifive_u. It also drives the FreeRTOS
+//  tick, so it is the natural time base for run-time
+//  stats and jitter measurement.
+//
+//  Host build (ECU_HOST): CLOCK_MONOTONIC scaled to the
+//  same 10 MHz rate.
+// ─────────────────────────────────────────────────────
+#include <cstdint>
+#ifdef ECU_HOST
+#include <time.h>
+#endif
+
+namespace HAL {
+
+constexpr uintptr_t CLINT_MTIME = 0x0200BFF8;
+constexpr uint32_t  MTIME_HZ    = 10'000'000;
+
+#ifdef ECU_HOST
+inline uint64_t mtime() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * MTIME_HZ +
+           static_cast<uint64_t>(ts.tv_nsec) / (1'000'000'000 / MTIME_HZ);
+}
+#else
+inline uint64_t mtime() {
+    return *reinterpret_cast<volatile uint64_t*>(CLINT_MTIME);
+}
+#endif
+
+// Microseconds since reset, wraps after ~71 minutes
+inline uint32_t micros() {
+    return static_cast<uint32_t>(mtime() / (MTIME_HZ / 1'000'000));
+}
+
+} // namespace HAL
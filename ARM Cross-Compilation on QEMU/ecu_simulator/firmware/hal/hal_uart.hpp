@@ -11,11 +11,44 @@
 //    +0x10  ie       bit0=txwm, bit1=rxwm
 //    +0x14  ip       bit0=txwm, bit1=rxwm
 //    +0x18  div      divisor = (tlclk / baud) - 1
+//
+//  Host build (ECU_HOST): the same interface over file
+//  descriptors, so the tasks run unchanged on the
+//  FreeRTOS POSIX port (see hal_uart_host.cpp):
+//    UART0 TX → stdout   (CAN stream)
+//    UART1 RX ← stdin    (control commands)
+//    UART1 TX → stderr   (debug log)
 // ─────────────────────────────────────────────────────
 #include <cstdint>
 
 namespace HAL {
 
+// QEMU sifive_u UART base addresses
+constexpr uintptr_t UART0_BASE = 0x10013000;
+constexpr uintptr_t UART1_BASE = 0x10023000;
+
+#ifdef ECU_HOST
+
+class UART {
+public:
+    explicit UART(uintptr_t base);
+
+    void init(uint32_t /*baud*/ = 115200) {}
+
+    void write_byte(uint8_t c) { write(&c, 1); }
+    void write(const uint8_t* buf, uint32_t len);
+    void write_str(const char* s);
+
+    // Non-blocking receive: returns false if nothing pending
+    bool read_byte(uint8_t& out);
+
+private:
+    int rx_fd_ = -1;
+    int tx_fd_ = -1;
+};
+
+#else
+
 struct UARTRegs {
     volatile uint32_t txdata;
     volatile uint32_t rxdata;
@@ -26,10 +59,6 @@ struct UARTRegs {
     volatile uint32_t div;
 };
 
-// QEMU sifive_u UART base addresses
-constexpr uintptr_t UART0_BASE = 0x10013000;
-constexpr uintptr_t UART1_BASE = 0x10023000;
-
 // tlclk assumed 500 MHz for sifive_u in QEMU
 constexpr uint32_t TLCLK_HZ   = 500'000'000;
 
@@ -69,6 +98,8 @@ private:
     UARTRegs* regs_;
 };
 
+#endif // ECU_HOST
+
 // Global instances — defined in hal_uart.cpp
 extern UART uart0;  // CAN frames + debug out
 extern UART uart1;  // TCP control channel (QEMU second serial)
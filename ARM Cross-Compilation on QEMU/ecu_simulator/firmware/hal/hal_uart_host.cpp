@@ -0,0 +1,57 @@
+// ─────────────────────────────────────────────────────
+//  HAL: UART — host build (FreeRTOS POSIX port)
+//
+//  Replaces hal_uart.cpp when ECU_HOST is defined.
+//  The harness talks to the process over its standard
+//  streams; see the fd mapping in hal_uart.hpp.
+// ─────────────────────────────────────────────────────
+#include "hal_uart.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace HAL {
+
+UART::UART(uintptr_t base) {
+    if (base == UART0_BASE) {
+        tx_fd_ = STDOUT_FILENO;
+    } else if (base == UART1_BASE) {
+        rx_fd_ = STDIN_FILENO;
+        tx_fd_ = STDERR_FILENO;
+        // uart_ctrl_task polls; never block a FreeRTOS thread in read()
+        fcntl(rx_fd_, F_SETFL, fcntl(rx_fd_, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+void UART::write(const uint8_t* buf, uint32_t len) {
+    if (tx_fd_ < 0) return;
+    while (len > 0) {
+        ssize_t n = ::write(tx_fd_, buf, len);
+        if (n < 0) {
+            // The POSIX port's tick signal interrupts system calls
+            if (errno == EINTR) continue;
+            return;
+        }
+        buf += n;
+        len -= static_cast<uint32_t>(n);
+    }
+}
+
+void UART::write_str(const char* s) {
+    write(reinterpret_cast<const uint8_t*>(s), static_cast<uint32_t>(strlen(s)));
+}
+
+bool UART::read_byte(uint8_t& out) {
+    if (rx_fd_ < 0) return false;
+    ssize_t n;
+    do {
+        n = ::read(rx_fd_, &out, 1);
+    } while (n < 0 && errno == EINTR);
+    return n == 1;
+}
+
+UART uart0(UART0_BASE);
+UART uart1(UART1_BASE);
+
+} // namespace HAL
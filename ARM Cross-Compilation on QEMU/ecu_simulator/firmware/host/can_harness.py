@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+can_harness.py — headless CAN regression harness for the host build.
+
+Runs a scenario (scripts/scenarios/*.scn) against ecu_host, which
+boots directly in LOCKSTEP mode (ECU_LOCKSTEP=1), and records the CAN
+stream as a trace (see scripts/ecu_link.py). Then:
+
+  * --repeat N   runs the scenario N times; all traces must be identical
+  * --golden-dir compares against <dir>/<scenario>.csv
+  * --require-golden  fails a scenario that has no golden yet (ctest
+                 passes this, so a new scenario cannot go green unchecked)
+  * --bless      writes the trace as the new golden instead
+
+It also reports sample-to-transmit latency for the high-rate sample
+stream (0x110/0x111): each sample's time (batch t0 + Δt) against the
+timestamp of the wire batch that carried it.
+
+Exit status is non-zero on any mismatch, corrupt packet or stall.
+
+Usage:
+    python3 host/can_harness.py --exe build/ecu_host scripts/scenarios/*.scn
+"""
+import argparse
+import os
+import subprocess
+import sys
+import threading
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "scripts"))
+import ecu_link as ecu  # noqa: E402
+
+
+def run_once(exe: str, events: list) -> tuple:
+    """Returns (trace lines, corrupt packet count, [latency ms])."""
+    env = dict(os.environ, ECU_LOCKSTEP="1")
+    proc = subprocess.Popen([exe], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            stderr=subprocess.PIPE, env=env)
+    decoder = ecu.FrameDecoder(ecu.FORMAT_COBS_V1, synced=True)
+    trace, latency = [], []
+
+    def reader():
+        t_sample = None
+        while True:
+            chunk = os.read(proc.stdout.fileno(), 65536)
+            if not chunk:
+                break
+            for ts, can_id, data in decoder.feed(chunk):
+                trace.append(ecu.trace_line(ts, can_id, data))
+                if can_id == ecu.CAN_ID_SAMPLE_HDR:
+                    t_sample = ecu.parse_sample_hdr(data)[0]
+                elif can_id == ecu.CAN_ID_SAMPLE and t_sample is not None:
+                    t_sample += data[0]
+                    latency.append(ts - t_sample)
+
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+
+    ctrl = ecu.ControlLink(None, sock=ecu.PipeTransport(proc))
+    try:
+        ctrl.wait_sim_ack(timeout=10.0)          # "[SIM] t=0" once all tasks parked
+        ctrl.set_wire_format(ecu.FORMAT_COBS_V1)
+        now = 0
+        for t_ms, cmd, arg in events:
+            if t_ms > now:
+                now = ctrl.sim_step(t_ms - now)
+            ecu.apply_scenario_event(ctrl, cmd, arg)
+    finally:
+        proc.kill()
+        proc.wait()
+        thread.join()
+    return trace, decoder.corrupt, latency
+
+
+def first_diff(a: list, b: list) -> str:
+    for i, (x, y) in enumerate(zip(a, b)):
+        if x != y:
+            return f"line {i + 2}: expected {x.strip()!r}, got {y.strip()!r}"
+    return f"length differs: expected {len(a)} frames, got {len(b)}"
+
+
+def report_latency(latency: list):
+    if not latency:
+        print("  latency : no sample stream in this scenario")
+        return
+    s = sorted(latency)
+    p99 = s[min(len(s) - 1, int(len(s) * 0.99))]
+    print(f"  latency : {len(s)} samples, min {s[0]} ms, "
+          f"mean {sum(s) / len(s):.1f} ms, p99 {p99} ms, max {s[-1]} ms")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("scenarios", nargs="+")
+    ap.add_argument("--exe", required=True, help="path to ecu_host")
+    ap.add_argument("--golden-dir", default=os.path.join(os.path.dirname(__file__), "golden"))
+    ap.add_argument("--repeat", type=int, default=1)
+    ap.add_argument("--bless", action="store_true", help="write traces as new goldens")
+    ap.add_argument("--require-golden", action="store_true",
+                    help="fail scenarios without a golden trace")
+    args = ap.parse_args()
+
+    failed = 0
+    for path in args.scenarios:
+        name = os.path.splitext(os.path.basename(path))[0]
+        print(f"[CAN] {name}")
+        try:
+            events = ecu.load_scenario(path)
+            runs = [run_once(args.exe, events) for _ in range(max(args.repeat, 1))]
+        except (ValueError, RuntimeError, ConnectionError, OSError) as e:
+            print(f"  FAIL    : {e}")
+            failed += 1
+            continue
+
+        trace, corrupt, latency = runs[0]
+        print(f"  frames  : {len(trace)}")
+        report_latency(latency)
+
+        ok = True
+        if corrupt:
+            print(f"  FAIL    : {corrupt} corrupt packets")
+            ok = False
+        for i, (other, _, _) in enumerate(runs[1:], 2):
+            if other != trace:
+                print(f"  FAIL    : run {i} differs — {first_diff(trace, other)}")
+                ok = False
+
+        golden = os.path.join(args.golden_dir, name + ".csv")
+        if args.bless:
+            os.makedirs(args.golden_dir, exist_ok=True)
+            with open(golden, "w", newline="\n") as f:
+                f.write(ecu.TRACE_HEADER)
+                f.writelines(trace)
+            print(f"  blessed : {golden}")
+        elif os.path.exists(golden):
+            with open(golden) as f:
+                expected = f.readlines()[1:]
+            if expected != trace:
+                print(f"  FAIL    : golden mismatch — {first_diff(expected, trace)}")
+                ok = False
+            else:
+                print("  golden  : match")
+        elif args.require_golden:
+            print(f"  FAIL    : no golden {golden} (record it with --bless)")
+            ok = False
+        else:
+            print("  golden  : none (run with --bless to record)")
+
+        failed += not ok
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
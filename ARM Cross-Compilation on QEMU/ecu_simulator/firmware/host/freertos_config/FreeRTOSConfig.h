@@ -0,0 +1,76 @@
+// FreeRTOSConfig.h — host build (FreeRTOS POSIX port)
+// Mirrors ../../freertos_config/FreeRTOSConfig.h; only the
+// port-specific settings differ.
+#pragma once
+
+// ── Core settings ─────────────────────────────
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configUSE_MALLOC_FAILED_HOOK            1
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    ( 7 )
+// Every task is a pthread: stacks must clear PTHREAD_STACK_MIN
+#define configMINIMAL_STACK_SIZE                ( ( uint16_t ) 2048 )
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                 ( 16 )
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   3
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             0
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_QUEUE_SETS                    0
+#define configQUEUE_REGISTRY_SIZE               16
+#define configUSE_TIME_SLICING                  1
+#define configUSE_NEWLIB_REENTRANT              0
+#define configENABLE_BACKWARD_COMPATIBILITY     0
+#define configNUM_REGION_PARAMETERS             0
+#define configSTACK_DEPTH_TYPE                  uint32_t
+#define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
+
+// ── Memory allocation ──────────────────────────
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+
+// ── Hook functions ─────────────────────────────
+#define configCHECK_FOR_STACK_OVERFLOW          0   // pthread stacks are not FreeRTOS-managed
+#define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#define configGENERATE_RUN_TIME_STATS           1
+#define configUSE_TRACE_FACILITY                1   // uxTaskGetSystemState()
+
+// ── Run-time stats clock ───────────────────────
+// µs from CLOCK_MONOTONIC — see host/host_runtime.cpp
+#ifdef __cplusplus
+extern "C"
+#endif
+unsigned long ulHostRunTimeCounter( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        ( ( uint32_t ) ulHostRunTimeCounter() )
+
+// ── Co-routine definitions ─────────────────────
+#define configUSE_CO_ROUTINES                   0
+
+// ── Software timer definitions ─────────────────
+#define configUSE_TIMERS                        0
+
+// ── Optional functions ─────────────────────────
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xResumeFromISR                  1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xEventGroupSetBitFromISR        0
+#define INCLUDE_xTimerPendFunctionCall          0
+#define INCLUDE_xTaskAbortDelay                 0
+#define INCLUDE_xTaskGetHandle                  1
+#define INCLUDE_xTaskResumeFromISR              1
@@ -0,0 +1,8 @@
+// ─────────────────────────────────────────────────────
+//  Host build — port glue not covered by the HAL
+// ─────────────────────────────────────────────────────
+#include "../hal/hal_timer.hpp"
+
+extern "C" unsigned long ulHostRunTimeCounter(void) {
+    return HAL::micros();
+}
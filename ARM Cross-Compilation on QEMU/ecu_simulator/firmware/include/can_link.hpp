@@ -0,0 +1,47 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CAN Link — UART0 framing
+//
+//  Every task that emits CAN frames collects them in a
+//  CANBatch and flushes once per cycle. The batch goes
+//  out in the wire format currently selected:
+//    LEGACY  → back-to-back 13-byte CANFrames
+//    COBS_V1 → one COBS packet with timestamp + CRC-16
+//
+//  The format is switched at run time by the
+//  SET_WIRE_FORMAT control command. A mutex serialises
+//  UART0 so packets from different tasks never interleave.
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+#include "../include/ecu_protocol.hpp"
+#include "../include/ecu_wire.hpp"
+
+namespace ECU {
+
+// Create the UART0 mutex — called from main()
+void can_link_init();
+
+void         can_link_set_format(Wire::Format f);
+Wire::Format can_link_format();
+
+// Largest batch put on the wire since the last call, in frames
+// (out of Wire::MAX_BATCH_FRAMES) — how far TX fell behind
+uint8_t can_link_take_batch_peak();
+
+class CANBatch {
+public:
+    // Queue a frame; flushes automatically when the batch is full
+    void add(const CANFrame& f);
+
+    // Put all queued frames on the wire as one packet
+    void flush();
+
+    size_t size() const { return count_; }
+
+private:
+    CANFrame frames_[Wire::MAX_BATCH_FRAMES];
+    size_t   count_ = 0;
+};
+
+} // namespace ECU
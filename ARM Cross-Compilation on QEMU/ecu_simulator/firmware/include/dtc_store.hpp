@@ -0,0 +1,201 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  DTC Store
+//
+//  Fixed table of Diagnostic Trouble Codes keyed by
+//  code: open addressing, linear probing, and deletion
+//  by backward shift (no tombstones). Every operation
+//  touches at most SLOTS entries and nothing is
+//  allocated, so a fault storm costs the same per event
+//  as a single fault.
+//
+//  Each DTC keeps a ring of freeze frames, one per
+//  occurrence (stored → active), newest overwriting
+//  oldest. Repeat reports while active only bump the
+//  count, so the storm never flushes the snapshot of
+//  the onset.
+//
+//  Lifecycle (driven by age()):
+//    active  — reported within HEAL_MS
+//    stored  — quiet for HEAL_MS, kept for the dump
+//    removed — quiet for AGE_OUT_MS
+//  When the table is full, a new code evicts the
+//  stored entry that has been quiet longest. If every
+//  entry is active the report is counted in dropped().
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+
+namespace ECU {
+
+// ECU state captured when a DTC becomes active
+struct FreezeFrame {
+    uint32_t t_ms;
+    uint16_t rpm;
+    int16_t  coolant_temp_c;
+    uint16_t battery_mv;
+};
+
+struct DTCEntry {
+    static constexpr size_t FREEZE_FRAMES = 4;
+
+    uint16_t    code;            // 0 = empty slot
+    uint8_t     count;           // reports, saturating
+    bool        active;
+    uint32_t    first_seen_ms;
+    uint32_t    last_seen_ms;
+    uint8_t     ff_head;         // next ring slot to write
+    uint8_t     ff_count;
+    FreezeFrame ff[FREEZE_FRAMES];
+
+    // i = 0 is the newest snapshot
+    const FreezeFrame& freeze_frame(size_t i) const {
+        return ff[(ff_head + FREEZE_FRAMES - 1 - i) % FREEZE_FRAMES];
+    }
+};
+
+class DTCStore {
+public:
+    static constexpr size_t   SLOT_BITS   = 4;
+    static constexpr size_t   SLOTS       = size_t{1} << SLOT_BITS;
+    static constexpr size_t   MAX_ENTRIES = 12;       // ≤ 75 % load keeps probes short
+    static constexpr uint32_t HEAL_MS     = 2000;     // faults re-report at 10 Hz
+    static constexpr uint32_t AGE_OUT_MS  = 120000;
+
+    // Log one report of code at t_ms. snap is stored only
+    // when this report starts a new occurrence.
+    // Returns the entry, or nullptr if it was dropped.
+    DTCEntry* record(uint16_t code, uint32_t t_ms, const FreezeFrame& snap) {
+        if (code == 0) return nullptr;
+
+        DTCEntry* e = find(code);
+        if (!e) {
+            if (size_ >= MAX_ENTRIES && !evict_oldest_stored()) {
+                if (dropped_ < UINT8_MAX) dropped_++;
+                return nullptr;
+            }
+            e = insert(code, t_ms);
+        }
+
+        if (e->count < UINT8_MAX) e->count++;
+        e->last_seen_ms = t_ms;
+        if (!e->active) {
+            e->active = true;
+            active_++;
+            e->ff[e->ff_head] = snap;
+            e->ff_head = static_cast<uint8_t>((e->ff_head + 1) % DTCEntry::FREEZE_FRAMES);
+            if (e->ff_count < DTCEntry::FREEZE_FRAMES) e->ff_count++;
+        }
+        return e;
+    }
+
+    // Heal quiet codes and remove ones past AGE_OUT_MS
+    void age(uint32_t now_ms) {
+        size_t i = 0;
+        while (i < SLOTS) {
+            DTCEntry& e = slots_[i];
+            if (e.code != 0) {
+                const uint32_t quiet = now_ms - e.last_seen_ms;
+                if (e.active && quiet > HEAL_MS) {
+                    e.active = false;
+                    active_--;
+                }
+                if (!e.active && quiet > AGE_OUT_MS) {
+                    erase_at(i);
+                    continue;   // slot i now holds a shifted entry
+                }
+            }
+            i++;
+        }
+    }
+
+    void clear() {
+        for (auto& e : slots_) e = DTCEntry{};
+        size_   = 0;
+        active_ = 0;
+        dropped_ = 0;
+    }
+
+    // Visit every stored DTC in slot order
+    template<typename Fn>
+    void for_each(Fn fn) const {
+        for (const auto& e : slots_) {
+            if (e.code != 0) fn(e);
+        }
+    }
+
+    size_t   size()         const { return size_; }
+    unsigned active_count() const { return active_; }
+    uint8_t  dropped()      const { return dropped_; }
+
+private:
+    static constexpr size_t MASK = SLOTS - 1;
+
+    DTCEntry slots_[SLOTS]{};
+    size_t   size_    = 0;
+    unsigned active_  = 0;
+    uint8_t  dropped_ = 0;
+
+    // Fibonacci hashing: top SLOT_BITS of code × 2^16/φ
+    static size_t home(uint16_t code) {
+        return static_cast<uint16_t>(code * 0x9E37u) >> (16 - SLOT_BITS);
+    }
+
+    DTCEntry* find(uint16_t code) {
+        size_t i = home(code);
+        for (size_t n = 0; n < SLOTS; n++, i = (i + 1) & MASK) {
+            if (slots_[i].code == code) return &slots_[i];
+            if (slots_[i].code == 0)    return nullptr;
+        }
+        return nullptr;
+    }
+
+    // Caller guarantees a free slot (size_ < MAX_ENTRIES < SLOTS)
+    DTCEntry* insert(uint16_t code, uint32_t t_ms) {
+        size_t i = home(code);
+        while (slots_[i].code != 0) i = (i + 1) & MASK;
+        DTCEntry& e = slots_[i];
+        e = DTCEntry{};
+        e.code          = code;
+        e.first_seen_ms = t_ms;
+        size_++;
+        return &e;
+    }
+
+    // Remove slot i and pull later members of the probe
+    // chain back so find() never stops short
+    void erase_at(size_t i) {
+        if (slots_[i].active) active_--;
+        size_t j = i;
+        for (;;) {
+            j = (j + 1) & MASK;
+            if (slots_[j].code == 0) break;
+            // j may fill the hole only if i lies on its probe path
+            const size_t h = home(slots_[j].code);
+            if (((j - h) & MASK) >= ((j - i) & MASK)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = DTCEntry{};
+        size_--;
+    }
+
+    bool evict_oldest_stored() {
+        size_t   victim = SLOTS;
+        uint32_t oldest = 0;
+        for (size_t i = 0; i < SLOTS; i++) {
+            const DTCEntry& e = slots_[i];
+            if (e.code == 0 || e.active) continue;
+            if (victim == SLOTS || static_cast<int32_t>(e.last_seen_ms - oldest) < 0) {
+                victim = i;
+                oldest = e.last_seen_ms;
+            }
+        }
+        if (victim == SLOTS) return false;
+        erase_at(victim);
+        return true;
+    }
+};
+
+} // namespace ECU
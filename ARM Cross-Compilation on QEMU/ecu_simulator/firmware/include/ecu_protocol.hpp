@@ -9,18 +9,47 @@
 // ── CAN frame IDs ────────────────────────────
 constexpr uint32_t CAN_ID_RPM          = 0x100;
 constexpr uint32_t CAN_ID_THROTTLE     = 0x101;
+// High-rate telemetry (SET_SAMPLE_RATE > 0):
+//   SAMPLE_HDR data: [0:3]=t0_ms BE, [4:5]=batch seq BE, [6]=count, [7]=period_ms
+//   SAMPLE     data: [0]=dt_ms from previous sample (0 for the first),
+//                    [1:2]=rpm, [3]=throttle, [4:5]=coolant ×10, [6:7]=battery mV
+constexpr uint32_t CAN_ID_SAMPLE_HDR   = 0x110;
+constexpr uint32_t CAN_ID_SAMPLE       = 0x111;
 constexpr uint32_t CAN_ID_COOLANT_TEMP = 0x200;
 constexpr uint32_t CAN_ID_FUEL_LEVEL   = 0x201;
 constexpr uint32_t CAN_ID_VOLTAGE      = 0x202;
 constexpr uint32_t CAN_ID_FAULT        = 0x7E0;   // OBD-II diagnostic range
 // Fault frame payload: data[0]=fault_mask, data[1]=engine_state
 constexpr uint32_t CAN_ID_DTC          = 0x7E8;
+// DTC dump (reply to DTC_DUMP): one DTC_RECORD per stored code,
+// each followed by its DTC_FREEZE frames, newest first.
+//   DTC_RECORD data: [0:1]=code BE, [2]=status (bit0 active,
+//                    bit3 confirmed), [3]=report count (saturating),
+//                    [4]=freeze frames that follow, [5]=record index,
+//                    [6]=record total, [7]=s since last report (sat.)
+//   DTC_FREEZE data: [0:1]=rpm, [2:3]=coolant °C (signed),
+//                    [4:5]=battery mV, [6:7]=age in 0.1 s (saturating)
+//   An empty store replies with one DTC_RECORD: code 0, total 0.
+constexpr uint32_t CAN_ID_DTC_RECORD   = 0x7E9;
+constexpr uint32_t CAN_ID_DTC_FREEZE   = 0x7EA;
+// Run-time diagnostics (every 1 s):
+//   TASK_STATS  data: [0]=TaskId, [1]=CPU % over the window, [2:3]=stack
+//                     high-water mark (words, BE), [4:5]=worst period jitter
+//                     µs BE (saturating), [6]=missed deadlines, [7]=reserved
+//   QUEUE_STATS data: [0]=sample ring fill, [1]=ring capacity, [2]=ring peak
+//                     fill, [3]=ring drops in window, [4]=fault queue fill,
+//                     [5]=fault queue capacity, [6]=largest CAN TX batch
+//                     in window (frames), [7]=batch capacity
+constexpr uint32_t CAN_ID_TASK_STATS   = 0x7F0;
+constexpr uint32_t CAN_ID_QUEUE_STATS  = 0x7F1;
 
 // ── CAN frame over UART ───────────────────────
 // Wire format (10 bytes fixed):
 //   [0xAA] [ID_HI] [ID_LO] [LEN] [D0..D7 up to 8] ... [0x55]
 // We always send 12 bytes total for simplicity:
 //   SOF(1) + ID(2) + LEN(1) + DATA(8) + EOF(1) = 13 bytes
+// A compact COBS + CRC-16 batch format is available
+// as well — see ecu_wire.hpp (SET_WIRE_FORMAT).
 constexpr uint8_t  FRAME_SOF = 0xAA;
 constexpr uint8_t  FRAME_EOF = 0x55;
 constexpr uint16_t FRAME_SIZE = 13;
@@ -40,8 +69,13 @@ enum class ControlCmd : uint8_t {
     INJECT_OVERHEAT   = 0x10,
     INJECT_SENSOR_DISC= 0x11,
     INJECT_VOLT_DROP  = 0x12,
-    CLEAR_FAULTS      = 0x20,
+    CLEAR_FAULTS      = 0x20,  // also erases the DTC store
+    DTC_DUMP          = 0x21,  // reply: DTC_RECORD / DTC_FREEZE frames
     SET_RPM_TARGET    = 0x30,  // + 2 byte uint16 RPM
+    SET_SAMPLE_RATE   = 0x31,  // + 2 byte uint16 Hz (0 = default 10 Hz, no sample stream)
+    SET_WIRE_FORMAT   = 0x40,  // + 1 byte Wire::Format (0=legacy, 1=COBS v1)
+    SIM_MODE          = 0x50,  // + 1 byte ClockMode (0=realtime, 1=lockstep)
+    SIM_STEP          = 0x51,  // + 2 byte uint16 ms to advance the virtual clock
     PING              = 0xFF,
 };
 
@@ -54,6 +88,18 @@ enum class FaultCode : uint8_t {
     WATCHDOG_RESET   = 0x08,
 };
 
+// ── Task IDs (TASK_STATS data[0]) ─────────────
+enum class TaskId : uint8_t {
+    ENGINE   = 0,
+    SENSORS  = 1,
+    CAN_TX   = 2,
+    DIAG     = 3,
+    WATCHDOG = 4,
+    UART_RX  = 5,
+    IDLE     = 6,
+    COUNT    = 7,
+};
+
 // ── ECU state (firmware internal + telemetry) ─
 struct ECUState {
     uint16_t rpm;              // 0 – 8000
@@ -73,3 +119,13 @@ inline void pack_u16(uint8_t* buf, uint16_t v) {
 inline uint16_t unpack_u16(const uint8_t* buf) {
     return static_cast<uint16_t>((buf[0] << 8) | buf[1]);
 }
+inline void pack_u32(uint8_t* buf, uint32_t v) {
+    buf[0] = static_cast<uint8_t>(v >> 24);
+    buf[1] = static_cast<uint8_t>(v >> 16);
+    buf[2] = static_cast<uint8_t>(v >> 8);
+    buf[3] = static_cast<uint8_t>(v & 0xFF);
+}
+inline uint32_t unpack_u32(const uint8_t* buf) {
+    return (static_cast<uint32_t>(buf[0]) << 24) | (static_cast<uint32_t>(buf[1]) << 16) |
+           (static_cast<uint32_t>(buf[2]) << 8)  |  static_cast<uint32_t>(buf[3]);
+}
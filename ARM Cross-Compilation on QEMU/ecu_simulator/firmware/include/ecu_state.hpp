@@ -11,12 +11,13 @@
 #include "queue.h"
 #include "semphr.h"
 #include "../include/ecu_protocol.hpp"
+#include "../include/spsc_ring.hpp"
+#include "../include/sim_clock.hpp"
 
 namespace ECU {
 
 // ── Sensor reading passed from T2 → T3 ───────
 struct SensorReading {
-    uint32_t timestamp_ms;
     uint16_t rpm;
     uint8_t  throttle_pct;
     int16_t  coolant_temp_c;
@@ -24,13 +25,35 @@ struct SensorReading {
     uint16_t battery_mv;
 };
 
+// ── Batch of readings (T2 fills, T3 drains) ──
+// Timestamps are delta-encoded: t0_ms is the time of
+// readings[0], dt_ms[i] is the gap to readings[i-1].
+struct SensorBatch {
+    static constexpr size_t CAPACITY = 32;
+
+    uint32_t      t0_ms;
+    uint16_t      seq;          // batch sequence number (wraps)
+    uint8_t       count;
+    uint8_t       period_ms;    // sampling period for this batch
+    bool          streamed;     // high-rate mode: send every sample
+    uint8_t       dt_ms[CAPACITY];
+    SensorReading readings[CAPACITY];
+};
+
 // ── Fault event passed from any task → T4 ────
+// code NONE carries a DiagRequest in context, so
+// requests are handled in order with the faults.
 struct FaultEvent {
     FaultCode  code;
     uint32_t   timestamp_ms;
     uint8_t    context;        // task-specific detail byte
 };
 
+enum class DiagRequest : uint8_t {
+    DTC_DUMP  = 1,
+    DTC_CLEAR = 2,
+};
+
 // ── Control command from UART RX → tasks ─────
 struct ControlEvent {
     ControlCmd cmd;
@@ -42,10 +65,12 @@ extern ECUState      g_state;
 extern SemaphoreHandle_t g_state_mutex;
 
 // ── Inter-task queues ─────────────────────────
-extern QueueHandle_t g_sensor_queue;    // SensorReading   (T2 → T3)
+constexpr UBaseType_t FAULT_QUEUE_DEPTH   = 16;
+constexpr UBaseType_t CONTROL_QUEUE_DEPTH = 8;
+
+extern SpscRing<SensorBatch, 8> g_sample_ring;  // SensorBatch (T2 → T3)
 extern QueueHandle_t g_fault_queue;     // FaultEvent      (any → T4)
 extern QueueHandle_t g_control_queue;   // ControlEvent    (UART ISR → T1/T2)
-extern QueueHandle_t g_can_tx_queue;    // CANFrame        (T3 internal)
 
 // ── Task handles (for watchdog monitoring) ───
 extern TaskHandle_t  g_task_engine;
@@ -53,6 +78,7 @@ extern TaskHandle_t  g_task_sensors;
 extern TaskHandle_t  g_task_can_tx;
 extern TaskHandle_t  g_task_diag;
 extern TaskHandle_t  g_task_watchdog;
+extern TaskHandle_t  g_task_uart_rx;
 
 // ── Helpers ───────────────────────────────────
 
@@ -76,10 +102,17 @@ void state_update(Fn fn) {
 
 // Post a fault (non-blocking, drops if queue full)
 inline void post_fault(FaultCode code, uint8_t ctx = 0) {
-    FaultEvent ev{code, static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS), ctx};
+    FaultEvent ev{code, now_ms(), ctx};
     xQueueSend(g_fault_queue, &ev, 0);
 }
 
+// Ask T4 for a DTC dump / clear. Waits briefly for room
+// so a fault storm cannot swallow the request.
+inline bool post_diag_request(DiagRequest req) {
+    FaultEvent ev{FaultCode::NONE, now_ms(), static_cast<uint8_t>(req)};
+    return xQueueSend(g_fault_queue, &ev, pdMS_TO_TICKS(10)) == pdTRUE;
+}
+
 // Initialise all queues and the mutex — called from main()
 void init();
 
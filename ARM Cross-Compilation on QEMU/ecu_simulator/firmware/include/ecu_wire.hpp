@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "ecu_protocol.hpp"
+
+// ─────────────────────────────────────────────
+//  ECU Simulator — Compact Wire Format (v1)
+//  Used by both firmware (QEMU) and Qt GUI.
+//
+//  One packet carries a batch of CAN frames and is
+//  COBS-encoded, then terminated by a 0x00 byte:
+//
+//    [VER] [TS x4] { [ID:LEN x2] [DATA x LEN] }... [CRC x2]
+//
+//    VER     WIRE_VERSION_V1
+//    TS      batch timestamp, ms since boot, uint32 BE
+//    ID:LEN  CAN ID in bits 15..4, data length in bits 3..0, BE
+//    CRC     CRC-16/CCITT-FALSE over VER..last data byte, BE
+//
+//  COBS guarantees the payload never contains 0x00,
+//  so a receiver always resyncs on the next delimiter
+//  and the CRC rejects any damaged batch.
+// ─────────────────────────────────────────────
+
+namespace Wire {
+
+enum class Format : uint8_t {
+    LEGACY  = 0,   // Fixed 13-byte CANFrame with SOF/EOF markers
+    COBS_V1 = 1,   // COBS batch + timestamp + CRC-16 (this file)
+};
+
+constexpr uint8_t VERSION_V1        = 0x01;
+constexpr uint8_t DELIMITER         = 0x00;
+constexpr size_t  BATCH_HEADER_SIZE = 5;    // VER + TS
+constexpr size_t  FRAME_HEADER_SIZE = 2;    // ID:LEN
+constexpr size_t  CRC_SIZE          = 2;
+constexpr size_t  MAX_BATCH_FRAMES  = 16;
+
+constexpr size_t MAX_PAYLOAD =
+    BATCH_HEADER_SIZE + MAX_BATCH_FRAMES * (FRAME_HEADER_SIZE + 8) + CRC_SIZE;
+// COBS adds one code byte per 254 data bytes (+1), then the delimiter
+constexpr size_t MAX_ENCODED = MAX_PAYLOAD + MAX_PAYLOAD / 254 + 2;
+
+// ── CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) ──
+struct CRC16Table {
+    uint16_t v[256];
+    constexpr CRC16Table() : v{} {
+        for (int i = 0; i < 256; ++i) {
+            uint16_t c = static_cast<uint16_t>(i << 8);
+            for (int b = 0; b < 8; ++b) {
+                c = (c & 0x8000) ? static_cast<uint16_t>((c << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(c << 1);
+            }
+            v[i] = c;
+        }
+    }
+};
+inline constexpr CRC16Table CRC16_TABLE{};
+
+inline uint16_t crc16(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF) {
+    while (n--) {
+        crc = static_cast<uint16_t>((crc << 8) ^ CRC16_TABLE.v[((crc >> 8) ^ *p++) & 0xFF]);
+    }
+    return crc;
+}
+
+// ── COBS ──────────────────────────────────────
+// Encodes len bytes into out (no delimiter appended).
+// out must hold at least len + len / 254 + 1 bytes.
+inline size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t  code_idx = 0;
+    size_t  o        = 1;
+    uint8_t code     = 1;
+    for (size_t i = 0; i < len; ++i) {
+        if (in[i] == 0) {
+            out[code_idx] = code;
+            code_idx = o++;
+            code     = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) {
+                out[code_idx] = code;
+                code_idx = o++;
+                code     = 1;
+            }
+        }
+    }
+    out[code_idx] = code;
+    return o;
+}
+
+// Decodes one packet (delimiter already stripped).
+// Safe to call with out == in. Returns 0 if malformed.
+inline size_t cobs_decode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) return 0;
+        for (uint8_t k = 1; k < code; ++k) {
+            if (in[i] == 0) return 0;
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < len) out[o++] = 0;
+    }
+    return o;
+}
+
+// ── Batch encoder ─────────────────────────────
+class BatchEncoder {
+public:
+    void begin(uint32_t timestamp_ms) {
+        buf_[0] = VERSION_V1;
+        pack_u32(buf_ + 1, timestamp_ms);
+        len_   = BATCH_HEADER_SIZE;
+        count_ = 0;
+    }
+
+    bool   full()  const { return count_ >= MAX_BATCH_FRAMES; }
+    size_t count() const { return count_; }
+
+    void add(uint16_t id, uint8_t len, const uint8_t* data) {
+        if (full()) return;
+        if (len > 8) len = 8;
+        pack_u16(buf_ + len_, static_cast<uint16_t>((id << 4) | len));
+        len_ += FRAME_HEADER_SIZE;
+        for (uint8_t i = 0; i < len; ++i) buf_[len_++] = data[i];
+        ++count_;
+    }
+
+    // Appends the CRC, COBS-encodes into out and terminates
+    // with the delimiter. out must hold MAX_ENCODED bytes.
+    // Returns the number of bytes to put on the wire.
+    size_t finish(uint8_t* out) {
+        pack_u16(buf_ + len_, crc16(buf_, len_));
+        size_t n = cobs_encode(buf_, len_ + CRC_SIZE, out);
+        out[n++] = DELIMITER;
+        return n;
+    }
+
+private:
+    uint8_t buf_[MAX_PAYLOAD];
+    size_t  len_   = 0;
+    size_t  count_ = 0;
+};
+
+// ── Batch decoder ─────────────────────────────
+enum class DecodeResult : uint8_t {
+    OK,
+    BAD_COBS,
+    BAD_LENGTH,
+    BAD_CRC,
+    BAD_VERSION,
+};
+
+inline const char* decode_result_str(DecodeResult r) {
+    switch (r) {
+    case DecodeResult::OK:          return "ok";
+    case DecodeResult::BAD_COBS:    return "bad COBS";
+    case DecodeResult::BAD_LENGTH:  return "bad length";
+    case DecodeResult::BAD_CRC:     return "CRC mismatch";
+    case DecodeResult::BAD_VERSION: return "unknown version";
+    }
+    return "?";
+}
+
+// Decodes one packet in place (delimiter already stripped).
+// The whole batch is validated before on_frame(const CANFrame&)
+// is called for any frame, so a damaged batch emits nothing.
+template<typename Fn>
+DecodeResult decode_batch(uint8_t* pkt, size_t len, uint32_t& timestamp_ms, Fn&& on_frame) {
+    size_t n = cobs_decode(pkt, len, pkt);
+    if (n == 0) return DecodeResult::BAD_COBS;
+    if (n < BATCH_HEADER_SIZE + CRC_SIZE) return DecodeResult::BAD_LENGTH;
+
+    size_t body = n - CRC_SIZE;
+    if (crc16(pkt, body) != unpack_u16(pkt + body)) return DecodeResult::BAD_CRC;
+    if (pkt[0] != VERSION_V1) return DecodeResult::BAD_VERSION;
+
+    // Structural pass: every frame must fit exactly
+    for (size_t p = BATCH_HEADER_SIZE; p < body; ) {
+        if (p + FRAME_HEADER_SIZE > body) return DecodeResult::BAD_LENGTH;
+        uint8_t flen = unpack_u16(pkt + p) & 0x0F;
+        if (flen > 8 || p + FRAME_HEADER_SIZE + flen > body) return DecodeResult::BAD_LENGTH;
+        p += FRAME_HEADER_SIZE + flen;
+    }
+
+    timestamp_ms = unpack_u32(pkt + 1);
+    for (size_t p = BATCH_HEADER_SIZE; p < body; ) {
+        uint16_t hdr = unpack_u16(pkt + p);
+        CANFrame f{};
+        f.sof = FRAME_SOF;
+        f.id  = static_cast<uint16_t>(hdr >> 4);
+        f.len = static_cast<uint8_t>(hdr & 0x0F);
+        for (uint8_t i = 0; i < f.len; ++i) f.data[i] = pkt[p + FRAME_HEADER_SIZE + i];
+        f.eof = FRAME_EOF;
+        on_frame(f);
+        p += FRAME_HEADER_SIZE + f.len;
+    }
+    return DecodeResult::OK;
+}
+
+} // namespace Wire
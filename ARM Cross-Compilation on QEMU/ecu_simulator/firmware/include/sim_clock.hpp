@@ -0,0 +1,71 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  Simulation Clock
+//
+//  REALTIME (default): tasks follow FreeRTOS ticks and
+//  now_ms() is the tick count.
+//
+//  LOCKSTEP: Engine, Sensors and CAN TX stop following
+//  ticks. Each one parks at the end of its cycle with a
+//  virtual deadline, and the driver (UART RX task,
+//  SIM_STEP command) advances the virtual clock:
+//
+//    for each deadline t ≤ target, in time order:
+//        now_ms() = t
+//        wake ENGINE, SENSORS, CAN_TX (fixed order)
+//        if their deadline is due, waiting for each
+//        to park again before waking the next
+//
+//  Only one simulated task runs at a time, in a fixed
+//  order, so a given command sequence always produces
+//  the same CAN output, however fast the host runs it.
+//  Entering LOCKSTEP restarts the virtual clock at 0.
+//
+//  The handshake uses task notification index 1,
+//  leaving index 0 free for application use.
+// ─────────────────────────────────────────────────────
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "../include/ecu_protocol.hpp"
+
+namespace ECU {
+
+enum class ClockMode : uint8_t {
+    REALTIME = 0,
+    LOCKSTEP = 1,
+};
+
+constexpr UBaseType_t SIM_NOTIFY_INDEX = 1;
+
+ClockMode clock_mode();
+
+// Milliseconds since boot (REALTIME) or since LOCKSTEP entry
+uint32_t now_ms();
+
+// ── Task side ─────────────────────────────────
+// True for tasks driven by the virtual clock in LOCKSTEP
+bool sim_participates(TaskId id);
+
+// Parks the calling task until the virtual clock reaches
+// its previous deadline + period_ms. Returns early if
+// the mode switches back to REALTIME.
+void sim_park(TaskId id, uint32_t period_ms);
+
+// ── Driver side (one caller, the UART RX task) ─
+// Switches mode. Entering LOCKSTEP waits until every
+// simulated task has parked. Returns false on timeout.
+bool sim_set_mode(ClockMode mode);
+
+// Advances the virtual clock by ms, running every task
+// deadline on the way. Returns false if a task stalled.
+bool sim_advance(uint32_t ms);
+
+// ── Boot in LOCKSTEP ──────────────────────────
+// Called from main() before the scheduler starts, so no
+// simulated task runs a real-time cycle first. The
+// driver must then call sim_wait_parked() once.
+void sim_boot_lockstep(TaskHandle_t driver);
+bool sim_wait_parked();
+
+} // namespace ECU
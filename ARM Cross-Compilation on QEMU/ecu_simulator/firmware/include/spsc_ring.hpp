@@ -0,0 +1,72 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  SPSC Ring
+//
+//  Fixed-depth single-producer / single-consumer ring
+//  of in-place slots. The producer fills the slot from
+//  acquire() and publishes it with commit(); the
+//  consumer reads front() and releases it with pop().
+//  No locks, no copies, no allocation.
+// ─────────────────────────────────────────────────────
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ECU {
+
+template<typename T, size_t N>
+class SpscRing {
+    static_assert(N != 0 && (N & (N - 1)) == 0, "SpscRing depth must be a power of two");
+
+public:
+    // ── Producer ──────────────────────────────
+    // Slot to fill, or nullptr if the consumer is N behind
+    T* acquire() {
+        uint32_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_.load(std::memory_order_acquire) >= N) return nullptr;
+        return &slots_[h & (N - 1)];
+    }
+
+    void commit() {
+        uint32_t h = head_.load(std::memory_order_relaxed) + 1;
+        head_.store(h, std::memory_order_release);
+
+        uint32_t fill = h - tail_.load(std::memory_order_relaxed);
+        uint32_t prev = peak_.load(std::memory_order_relaxed);
+        while (fill > prev &&
+               !peak_.compare_exchange_weak(prev, fill, std::memory_order_relaxed)) {}
+    }
+
+    // Producer-side count of items lost because the ring was full
+    void     note_drop()   { drops_.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t drops() const { return drops_.load(std::memory_order_relaxed); }
+
+    // ── Consumer ──────────────────────────────
+    const T* front() const {
+        uint32_t t = tail_.load(std::memory_order_relaxed);
+        if (t == head_.load(std::memory_order_acquire)) return nullptr;
+        return &slots_[t & (N - 1)];
+    }
+
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ── Either side ───────────────────────────
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return N; }
+
+    // Highest fill seen at commit since the last call
+    uint32_t take_peak() { return peak_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    T                     slots_[N]{};
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> drops_{0};
+    std::atomic<uint32_t> peak_{0};
+};
+
+} // namespace ECU
@@ -0,0 +1,89 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  Task Loop Statistics
+//
+//  PeriodicLoop wraps xTaskDelayUntil for the periodic
+//  tasks and records, per TaskId:
+//    - worst |actual wake interval − period| in µs
+//    - deadlines missed (xTaskDelayUntil returned
+//      without blocking because the task overran)
+//
+//  The watchdog reads and resets both once per stats
+//  window (take_*), so they describe the last window
+//  only. Intervals are timed with CLINT mtime, not the
+//  tick count, so sub-tick jitter is visible.
+//
+//  In LOCKSTEP mode (sim_clock.hpp) simulated tasks
+//  park on the virtual clock instead; no stats are
+//  recorded there since wall-clock timing is meaningless.
+// ─────────────────────────────────────────────────────
+#include <atomic>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "../include/ecu_protocol.hpp"
+#include "../include/sim_clock.hpp"
+#include "../hal/hal_timer.hpp"
+
+namespace ECU {
+
+struct LoopStats {
+    std::atomic<uint32_t> worst_jitter_us{0};
+    std::atomic<uint32_t> missed{0};
+
+    void record_jitter(uint32_t us) {
+        uint32_t prev = worst_jitter_us.load(std::memory_order_relaxed);
+        while (us > prev &&
+               !worst_jitter_us.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+    }
+    uint32_t take_jitter() { return worst_jitter_us.exchange(0, std::memory_order_relaxed); }
+    uint32_t take_missed() { return missed.exchange(0, std::memory_order_relaxed); }
+};
+
+inline LoopStats g_loop_stats[static_cast<uint8_t>(TaskId::COUNT)];
+
+class PeriodicLoop {
+public:
+    explicit PeriodicLoop(TaskId id)
+        : id_(id),
+          stats_(g_loop_stats[static_cast<uint8_t>(id)]),
+          last_wake_(xTaskGetTickCount()) {}
+
+    // Blocks until the next period boundary
+    void wait(uint32_t period_ms) {
+        if (clock_mode() == ClockMode::LOCKSTEP && sim_participates(id_)) {
+            sim_park(id_, period_ms);
+            resync_ = true;
+            return;
+        }
+        // Back from LOCKSTEP: restart from now, no catch-up burst
+        if (resync_) {
+            last_wake_      = xTaskGetTickCount();
+            last_period_ms_ = 0;
+            resync_         = false;
+        }
+
+        if (xTaskDelayUntil(&last_wake_, pdMS_TO_TICKS(period_ms)) == pdFALSE) {
+            stats_.missed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint32_t now = HAL::micros();
+        // A period change restarts the measurement
+        if (last_period_ms_ == period_ms) {
+            uint32_t interval = now - last_us_;
+            uint32_t nominal  = period_ms * 1000;
+            stats_.record_jitter(interval > nominal ? interval - nominal : nominal - interval);
+        }
+        last_us_        = now;
+        last_period_ms_ = period_ms;
+    }
+
+private:
+    TaskId     id_;
+    LoopStats& stats_;
+    TickType_t last_wake_;
+    uint32_t   last_us_        = 0;
+    uint32_t   last_period_ms_ = 0;
+    bool       resync_         = false;
+};
+
+} // namespace ECU
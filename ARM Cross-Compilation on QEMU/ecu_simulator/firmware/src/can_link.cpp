@@ -0,0 +1,64 @@
+#include "can_link.hpp"
+#include "ecu_state.hpp"
+#include "sim_clock.hpp"
+#include "../hal/hal_uart.hpp"
+
+namespace ECU {
+
+static SemaphoreHandle_t  s_uart0_mutex = nullptr;
+static volatile uint8_t   s_format      = static_cast<uint8_t>(Wire::Format::LEGACY);
+static uint8_t            s_batch_peak  = 0;   // under s_uart0_mutex
+
+void can_link_init() {
+    s_uart0_mutex = xSemaphoreCreateMutex();
+}
+
+void can_link_set_format(Wire::Format f) {
+    if (f == Wire::Format::LEGACY || f == Wire::Format::COBS_V1) {
+        s_format = static_cast<uint8_t>(f);
+    }
+}
+
+Wire::Format can_link_format() {
+    return static_cast<Wire::Format>(s_format);
+}
+
+uint8_t can_link_take_batch_peak() {
+    xSemaphoreTake(s_uart0_mutex, portMAX_DELAY);
+    uint8_t peak = s_batch_peak;
+    s_batch_peak = 0;
+    xSemaphoreGive(s_uart0_mutex);
+    return peak;
+}
+
+void CANBatch::add(const CANFrame& f) {
+    frames_[count_++] = f;
+    if (count_ >= Wire::MAX_BATCH_FRAMES) flush();
+}
+
+void CANBatch::flush() {
+    if (count_ == 0) return;
+
+    xSemaphoreTake(s_uart0_mutex, portMAX_DELAY);
+    if (count_ > s_batch_peak) s_batch_peak = static_cast<uint8_t>(count_);
+    if (can_link_format() == Wire::Format::COBS_V1) {
+        Wire::BatchEncoder enc;
+        uint8_t out[Wire::MAX_ENCODED];
+        enc.begin(now_ms());
+        for (size_t i = 0; i < count_; i++) {
+            enc.add(frames_[i].id, frames_[i].len, frames_[i].data);
+        }
+        size_t n = enc.finish(out);
+        HAL::uart0.write(out, static_cast<uint32_t>(n));
+    } else {
+        // CANFrame is packed — send as raw bytes
+        for (size_t i = 0; i < count_; i++) {
+            HAL::uart0.write(reinterpret_cast<const uint8_t*>(&frames_[i]), FRAME_SIZE);
+        }
+    }
+    xSemaphoreGive(s_uart0_mutex);
+
+    count_ = 0;
+}
+
+} // namespace ECU
@@ -4,23 +4,21 @@ namespace ECU {
 
 ECUState         g_state{};
 SemaphoreHandle_t g_state_mutex  = nullptr;
-QueueHandle_t    g_sensor_queue  = nullptr;
+SpscRing<SensorBatch, 8> g_sample_ring;
 QueueHandle_t    g_fault_queue   = nullptr;
 QueueHandle_t    g_control_queue = nullptr;
-QueueHandle_t    g_can_tx_queue  = nullptr;
 
 TaskHandle_t     g_task_engine   = nullptr;
 TaskHandle_t     g_task_sensors  = nullptr;
 TaskHandle_t     g_task_can_tx   = nullptr;
 TaskHandle_t     g_task_diag     = nullptr;
 TaskHandle_t     g_task_watchdog = nullptr;
+TaskHandle_t     g_task_uart_rx  = nullptr;
 
 void init() {
     g_state_mutex   = xSemaphoreCreateMutex();
-    g_sensor_queue  = xQueueCreate(8,  sizeof(SensorReading));
-    g_fault_queue   = xQueueCreate(16, sizeof(FaultEvent));
-    g_control_queue = xQueueCreate(8,  sizeof(ControlEvent));
-    g_can_tx_queue  = xQueueCreate(16, sizeof(CANFrame));
+    g_fault_queue   = xQueueCreate(FAULT_QUEUE_DEPTH,   sizeof(FaultEvent));
+    g_control_queue = xQueueCreate(CONTROL_QUEUE_DEPTH, sizeof(ControlEvent));
 
     // Default ECU state: engine off, nominal values
     g_state = ECUState{
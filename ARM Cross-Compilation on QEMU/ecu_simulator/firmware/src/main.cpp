@@ -11,11 +11,17 @@
 //    5. Start FreeRTOS scheduler (never returns)
 // ─────────────────────────────────────────────────────
 #include <cstdio>
+#ifdef ECU_HOST
+#include <cstdlib>
+#include <unistd.h>
+#endif
 
 #include "FreeRTOS.h"
 #include "task.h"
 
 #include "include/ecu_state.hpp"
+#include "include/can_link.hpp"
+#include "include/sim_clock.hpp"
 #include "hal/hal_uart.hpp"
 #include "tasks/task_engine.hpp"
 #include "tasks/task_sensors.hpp"
@@ -23,10 +29,57 @@
 #include "tasks/task_diag.hpp"
 #include "tasks/task_watchdog.hpp"
 
+// ── Simulation clock commands ─────────────────
+// SIM_MODE / SIM_STEP are executed here rather than
+// queued: this task is the lockstep driver. Every
+// command is acknowledged on UART1 with the virtual
+// time, so a scenario runner can wait for the step to
+// finish before sending the next command.
+static void handle_sim_cmd(const ECU::ControlEvent& ev) {
+    bool ok = true;
+    if (ev.cmd == ControlCmd::SIM_MODE) {
+        ok = ECU::sim_set_mode(ev.arg[0] ? ECU::ClockMode::LOCKSTEP
+                                         : ECU::ClockMode::REALTIME);
+    } else {
+        ok = ECU::sim_advance(unpack_u16(ev.arg));
+    }
+
+    char buf[48];
+    snprintf(buf, sizeof(buf), "[SIM] t=%lu%s\r\n",
+             static_cast<unsigned long>(ECU::now_ms()), ok ? "" : " stalled");
+    HAL::uart1.write_str(buf);
+}
+
+static void dispatch_cmd(const ECU::ControlEvent& ev) {
+    switch (ev.cmd) {
+    case ControlCmd::SIM_MODE:
+    case ControlCmd::SIM_STEP:
+        handle_sim_cmd(ev);
+        break;
+    case ControlCmd::DTC_DUMP:
+        ECU::post_diag_request(ECU::DiagRequest::DTC_DUMP);
+        break;
+    case ControlCmd::CLEAR_FAULTS:
+        // Sensors drop the injected faults, Diag the DTC store
+        xQueueSend(ECU::g_control_queue, &ev, 0);
+        ECU::post_diag_request(ECU::DiagRequest::DTC_CLEAR);
+        break;
+    default:
+        xQueueSend(ECU::g_control_queue, &ev, 0);
+        break;
+    }
+}
+
 // ── UART1 control receiver ────────────────────
 // Reads ControlCmd packets from UART1 (TCP bridge)
 // and enqueues them for task_sensors to process.
 static void uart_ctrl_task(void* /*param*/) {
+    // Booted in LOCKSTEP: announce t=0 once every task has parked
+    if (ECU::clock_mode() == ECU::ClockMode::LOCKSTEP) {
+        bool ok = ECU::sim_wait_parked();
+        HAL::uart1.write_str(ok ? "[SIM] t=0\r\n" : "[SIM] t=0 stalled\r\n");
+    }
+
     enum class RxState { IDLE, GOT_CMD };
     RxState  state = RxState::IDLE;
     ECU::ControlEvent ev{};
@@ -37,6 +90,10 @@ static void uart_ctrl_task(void* /*param*/) {
         switch (c) {
         case ControlCmd::SET_THROTTLE:   return 1;
         case ControlCmd::SET_RPM_TARGET: return 2;
+        case ControlCmd::SET_SAMPLE_RATE:return 2;
+        case ControlCmd::SET_WIRE_FORMAT:return 1;
+        case ControlCmd::SIM_MODE:       return 1;
+        case ControlCmd::SIM_STEP:       return 2;
         default:                         return 0;
         }
     };
@@ -55,7 +112,7 @@ static void uart_ctrl_task(void* /*param*/) {
             arg_idx    = 0;
             args_needed = args_for(ev.cmd);
             if (args_needed == 0) {
-                xQueueSend(ECU::g_control_queue, &ev, 0);
+                dispatch_cmd(ev);
             } else {
                 state = RxState::GOT_CMD;
             }
@@ -64,7 +121,7 @@ static void uart_ctrl_task(void* /*param*/) {
         case RxState::GOT_CMD:
             ev.arg[arg_idx++] = b;
             if (arg_idx >= args_needed) {
-                xQueueSend(ECU::g_control_queue, &ev, 0);
+                dispatch_cmd(ev);
                 state = RxState::IDLE;
             }
             break;
@@ -77,8 +134,8 @@ static void uart_ctrl_task(void* /*param*/) {
 constexpr uint32_t STACK_ENGINE   = 512;
 constexpr uint32_t STACK_SENSORS  = 512;
 constexpr uint32_t STACK_CAN_TX   = 512;
-constexpr uint32_t STACK_DIAG     = 512;
-constexpr uint32_t STACK_WATCHDOG = 256;
+constexpr uint32_t STACK_DIAG     = 768;   // DTCStore lives on the task stack
+constexpr uint32_t STACK_WATCHDOG = 512;   // TaskStatus_t snapshot for run-time stats
 constexpr uint32_t STACK_UART_RX  = 256;
 
 // ── Task priorities ───────────────────────────
@@ -90,6 +147,15 @@ constexpr UBaseType_t PRI_CAN_TX   = 2;
 constexpr UBaseType_t PRI_DIAG     = 1;
 constexpr UBaseType_t PRI_UART_RX  = 2;
 
+#ifdef ECU_HOST
+// POSIX port: each task is a pthread and needs more stack
+constexpr uint32_t stack_words(uint32_t w) {
+    return w < configMINIMAL_STACK_SIZE ? configMINIMAL_STACK_SIZE : w;
+}
+#else
+constexpr uint32_t stack_words(uint32_t w) { return w; }
+#endif
+
 extern "C" int main() {
     // 1. Initialise UARTs
     HAL::uart0.init(115200);   // CAN frames
@@ -99,16 +165,23 @@ extern "C" int main() {
 
     // 2. Initialise ECU shared state + queues
     ECU::init();
+    ECU::can_link_init();
 
     HAL::uart1.write_str("[ECU] Queues ready\r\n");
 
     // 3. Create tasks
-    xTaskCreate(Tasks::engine_task_entry,   "Engine",   STACK_ENGINE,   nullptr, PRI_ENGINE,   &ECU::g_task_engine);
-    xTaskCreate(Tasks::sensor_task_entry,   "Sensors",  STACK_SENSORS,  nullptr, PRI_SENSORS,  &ECU::g_task_sensors);
-    xTaskCreate(Tasks::can_tx_task_entry,   "CAN_TX",   STACK_CAN_TX,   nullptr, PRI_CAN_TX,   &ECU::g_task_can_tx);
-    xTaskCreate(Tasks::diag_task_entry,     "Diag",     STACK_DIAG,     nullptr, PRI_DIAG,     &ECU::g_task_diag);
-    xTaskCreate(Tasks::watchdog_task_entry, "Watchdog", STACK_WATCHDOG, nullptr, PRI_WATCHDOG, &ECU::g_task_watchdog);
-    xTaskCreate(uart_ctrl_task,             "UartRx",   STACK_UART_RX,  nullptr, PRI_UART_RX,  nullptr);
+    xTaskCreate(Tasks::engine_task_entry,   "Engine",   stack_words(STACK_ENGINE),   nullptr, PRI_ENGINE,   &ECU::g_task_engine);
+    xTaskCreate(Tasks::sensor_task_entry,   "Sensors",  stack_words(STACK_SENSORS),  nullptr, PRI_SENSORS,  &ECU::g_task_sensors);
+    xTaskCreate(Tasks::can_tx_task_entry,   "CAN_TX",   stack_words(STACK_CAN_TX),   nullptr, PRI_CAN_TX,   &ECU::g_task_can_tx);
+    xTaskCreate(Tasks::diag_task_entry,     "Diag",     stack_words(STACK_DIAG),     nullptr, PRI_DIAG,     &ECU::g_task_diag);
+    xTaskCreate(Tasks::watchdog_task_entry, "Watchdog", stack_words(STACK_WATCHDOG), nullptr, PRI_WATCHDOG, &ECU::g_task_watchdog);
+    xTaskCreate(uart_ctrl_task,             "UartRx",   stack_words(STACK_UART_RX),  nullptr, PRI_UART_RX,  &ECU::g_task_uart_rx);
+
+#ifdef ECU_HOST
+    // Regression harness: start on the virtual clock so the
+    // CAN stream is identical from the very first frame
+    if (getenv("ECU_LOCKSTEP")) ECU::sim_boot_lockstep(ECU::g_task_uart_rx);
+#endif
 
     HAL::uart1.write_str("[ECU] Scheduler starting\r\n");
 
@@ -122,6 +195,9 @@ extern "C" int main() {
 // ── FreeRTOS hooks ────────────────────────────
 extern "C" void vApplicationIdleHook() {
     // Can put processor in WFI here for power saving
+#ifdef ECU_HOST
+    usleep(1000);   // don't spin a host core
+#endif
 }
 
 extern "C" void vApplicationStackOverflowHook(TaskHandle_t /*task*/, char* name) {
@@ -0,0 +1,129 @@
+#include "sim_clock.hpp"
+#include "ecu_state.hpp"
+
+namespace ECU {
+
+namespace {
+
+struct SimSlot {
+    TaskId        id;
+    TaskHandle_t* handle;
+    uint32_t      deadline_ms;
+    bool          parked;        // has parked since LOCKSTEP entry
+};
+
+// Wake order within one virtual instant
+SimSlot s_slots[] = {
+    { TaskId::ENGINE,  &g_task_engine,  0, false },
+    { TaskId::SENSORS, &g_task_sensors, 0, false },
+    { TaskId::CAN_TX,  &g_task_can_tx,  0, false },
+};
+constexpr size_t NUM_SLOTS = sizeof(s_slots) / sizeof(s_slots[0]);
+
+// Real time the driver waits for a task to park before
+// declaring it stalled
+constexpr TickType_t STALL_TICKS = pdMS_TO_TICKS(1000);
+
+volatile ClockMode s_mode   = ClockMode::REALTIME;
+volatile uint32_t  s_sim_ms = 0;
+TaskHandle_t       s_driver = nullptr;
+
+SimSlot* slot_for(TaskId id) {
+    for (auto& s : s_slots) {
+        if (s.id == id) return &s;
+    }
+    return nullptr;
+}
+
+bool wait_parked() {
+    return ulTaskNotifyTakeIndexed(SIM_NOTIFY_INDEX, pdFALSE, STALL_TICKS) != 0;
+}
+
+// Diag is event-driven and lowest priority: let it drain
+// faults posted at this instant so DTC frames land at the
+// same virtual time on every run
+void settle_diag() {
+    while (uxQueueMessagesWaiting(g_fault_queue) != 0 ||
+           (g_task_diag && eTaskGetState(g_task_diag) == eReady)) {
+        vTaskDelay(1);
+    }
+}
+
+} // namespace
+
+ClockMode clock_mode() { return s_mode; }
+
+uint32_t now_ms() {
+    if (s_mode == ClockMode::LOCKSTEP) return s_sim_ms;
+    return static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+bool sim_participates(TaskId id) { return slot_for(id) != nullptr; }
+
+void sim_park(TaskId id, uint32_t period_ms) {
+    SimSlot* s = slot_for(id);
+    if (!s) return;
+
+    s->deadline_ms = (s->parked ? s->deadline_ms : s_sim_ms) + period_ms;
+    s->parked      = true;
+    xTaskNotifyGiveIndexed(s_driver, SIM_NOTIFY_INDEX);
+    ulTaskNotifyTakeIndexed(SIM_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+}
+
+void sim_boot_lockstep(TaskHandle_t driver) {
+    s_driver = driver;
+    s_sim_ms = 0;
+    for (auto& s : s_slots) s.parked = false;
+    s_mode = ClockMode::LOCKSTEP;
+}
+
+bool sim_wait_parked() {
+    for (size_t i = 0; i < NUM_SLOTS; i++) {
+        if (!wait_parked()) {
+            s_mode = ClockMode::REALTIME;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sim_set_mode(ClockMode mode) {
+    if (mode == s_mode) return true;
+
+    if (mode == ClockMode::LOCKSTEP) {
+        // Each task parks at its next real-time deadline
+        sim_boot_lockstep(xTaskGetCurrentTaskHandle());
+        return sim_wait_parked();
+    }
+
+    s_mode = ClockMode::REALTIME;
+    for (auto& s : s_slots) {
+        if (s.parked && *s.handle) xTaskNotifyGiveIndexed(*s.handle, SIM_NOTIFY_INDEX);
+    }
+    return true;
+}
+
+bool sim_advance(uint32_t ms) {
+    if (s_mode != ClockMode::LOCKSTEP) return false;
+
+    const uint32_t target = s_sim_ms + ms;
+    for (;;) {
+        uint32_t next = UINT32_MAX;
+        for (auto& s : s_slots) {
+            if (s.deadline_ms < next) next = s.deadline_ms;
+        }
+        if (next > target) break;
+
+        s_sim_ms = next;
+        for (auto& s : s_slots) {
+            if (s.deadline_ms != next) continue;
+            xTaskNotifyGiveIndexed(*s.handle, SIM_NOTIFY_INDEX);
+            if (!wait_parked()) return false;
+        }
+        settle_diag();
+    }
+    s_sim_ms = target;
+    return true;
+}
+
+} // namespace ECU
@@ -2,12 +2,15 @@
 // ─────────────────────────────────────────────────────
 //  Task 3: CAN Transmitter
 //
-//  Drains the sensor queue, builds CAN frames, and
-//  transmits them over UART0 in the framed wire format.
+//  Drains every SensorBatch committed to the sample ring
+//  in one pass, builds CAN frames, and transmits them
+//  over UART0. All frames of one cycle leave as a single
+//  CANBatch (see can_link.hpp).
 //
 //  Frame schedule (based on real automotive CAN):
-//    0x100 RPM          — every sensor update (100ms)
-//    0x101 Throttle     — every sensor update
+//    0x100 RPM          — every cycle (100ms), latest reading
+//    0x101 Throttle     — every cycle
+//    0x110/0x111        — every sample, high-rate mode only
 //    0x200 Coolant temp — every 500ms
 //    0x201 Fuel level   — every 1000ms
 //    0x202 Battery      — every 1000ms
@@ -20,7 +23,9 @@
 #include "task.h"
 #include "../include/ecu_state.hpp"
 #include "../include/ecu_protocol.hpp"
-#include "../hal/hal_uart.hpp"
+#include "../include/can_link.hpp"
+#include "../include/task_stats.hpp"
+#include "task_watchdog.hpp"
 
 namespace Tasks {
 
@@ -34,18 +39,31 @@ public:
 private:
     uint32_t tick_count_     = 0;
     uint8_t  last_faults_    = 0xFF;  // Force initial fault frame
+    ECU::CANBatch batch_;
+
+    ECU::SensorReading latest_{};
+    bool               have_reading_ = false;
+
+    ECU::PeriodicLoop period_{TaskId::CAN_TX};
 
     void loop() {
-        TickType_t last_wake = xTaskGetTickCount();
         for (;;) {
-            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(100));
+            period_.wait(100);
+            watchdog_checkin(WatchID::CAN_TX);
             ++tick_count_;
 
-            ECU::SensorReading r{};
-            // Block briefly for a reading; skip cycle if none ready
-            if (xQueueReceive(ECU::g_sensor_queue, &r, pdMS_TO_TICKS(10)) != pdTRUE) {
-                continue;
+            // Drain everything T2 committed since last cycle
+            while (const ECU::SensorBatch* b = ECU::g_sample_ring.front()) {
+                if (b->streamed) send_samples(*b);
+                if (b->count) {
+                    latest_       = b->readings[b->count - 1];
+                    have_reading_ = true;
+                }
+                ECU::g_sample_ring.pop();
             }
+            // Nothing sampled yet since boot
+            if (!have_reading_) continue;
+            const ECU::SensorReading& r = latest_;
 
             // Always send RPM + throttle
             send_rpm(r);
@@ -66,6 +84,8 @@ private:
                 send_fault(s.active_faults);
                 last_faults_ = s.active_faults;
             }
+
+            batch_.flush();
         }
     }
 
@@ -124,6 +144,34 @@ private:
         transmit(f);
     }
 
+    void send_samples(const ECU::SensorBatch& b) {
+        CANFrame h{};
+        h.sof = FRAME_SOF;
+        h.id  = CAN_ID_SAMPLE_HDR;
+        h.len = 8;
+        pack_u32(h.data, b.t0_ms);
+        pack_u16(h.data + 4, b.seq);
+        h.data[6] = b.count;
+        h.data[7] = b.period_ms;
+        h.eof = FRAME_EOF;
+        transmit(h);
+
+        for (uint8_t i = 0; i < b.count; i++) {
+            const ECU::SensorReading& r = b.readings[i];
+            CANFrame f{};
+            f.sof     = FRAME_SOF;
+            f.id      = CAN_ID_SAMPLE;
+            f.len     = 8;
+            f.data[0] = b.dt_ms[i];
+            pack_u16(f.data + 1, r.rpm);
+            f.data[3] = r.throttle_pct;
+            pack_u16(f.data + 4, static_cast<uint16_t>(static_cast<int16_t>(r.coolant_temp_c * 10)));
+            pack_u16(f.data + 6, r.battery_mv);
+            f.eof     = FRAME_EOF;
+            transmit(f);
+        }
+    }
+
     void send_fault(uint8_t fault_mask) {
         ECUState s = ECU::state_read();
         CANFrame f{};
@@ -138,8 +186,7 @@ private:
 
     // ── Wire transmit ─────────────────────────
     void transmit(const CANFrame& f) {
-        // CANFrame is packed — send as raw bytes
-        HAL::uart0.write(reinterpret_cast<const uint8_t*>(&f), FRAME_SIZE);
+        batch_.add(f);
     }
 };
 
@@ -3,8 +3,10 @@
 //  Task 4: Diagnostics
 //
 //  Receives FaultEvents from the fault queue.
-//  Maintains a DTC (Diagnostic Trouble Code) log.
-//  Sends DTC frames over UART0 (CAN 0x7E8).
+//  Keeps DTCs in an ECU::DTCStore with freeze frames
+//  (see dtc_store.hpp) and ages them out.
+//  Sends DTC frames over UART0 (CAN 0x7E8), and the
+//  whole store as a bulk dump (0x7E9/0x7EA) on request.
 //  Also sends a human-readable debug line over UART1.
 //
 //  DTC mapping:
@@ -20,21 +22,14 @@
 #include "task.h"
 #include "../include/ecu_state.hpp"
 #include "../include/ecu_protocol.hpp"
+#include "../include/can_link.hpp"
+#include "../include/dtc_store.hpp"
 #include "../hal/hal_uart.hpp"
+#include "task_watchdog.hpp"
 #include <cstdio>
-#include <cstring>
 
 namespace Tasks {
 
-struct DTC {
-    uint16_t code;        // e.g. 0x0217 for P0217
-    char     label[24];
-    uint32_t first_seen_ms;
-    uint32_t last_seen_ms;
-    uint8_t  count;
-    bool     active;
-};
-
 class DiagTask {
 public:
     static void run(void* /*param*/) {
@@ -43,17 +38,22 @@ public:
     }
 
 private:
-    static constexpr size_t MAX_DTCS = 8;
-    DTC dtc_log_[MAX_DTCS]{};
-    size_t dtc_count_ = 0;
+    ECU::DTCStore store_;
 
     void loop() {
         ECU::FaultEvent ev{};
         for (;;) {
             // Block until a fault event arrives (up to 500ms, then heartbeat)
-            if (xQueueReceive(ECU::g_fault_queue, &ev, pdMS_TO_TICKS(500)) == pdTRUE) {
-                process_fault(ev);
+            const bool got = xQueueReceive(ECU::g_fault_queue, &ev, pdMS_TO_TICKS(500)) == pdTRUE;
+            store_.age(ECU::now_ms());
+            if (got) {
+                if (ev.code == FaultCode::NONE) {
+                    process_request(static_cast<ECU::DiagRequest>(ev.context));
+                } else {
+                    process_fault(ev);
+                }
             }
+            watchdog_checkin(WatchID::DIAG);
             // Heartbeat DTC summary on UART1 every ~500ms
             send_summary();
         }
@@ -63,14 +63,10 @@ private:
         uint16_t dtc_code = fault_to_dtc(ev.code);
         const char* label = fault_label(ev.code);
 
-        // Find existing DTC or create new entry
-        DTC* entry = find_or_create(dtc_code, label);
-        if (!entry) return;  // log full
-
-        entry->last_seen_ms = ev.timestamp_ms;
-        entry->active = true;
-        entry->count++;
-        if (entry->first_seen_ms == 0) entry->first_seen_ms = ev.timestamp_ms;
+        ECUState s = ECU::state_read();
+        ECU::FreezeFrame snap{ev.timestamp_ms, s.rpm, s.coolant_temp_c, s.battery_mv};
+        const ECU::DTCEntry* entry = store_.record(dtc_code, ev.timestamp_ms, snap);
+        if (!entry) return;  // store full of active codes — see dropped()
 
         // Emit DTC CAN frame
         send_dtc_frame(dtc_code, entry->count);
@@ -82,10 +78,23 @@ private:
         HAL::uart1.write_str(buf);
     }
 
+    void process_request(ECU::DiagRequest req) {
+        switch (req) {
+        case ECU::DiagRequest::DTC_DUMP:
+            send_dump();
+            break;
+        case ECU::DiagRequest::DTC_CLEAR:
+            store_.clear();
+            HAL::uart1.write_str("[DIAG] DTC store cleared\r\n");
+            break;
+        }
+    }
+
     void send_summary() {
         char buf[80];
-        snprintf(buf, sizeof(buf), "[DIAG] DTCs active=%u total=%u\r\n",
-                 active_count(), static_cast<unsigned>(dtc_count_));
+        snprintf(buf, sizeof(buf), "[DIAG] DTCs active=%u total=%u dropped=%u\r\n",
+                 store_.active_count(), static_cast<unsigned>(store_.size()),
+                 static_cast<unsigned>(store_.dropped()));
         HAL::uart1.write_str(buf);
     }
 
@@ -98,11 +107,65 @@ private:
         f.data[2] = count;
         f.data[3] = 0x01;  // confirmed fault
         f.eof    = FRAME_EOF;
-        HAL::uart0.write(reinterpret_cast<const uint8_t*>(&f), FRAME_SIZE);
+        ECU::CANBatch batch;
+        batch.add(f);
+        batch.flush();
+    }
+
+    // ── Bulk dump ─────────────────────────────
+    // One batch for the whole store: at most
+    // MAX_ENTRIES × (1 + FREEZE_FRAMES) frames.
+    void send_dump() {
+        const uint32_t now   = ECU::now_ms();
+        const uint8_t  total = static_cast<uint8_t>(store_.size());
+        uint8_t        index = 0;
+        ECU::CANBatch  batch;
+
+        if (total == 0) {
+            batch.add(dump_frame(CAN_ID_DTC_RECORD));
+        }
+        store_.for_each([&](const ECU::DTCEntry& e) {
+            CANFrame r = dump_frame(CAN_ID_DTC_RECORD);
+            pack_u16(r.data, e.code);
+            r.data[2] = e.active ? 0x09 : 0x08;   // bit0 active, bit3 confirmed
+            r.data[3] = e.count;
+            r.data[4] = e.ff_count;
+            r.data[5] = index++;
+            r.data[6] = total;
+            r.data[7] = saturate_u8((now - e.last_seen_ms) / 1000);
+            batch.add(r);
+
+            for (size_t i = 0; i < e.ff_count; i++) {
+                const ECU::FreezeFrame& ff = e.freeze_frame(i);
+                CANFrame f = dump_frame(CAN_ID_DTC_FREEZE);
+                pack_u16(f.data,     ff.rpm);
+                pack_u16(f.data + 2, static_cast<uint16_t>(ff.coolant_temp_c));
+                pack_u16(f.data + 4, ff.battery_mv);
+                pack_u16(f.data + 6, saturate_u16((now - ff.t_ms) / 100));
+                batch.add(f);
+            }
+        });
+        batch.flush();
+
+        char buf[48];
+        snprintf(buf, sizeof(buf), "[DIAG] DTC dump: %u codes\r\n", static_cast<unsigned>(total));
+        HAL::uart1.write_str(buf);
     }
 
     // ── Helpers ───────────────────────────────
 
+    static CANFrame dump_frame(uint32_t id) {
+        CANFrame f{};
+        f.sof = FRAME_SOF;
+        f.id  = static_cast<uint16_t>(id);
+        f.len = 8;
+        f.eof = FRAME_EOF;
+        return f;
+    }
+
+    static uint8_t  saturate_u8(uint32_t v)  { return v > UINT8_MAX  ? UINT8_MAX  : static_cast<uint8_t>(v); }
+    static uint16_t saturate_u16(uint32_t v) { return v > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(v); }
+
     static uint16_t fault_to_dtc(FaultCode c) {
         switch (c) {
         case FaultCode::OVERHEAT:     return 0x0217;
@@ -122,26 +185,6 @@ private:
         default:                        return "unknown";
         }
     }
-
-    DTC* find_or_create(uint16_t code, const char* label) {
-        for (size_t i = 0; i < dtc_count_; i++) {
-            if (dtc_log_[i].code == code) return &dtc_log_[i];
-        }
-        if (dtc_count_ >= MAX_DTCS) return nullptr;
-        DTC& d = dtc_log_[dtc_count_++];
-        d.code  = code;
-        d.count = 0;
-        d.first_seen_ms = 0;
-        d.active = false;
-        strncpy(d.label, label, sizeof(d.label) - 1);
-        return &d;
-    }
-
-    unsigned active_count() const {
-        unsigned n = 0;
-        for (size_t i = 0; i < dtc_count_; i++) n += dtc_log_[i].active ? 1 : 0;
-        return n;
-    }
 };
 
 inline void diag_task_entry(void* p) { DiagTask::run(p); }
@@ -16,6 +16,8 @@
 #include "task.h"
 #include "../include/ecu_state.hpp"
 #include "../include/ecu_protocol.hpp"
+#include "../include/task_stats.hpp"
+#include "task_watchdog.hpp"
 
 namespace Tasks {
 
@@ -46,10 +48,12 @@ private:
     static constexpr uint16_t RAMP_DOWN  = 200;
     static constexpr uint16_t CRANK_TIME = 20;   // ticks @ 50ms = 1 second
 
+    ECU::PeriodicLoop period_{TaskId::ENGINE};
+
     void loop() {
-        TickType_t last_wake = xTaskGetTickCount();
         for (;;) {
-            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(50));
+            period_.wait(50);
+            watchdog_checkin(WatchID::ENGINE);
 
             ECUState s = ECU::state_read();
             tick(s);
@@ -12,13 +12,26 @@
 //    INJECT_SENSOR_DISC→ mark sensor as disconnected
 //    INJECT_VOLT_DROP  → force battery_mv < 10500
 //
-//  Period: 100 ms  (10 Hz)
+//  Sampling rate (SET_SAMPLE_RATE):
+//    0          → 10 Hz, latest reading only (default)
+//    10–1000 Hz → every sample streamed as CAN 0x110/0x111
+//  Readings are written into SensorBatch slots of
+//  g_sample_ring; a batch is committed when full or
+//  when it spans one CAN TX cycle (100 ms).
+//  Physics is scaled by the period, so the simulated
+//  plant behaves the same at any rate. Faults are
+//  re-posted at most every 100 ms.
+//
+//  Period: 100 ms default, 1–100 ms configurable
 //  Priority: 3
 // ─────────────────────────────────────────────────────
 #include "FreeRTOS.h"
 #include "task.h"
 #include "../include/ecu_state.hpp"
 #include "../include/ecu_protocol.hpp"
+#include "../include/can_link.hpp"
+#include "../include/task_stats.hpp"
+#include "task_watchdog.hpp"
 
 namespace Tasks {
 
@@ -39,13 +52,34 @@ private:
     bool  fault_sensor_disc_= false;
     bool  fault_volt_drop_  = false;
 
+    static constexpr uint16_t BASE_PERIOD_MS  = 100;   // physics constants are per 100 ms
+    static constexpr uint16_t MIN_RATE_HZ     = 10;
+    static constexpr uint16_t MAX_RATE_HZ     = 1000;
+
+    uint16_t period_ms_   = BASE_PERIOD_MS;
+    bool     streamed_    = false;
+    uint16_t report_ms_   = 0;      // time since faults were last posted
+
+    // Batch currently being filled (owned until commit)
+    ECU::SensorBatch* batch_   = nullptr;
+    uint32_t          last_ms_ = 0;
+    uint16_t          seq_     = 0;
+    bool              dropping_= false;
+
+    ECU::PeriodicLoop period_{TaskId::SENSORS};
+
     void loop() {
-        TickType_t last_wake = xTaskGetTickCount();
         for (;;) {
-            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(100));
+            period_.wait(period_ms_);
+            watchdog_checkin(WatchID::SENSORS);
             process_commands();
             simulate();
-            check_thresholds();
+
+            report_ms_ += period_ms_;
+            bool report = report_ms_ >= BASE_PERIOD_MS;
+            if (report) report_ms_ = 0;
+            check_thresholds(report);
+
             publish();
         }
     }
@@ -76,56 +110,81 @@ private:
                 ECU::state_update([pct](ECUState& s){ s.throttle_pct = pct; });
                 break;
             }
+            case ControlCmd::SET_SAMPLE_RATE:
+                set_rate(unpack_u16(ev.arg));
+                break;
+            case ControlCmd::SET_WIRE_FORMAT:
+                ECU::can_link_set_format(static_cast<Wire::Format>(ev.arg[0]));
+                break;
             default: break;
             }
         }
     }
 
+    // 0 → default rate, otherwise clamp to MIN..MAX Hz
+    void set_rate(uint16_t hz) {
+        uint16_t period = BASE_PERIOD_MS;
+        bool     stream = false;
+        if (hz != 0) {
+            if (hz < MIN_RATE_HZ) hz = MIN_RATE_HZ;
+            if (hz > MAX_RATE_HZ) hz = MAX_RATE_HZ;
+            period = static_cast<uint16_t>(1000 / hz);
+            stream = true;
+        }
+        // Each batch has a single period — close the current one
+        commit_batch();
+        period_ms_ = period;
+        streamed_  = stream;
+    }
+
     void simulate() {
         ECUState s = ECU::state_read();
         float rpm_norm = s.rpm / 8000.0f;  // 0..1
+        float k        = static_cast<float>(period_ms_) / BASE_PERIOD_MS;
 
         // ── Coolant temperature ──────────────────
         if (fault_overheat_) {
-            coolant_f_ = coolant_f_ < 125.0f ? coolant_f_ + 2.0f : 130.0f;
+            coolant_f_ = coolant_f_ < 125.0f ? coolant_f_ + 2.0f * k : 130.0f;
         } else {
             // Rises proportional to RPM, cools toward ambient (20°C)
             float target = 20.0f + rpm_norm * 85.0f;  // max 105°C at WOT
-            coolant_f_ += (target - coolant_f_) * 0.03f;
+            coolant_f_ += (target - coolant_f_) * 0.03f * k;
         }
 
         // ── Fuel level ───────────────────────────
         if (!fault_sensor_disc_) {
-            // Drain: 0.005% per tick per 1000 RPM
-            fuel_f_ -= rpm_norm * 0.005f;
+            // Drain: 0.005% per 100 ms per 1000 RPM
+            fuel_f_ -= rpm_norm * 0.005f * k;
             if (fuel_f_ < 0.0f) fuel_f_ = 0.0f;
         }
 
         // ── Battery voltage ──────────────────────
         if (fault_volt_drop_) {
-            battery_f_ = battery_f_ > 9500.f ? battery_f_ - 50.f : 9000.f;
+            battery_f_ = battery_f_ > 9500.f ? battery_f_ - 50.f * k : 9000.f;
         } else {
             // Sags slightly under load, recovers at idle
             float target = 12600.f - rpm_norm * 300.f;
-            battery_f_ += (target - battery_f_) * 0.05f;
+            battery_f_ += (target - battery_f_) * 0.05f * k;
         }
     }
 
-    void check_thresholds() {
+    // Faults are only posted when report is set, so the
+    // fault queue sees 10 Hz regardless of sampling rate
+    void check_thresholds(bool report) {
         ECUState s = ECU::state_read();
         uint8_t new_faults = s.active_faults;
 
         if (coolant_f_ > 120.0f) {
             new_faults |= static_cast<uint8_t>(FaultCode::OVERHEAT);
-            ECU::post_fault(FaultCode::OVERHEAT, static_cast<uint8_t>(coolant_f_));
+            if (report) ECU::post_fault(FaultCode::OVERHEAT, static_cast<uint8_t>(coolant_f_));
         }
         if (fault_sensor_disc_) {
             new_faults |= static_cast<uint8_t>(FaultCode::SENSOR_DISC);
-            ECU::post_fault(FaultCode::SENSOR_DISC);
+            if (report) ECU::post_fault(FaultCode::SENSOR_DISC);
         }
         if (battery_f_ < 10500.f) {
             new_faults |= static_cast<uint8_t>(FaultCode::VOLTAGE_DROP);
-            ECU::post_fault(FaultCode::VOLTAGE_DROP, static_cast<uint8_t>(battery_f_ / 100));
+            if (report) ECU::post_fault(FaultCode::VOLTAGE_DROP, static_cast<uint8_t>(battery_f_ / 100));
         }
 
         ECU::state_update([&](ECUState& st) {
@@ -139,14 +198,50 @@ private:
     void publish() {
         ECUState s = ECU::state_read();
         ECU::SensorReading r{};
-        r.timestamp_ms   = xTaskGetTickCount() * portTICK_PERIOD_MS;
         r.rpm            = s.rpm;
         r.throttle_pct   = s.throttle_pct;
         r.coolant_temp_c = s.coolant_temp_c;
         r.fuel_level_pct = fault_sensor_disc_ ? 0xFF : s.fuel_level_pct;
         r.battery_mv     = s.battery_mv;
-        // Non-blocking send — CAN TX task drains this
-        xQueueSend(ECU::g_sensor_queue, &r, 0);
+        record(r, ECU::now_ms());
+    }
+
+    // ── Sample ring (producer side) ───────────
+    void record(const ECU::SensorReading& r, uint32_t now_ms) {
+        if (!batch_) {
+            batch_ = ECU::g_sample_ring.acquire();
+            if (!batch_) {
+                // CAN TX is a full ring behind — drop, and skip a
+                // sequence number once so the receiver sees the gap
+                if (!dropping_) ++seq_;
+                dropping_ = true;
+                ECU::g_sample_ring.note_drop();
+                return;
+            }
+            dropping_          = false;
+            batch_->t0_ms      = now_ms;
+            batch_->seq        = seq_++;
+            batch_->count      = 0;
+            batch_->period_ms  = static_cast<uint8_t>(period_ms_);
+            batch_->streamed   = streamed_;
+        }
+
+        uint8_t i = batch_->count++;
+        batch_->dt_ms[i]    = i ? static_cast<uint8_t>(now_ms - last_ms_) : 0;
+        batch_->readings[i] = r;
+        last_ms_ = now_ms;
+
+        // Commit when full or before the batch outgrows one TX cycle
+        if (batch_->count >= ECU::SensorBatch::CAPACITY ||
+            now_ms - batch_->t0_ms + period_ms_ >= BASE_PERIOD_MS) {
+            commit_batch();
+        }
+    }
+
+    void commit_batch() {
+        if (!batch_) return;
+        ECU::g_sample_ring.commit();
+        batch_ = nullptr;
     }
 };
 
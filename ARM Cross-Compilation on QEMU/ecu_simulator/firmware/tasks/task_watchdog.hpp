@@ -14,6 +14,16 @@
 //  Pattern: software watchdog inside FreeRTOS.
 //  For production you would also kick a hardware WDT.
 //
+//  Supervision and stats pause in LOCKSTEP mode, where
+//  simulated tasks only run when the virtual clock is
+//  stepped (sim_clock.hpp).
+//
+//  Every second it also publishes run-time stats:
+//    0x7F0 per task — CPU %, stack high-water mark,
+//          worst period jitter, missed deadlines
+//    0x7F1 — sample ring / fault queue fill, peak CAN
+//          TX batch
+//
 //  Period: 500 ms
 //  Priority: 4  (highest — must always run)
 // ─────────────────────────────────────────────────────
@@ -21,12 +31,14 @@
 #include "task.h"
 #include "../include/ecu_state.hpp"
 #include "../include/ecu_protocol.hpp"
+#include "../include/can_link.hpp"
+#include "../include/task_stats.hpp"
 #include "../hal/hal_uart.hpp"
 #include <cstdio>
 
 namespace Tasks {
 
-// Task IDs supervised by the watchdog
+// Task IDs supervised by the watchdog (values match TaskId)
 enum class WatchID : uint8_t {
     ENGINE  = 0,
     SENSORS = 1,
@@ -64,11 +76,32 @@ private:
         &ECU::g_task_can_tx, &ECU::g_task_diag,
     };
 
+    // ── Run-time stats ────────────────────────
+    static constexpr uint8_t     STATS_EVERY = 2;    // cycles → 1 s window
+    static constexpr UBaseType_t MAX_TASKS   = 8;
+    static constexpr uint8_t     NUM_STATS   = static_cast<uint8_t>(TaskId::COUNT);
+
+    ECU::PeriodicLoop period_{TaskId::WATCHDOG};
+    uint8_t           cycle_ = 0;
+    TaskStatus_t      status_[MAX_TASKS]{};
+    uint32_t          last_runtime_[NUM_STATS] = {};
+    uint32_t          last_total_  = 0;
+    uint32_t          last_drops_  = 0;
+
     void loop() {
-        TickType_t last_wake = xTaskGetTickCount();
         for (;;) {
-            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(500));
+            period_.wait(500);
+            if (ECU::clock_mode() == ECU::ClockMode::LOCKSTEP) {
+                // Parked tasks don't check in; start afresh on return
+                for (auto& m : missed_) m = 0;
+                cycle_ = 0;
+                continue;
+            }
             check_all();
+            if (++cycle_ >= STATS_EVERY) {
+                cycle_ = 0;
+                report_stats();
+            }
         }
     }
 
@@ -104,6 +137,75 @@ private:
 
         missed_[idx] = 0;  // reset so we don't flood
     }
+
+    static TaskHandle_t stats_handle(uint8_t id) {
+        switch (static_cast<TaskId>(id)) {
+        case TaskId::ENGINE:   return ECU::g_task_engine;
+        case TaskId::SENSORS:  return ECU::g_task_sensors;
+        case TaskId::CAN_TX:   return ECU::g_task_can_tx;
+        case TaskId::DIAG:     return ECU::g_task_diag;
+        case TaskId::WATCHDOG: return ECU::g_task_watchdog;
+        case TaskId::UART_RX:  return ECU::g_task_uart_rx;
+        case TaskId::IDLE:     return xTaskGetIdleTaskHandle();
+        default:               return nullptr;
+        }
+    }
+
+    static uint8_t sat_u8(uint32_t v)   { return v > 0xFF   ? 0xFF   : static_cast<uint8_t>(v); }
+    static uint16_t sat_u16(uint32_t v) { return v > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(v); }
+
+    void report_stats() {
+        configRUN_TIME_COUNTER_TYPE total = 0;
+        UBaseType_t n      = uxTaskGetSystemState(status_, MAX_TASKS, &total);
+        uint32_t    window = total - last_total_;
+        last_total_ = total;
+
+        ECU::CANBatch batch;
+        for (uint8_t id = 0; id < NUM_STATS; id++) {
+            TaskHandle_t h = stats_handle(id);
+            const TaskStatus_t* ts = nullptr;
+            for (UBaseType_t i = 0; i < n && h; i++) {
+                if (status_[i].xHandle == h) { ts = &status_[i]; break; }
+            }
+            if (!ts) continue;
+
+            uint32_t run = ts->ulRunTimeCounter - last_runtime_[id];
+            last_runtime_[id] = ts->ulRunTimeCounter;
+            uint32_t cpu = window ? static_cast<uint32_t>(static_cast<uint64_t>(run) * 100 / window) : 0;
+
+            ECU::LoopStats& ls = ECU::g_loop_stats[id];
+            CANFrame f{};
+            f.sof     = FRAME_SOF;
+            f.id      = CAN_ID_TASK_STATS;
+            f.len     = 8;
+            f.data[0] = id;
+            f.data[1] = sat_u8(cpu > 100 ? 100 : cpu);
+            pack_u16(f.data + 2, sat_u16(ts->usStackHighWaterMark));
+            pack_u16(f.data + 4, sat_u16(ls.take_jitter()));
+            f.data[6] = sat_u8(ls.take_missed());
+            f.eof     = FRAME_EOF;
+            batch.add(f);
+        }
+
+        uint32_t drops = ECU::g_sample_ring.drops();
+        CANFrame q{};
+        q.sof     = FRAME_SOF;
+        q.id      = CAN_ID_QUEUE_STATS;
+        q.len     = 8;
+        q.data[0] = static_cast<uint8_t>(ECU::g_sample_ring.size());
+        q.data[1] = static_cast<uint8_t>(ECU::g_sample_ring.capacity());
+        q.data[2] = sat_u8(ECU::g_sample_ring.take_peak());
+        q.data[3] = sat_u8(drops - last_drops_);
+        q.data[4] = static_cast<uint8_t>(uxQueueMessagesWaiting(ECU::g_fault_queue));
+        q.data[5] = static_cast<uint8_t>(ECU::FAULT_QUEUE_DEPTH);
+        q.data[6] = ECU::can_link_take_batch_peak();
+        q.data[7] = static_cast<uint8_t>(Wire::MAX_BATCH_FRAMES);
+        q.eof     = FRAME_EOF;
+        last_drops_ = drops;
+        batch.add(q);
+
+        batch.flush();
+    }
 };
 
 inline void watchdog_task_entry(void* p) { WatchdogTask::run(p); }
@@ -0,0 +1,299 @@
+// ─────────────────────────────────────────────────────
+//  CAN ingest benchmark
+//
+//  Replays a CAN stream through the CAN worker's ingest
+//  path: one FrameScanner::feed() per serial read, each
+//  read holding what a 1 Mbit/s link delivers in one
+//  poll interval, then FrameDecoder::decode() into the
+//  decoded-frame ring, drained after every read.
+//
+//  The stream comes from recorded traces (t_ms,can_id,data
+//  CSV written by run_scenario.py / can_harness.py) or,
+//  without arguments, from a synthetic 10 Hz + sample-
+//  stream mix. It is encoded in the chosen wire format
+//  and repeated until it covers --seconds of link time.
+//
+//  Reports frames/s through scan + decode, CPU use at
+//  the link rate (CPU seconds per second of wire data)
+//  and heap allocations per frame once the reusable
+//  buffers are sized. On glibc malloc is interposed to
+//  count them; anything above zero fails the run.
+//
+//  Build:  cmake -DECU_BUILD_BENCH=ON … → frame_ingest_bench
+//  Usage:  frame_ingest_bench [--format legacy|cobs]
+//              [--seconds N] [--read-ms N] [trace.csv ...]
+// ─────────────────────────────────────────────────────
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "FrameScanner.hpp"
+#include "FrameDecoder.hpp"
+#include "spsc_ring.hpp"
+
+// ── Allocation counter ─────────────────────────────────
+// Counts every malloc/calloc/realloc while enabled; new,
+// QString and QVector all end up here.
+
+namespace {
+std::atomic<bool>   g_count_allocs{false};
+std::atomic<size_t> g_allocs{0};
+
+inline void noteAlloc() {
+    if (g_count_allocs.load(std::memory_order_relaxed))
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace
+
+#if defined(__GLIBC__)
+#define BENCH_COUNTS_ALLOCS 1
+extern "C" {
+void* __libc_malloc(size_t n);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t n);
+
+void* malloc(size_t n)                 { noteAlloc(); return __libc_malloc(n); }
+void* calloc(size_t n, size_t size)    { noteAlloc(); return __libc_calloc(n, size); }
+void* realloc(void* p, size_t n)       { noteAlloc(); return __libc_realloc(p, n); }
+}
+#else
+#define BENCH_COUNTS_ALLOCS 0
+#endif
+
+namespace {
+
+constexpr double LINK_BPS      = 1'000'000.0;
+constexpr double BYTES_PER_SEC = LINK_BPS / 10.0;   // 8N1: 10 bits per byte
+
+// Same depth as the GUI's DecodedFrameRing
+using Ring = ECU::SpscRing<DecodedFrame, 8192>;
+Ring g_ring;
+volatile double g_sink;   // keeps the drain from being optimised out
+
+struct Options {
+    Wire::Format format  = Wire::Format::LEGACY;
+    double       seconds = 60.0;
+    double       read_ms = 1.0;
+    std::vector<std::string> traces;
+};
+
+struct TraceFrame {
+    uint32_t t_ms;
+    CANFrame frame;
+};
+
+bool parseTraceLine(const std::string& line, TraceFrame& tf) {
+    unsigned long t = 0;
+    unsigned int  id = 0;
+    char hex[17] = {};
+    if (sscanf(line.c_str(), "%lu,0x%x,%16[0-9A-Fa-f]", &t, &id, hex) < 2) return false;
+
+    tf = TraceFrame{};
+    tf.t_ms      = static_cast<uint32_t>(t);
+    tf.frame.sof = FRAME_SOF;
+    tf.frame.id  = static_cast<uint16_t>(id);
+    tf.frame.len = static_cast<uint8_t>(strlen(hex) / 2);
+    for (uint8_t i = 0; i < tf.frame.len; ++i) {
+        unsigned b = 0;
+        sscanf(hex + 2 * i, "%2x", &b);
+        tf.frame.data[i] = static_cast<uint8_t>(b);
+    }
+    tf.frame.eof = FRAME_EOF;
+    return true;
+}
+
+std::vector<TraceFrame> loadTrace(const std::string& path) {
+    std::vector<TraceFrame> out;
+    std::ifstream in(path);
+    std::string line;
+    TraceFrame tf;
+    while (std::getline(in, line)) {
+        if (parseTraceLine(line, tf)) out.push_back(tf);
+    }
+    return out;
+}
+
+// 1 s of 10 Hz telemetry plus a 1 kHz sample stream
+std::vector<TraceFrame> syntheticTrace() {
+    std::vector<TraceFrame> out;
+    auto add = [&out](uint32_t t, uint16_t id, uint8_t len) {
+        TraceFrame tf{};
+        tf.t_ms      = t;
+        tf.frame.sof = FRAME_SOF;
+        tf.frame.id  = id;
+        tf.frame.len = len;
+        for (uint8_t i = 0; i < len; ++i) tf.frame.data[i] = static_cast<uint8_t>(t * 7 + i);
+        tf.frame.eof = FRAME_EOF;
+        out.push_back(tf);
+    };
+    for (uint32_t t = 0; t < 1000; t += 100) {
+        add(t, CAN_ID_RPM, 2);
+        add(t, CAN_ID_THROTTLE, 1);
+        add(t, CAN_ID_COOLANT_TEMP, 2);
+        add(t, CAN_ID_SAMPLE_HDR, 8);
+        for (uint32_t k = 0; k < 100; ++k) add(t + k, CAN_ID_SAMPLE, 8);
+    }
+    return out;
+}
+
+// Frames sharing a timestamp go into one COBS batch, as CANBatch does
+std::vector<uint8_t> encode(const std::vector<TraceFrame>& trace, Wire::Format fmt) {
+    std::vector<uint8_t> wire;
+    if (fmt == Wire::Format::LEGACY) {
+        for (const auto& tf : trace) {
+            const CANFrame& f = tf.frame;
+            uint8_t raw[FRAME_SIZE] = {f.sof, static_cast<uint8_t>(f.id >> 8),
+                                       static_cast<uint8_t>(f.id & 0xFF), f.len};
+            memcpy(raw + 4, f.data, 8);
+            raw[12] = f.eof;
+            wire.insert(wire.end(), raw, raw + FRAME_SIZE);
+        }
+        return wire;
+    }
+
+    Wire::BatchEncoder enc;
+    uint8_t out[Wire::MAX_ENCODED];
+    auto flush = [&] {
+        if (enc.count() == 0) return;
+        size_t n = enc.finish(out);
+        wire.insert(wire.end(), out, out + n);
+    };
+    for (size_t i = 0; i < trace.size(); ++i) {
+        if (i == 0 || trace[i].t_ms != trace[i - 1].t_ms || enc.full()) {
+            flush();
+            enc.begin(trace[i].t_ms);
+        }
+        enc.add(trace[i].frame.id, trace[i].frame.len, trace[i].frame.data);
+    }
+    flush();
+    return wire;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val  = i + 1 < argc;
+        if (a == "--format" && has_val) {
+            std::string v = argv[++i];
+            if (v == "legacy")     opt.format = Wire::Format::LEGACY;
+            else if (v == "cobs")  opt.format = Wire::Format::COBS_V1;
+            else return false;
+        } else if (a == "--seconds" && has_val) {
+            opt.seconds = atof(argv[++i]);
+        } else if (a == "--read-ms" && has_val) {
+            opt.read_ms = atof(argv[++i]);
+        } else if (!a.empty() && a[0] == '-') {
+            return false;
+        } else {
+            opt.traces.push_back(a);
+        }
+    }
+    return opt.seconds > 0 && opt.read_ms > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--format legacy|cobs] [--seconds N] [--read-ms N] [trace.csv ...]\n",
+                argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceFrame> trace;
+    for (const auto& path : opt.traces) {
+        auto t = loadTrace(path);
+        if (t.empty()) {
+            fprintf(stderr, "%s: no frames\n", path.c_str());
+            return 1;
+        }
+        trace.insert(trace.end(), t.begin(), t.end());
+    }
+    if (trace.empty()) trace = syntheticTrace();
+
+    const std::vector<uint8_t> unit = encode(trace, opt.format);
+    const size_t total = static_cast<size_t>(opt.seconds * BYTES_PER_SEC);
+    const size_t chunk = static_cast<size_t>(opt.read_ms / 1000.0 * BYTES_PER_SEC) + 1;
+
+    std::vector<uint8_t> stream;
+    stream.reserve(total + unit.size());
+    while (stream.size() < total) stream.insert(stream.end(), unit.begin(), unit.end());
+    stream.resize(total);
+
+    // Reads are copied into a reused buffer as QSerialPort::read() does,
+    // and the COBS path decodes in place. Every frame costs at least one
+    // wire byte, so chunk bounds the frames per read and the batch.
+    std::vector<uint8_t>      read_buf(chunk);
+    FrameScanner              scanner(opt.format);
+    QVector<CANFrame>         frames;
+    std::vector<DecodedFrame> batch;
+    frames.reserve(static_cast<int>(chunk));
+    batch.reserve(Ring::capacity());
+    size_t n_frames  = 0;
+    size_t n_decoded = 0;
+    size_t n_reads   = 0;
+    double value_sum = 0;
+
+    g_count_allocs = true;
+    const std::clock_t cpu0  = std::clock();
+    const auto         wall0 = std::chrono::steady_clock::now();
+    for (size_t off = 0; off < stream.size(); off += chunk) {
+        size_t n = std::min(chunk, stream.size() - off);
+        memcpy(read_buf.data(), stream.data() + off, n);
+        frames.clear();
+        scanner.feed(read_buf.data(), n, frames);
+
+        // Worker: one timestamp per read, decode into the ring
+        const int64_t rx_ms = static_cast<int64_t>(off / BYTES_PER_SEC * 1000.0);
+        for (const CANFrame& f : frames) {
+            DecodedFrame* slot = g_ring.acquire();
+            if (!slot) {
+                g_ring.note_drop();
+                continue;
+            }
+            if (FrameDecoder::decode(f, rx_ms, *slot)) g_ring.commit();
+        }
+
+        // GUI: drain what is queued, as CANParser::drain() does
+        batch.clear();
+        for (size_t k = g_ring.size(); k > 0; --k) {
+            batch.push_back(*g_ring.front());
+            g_ring.pop();
+        }
+        for (const DecodedFrame& df : batch) value_sum += df.value;
+
+        n_frames  += static_cast<size_t>(frames.size());
+        n_decoded += batch.size();
+        ++n_reads;
+    }
+    const double cpu_s  = static_cast<double>(std::clock() - cpu0) / CLOCKS_PER_SEC;
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+    g_count_allocs = false;
+    g_sink = value_sum;
+    const size_t allocs = g_allocs.load();
+
+    printf("[BENCH] format          : %s\n", opt.format == Wire::Format::COBS_V1 ? "cobs" : "legacy");
+    printf("[BENCH] stream          : %zu bytes = %.1f s at 1 Mbit/s, %zu reads of %zu B\n",
+           stream.size(), opt.seconds, n_reads, chunk);
+    printf("[BENCH] frames          : %zu (%.0f/s of link time), %zu decoded\n",
+           n_frames, n_frames / opt.seconds, n_decoded);
+    printf("[BENCH] scan + decode   : %.0f frames/s, %.1f MB/s\n",
+           wall_s > 0 ? n_frames / wall_s : 0.0, wall_s > 0 ? stream.size() / wall_s / 1e6 : 0.0);
+    printf("[BENCH] CPU at 1 Mbit/s : %.3f %% of one core\n", 100.0 * cpu_s / opt.seconds);
+    if (BENCH_COUNTS_ALLOCS) {
+        printf("[BENCH] heap allocs     : %zu (%.4f per frame)\n",
+               allocs, n_frames ? static_cast<double>(allocs) / n_frames : 0.0);
+    } else {
+        printf("[BENCH] heap allocs     : not counted on this platform\n");
+    }
+    printf("[BENCH] ring drops      : %u\n", static_cast<unsigned>(g_ring.drops()));
+    printf("[BENCH] corrupt packets : %u\n", static_cast<unsigned>(scanner.corruptPackets()));
+    return scanner.corruptPackets() == 0 && allocs == 0 ? 0 : 1;
+}
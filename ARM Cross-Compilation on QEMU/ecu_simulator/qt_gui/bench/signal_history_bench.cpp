@@ -0,0 +1,134 @@
+// ─────────────────────────────────────────────────────
+//  Signal history benchmark
+//
+//  Fills a SignalHistory with --hours of a 1 kHz signal
+//  (the sample stream's rate) and reports append rate
+//  and query() time for 1 min / 10 min / 1 h / all
+//  windows at --columns columns, i.e. what one Trends
+//  repaint costs at each zoom level.
+//
+//  Before timing, random windows over a shorter history
+//  are checked against a brute-force scan: every column
+//  must contain the true min and max of its samples. A
+//  miss fails the run.
+//
+//  Build:  cmake -DECU_BUILD_BENCH=ON … → signal_history_bench
+//  Usage:  signal_history_bench [--hours N] [--columns N]
+// ─────────────────────────────────────────────────────
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SignalHistory.hpp"
+
+namespace {
+
+constexpr int64_t T0_MS = 1'700'000'000'000;   // any wall-clock origin
+
+struct Options {
+    double hours   = 6;
+    int    columns = 1600;
+};
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val  = i + 1 < argc;
+        if (a == "--hours" && has_val) {
+            opt.hours = atof(argv[++i]);
+        } else if (a == "--columns" && has_val) {
+            opt.columns = atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return opt.hours > 0 && opt.columns > 0;
+}
+
+// Random windows over irregularly spaced samples, each
+// column compared with the exact extremes of its slice
+bool checkEnvelopes() {
+    std::mt19937 rng(7);
+    SignalHistory h;
+    std::vector<std::pair<int64_t, float>> ref;
+    int64_t t = T0_MS;
+    for (int i = 0; i < 300'000; ++i) {
+        t += rng() % 3;
+        const float v = static_cast<float>(rng() % 10'000) / 7.0f;
+        h.append(t, v);
+        ref.emplace_back(t, v);
+    }
+
+    const int64_t first = ref.front().first;
+    const int64_t last  = ref.back().first;
+    std::vector<SignalHistory::Column> got, want;
+    for (int q = 0; q < 200; ++q) {
+        const int     cols = 1 + static_cast<int>(rng() % 1200);
+        const int64_t a    = first + static_cast<int64_t>(rng() % static_cast<uint64_t>(last - first));
+        const int64_t b    = a + 1 + static_cast<int64_t>(rng() % static_cast<uint64_t>(last - a + 5000));
+        h.query(a, b, cols, got);
+
+        want.assign(static_cast<size_t>(cols), {0, 0, false});
+        for (const auto& s : ref) {
+            if (s.first < a || s.first >= b) continue;
+            auto& c = want[static_cast<size_t>((s.first - a) * cols / (b - a))];
+            if (!c.valid) c = {s.second, s.second, true};
+            c.min = std::min(c.min, s.second);
+            c.max = std::max(c.max, s.second);
+        }
+        for (size_t c = 0; c < want.size(); ++c) {
+            if (!want[c].valid) continue;
+            if (!got[c].valid || got[c].min > want[c].min || got[c].max < want[c].max) {
+                fprintf(stderr, "[BENCH] envelope miss: window %d, column %zu of %d\n", q, c, cols);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--hours N] [--columns N]\n", argv[0]);
+        return 2;
+    }
+    if (!checkEnvelopes()) return 1;
+    printf("[BENCH] envelopes       : exact extremes inside every column\n");
+
+    SignalHistory h;
+    const int64_t n = static_cast<int64_t>(opt.hours * 3'600'000);
+    const auto a0 = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < n; ++i)
+        h.append(T0_MS + i, 1000.0f * std::sin(static_cast<float>(i) * 0.001f));
+    const double append_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - a0).count();
+
+    printf("[BENCH] samples         : %lld (%.1f h at 1 kHz)\n", static_cast<long long>(n), opt.hours);
+    printf("[BENCH] append          : %.1f M samples/s\n", append_s > 0 ? n / append_s / 1e6 : 0.0);
+
+    const struct { const char* label; int64_t ms; } windows[] = {
+        {"1 min", 60'000}, {"10 min", 600'000}, {"1 h", 3'600'000}, {"all", 0},
+    };
+    std::vector<SignalHistory::Column> cols;
+    const int64_t end = h.lastTime() + 1;
+    for (const auto& w : windows) {
+        const int64_t start = w.ms ? end - w.ms : h.firstTime();
+        constexpr int REPS = 200;
+        const auto q0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < REPS; ++r) h.query(start, end, opt.columns, cols);
+        const double ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - q0).count() / REPS;
+        const long filled = std::count_if(cols.begin(), cols.end(),
+                                          [](const SignalHistory::Column& c) { return c.valid; });
+        printf("[BENCH] query %-6s    : %.3f ms, %ld/%d columns filled\n",
+               w.label, ms, filled, opt.columns);
+    }
+    return 0;
+}
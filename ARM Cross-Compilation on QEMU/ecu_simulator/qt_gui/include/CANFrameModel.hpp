@@ -0,0 +1,56 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CANFrameModel
+//
+//  Table model over CANFrameStore's current view (all
+//  frames, or the ones matching the filter). A drain
+//  tick tells the view with one insert (or remove) at
+//  the bottom plus, once the ring is full, one
+//  dataChanged, so the cost per frame does not depend
+//  on how much history is kept. Cell text comes from
+//  FrameDecoder only when the view asks for a visible
+//  cell.
+//
+//  Row 0 is the oldest frame still held. When the ring
+//  is full, new frames overwrite the oldest and every
+//  row moves up; historyShifted() reports by how much
+//  so the view can keep the rows under the user still.
+// ─────────────────────────────────────────────────────
+#include <cstdint>
+#include <QAbstractTableModel>
+#include <QVector>
+#include "CANFrameStore.hpp"
+
+class CANFrameModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { COL_TIME, COL_ID, COL_NAME, COL_VALUE, COL_LEN, COL_RAW, COL_COUNT };
+
+    explicit CANFrameModel(QObject* parent = nullptr);
+
+    int      rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int      columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    // One drain tick; filtered as it goes in
+    void append(const QVector<DecodedFrame>& frames);
+    void clear();
+
+    // Rebuilds the view from the store's indexes and resets
+    void setFilter(const CANFrameStore::Filter& filter);
+    const CANFrameStore::Filter& filter() const { return store_.filter(); }
+
+    const DecodedFrame& frameAt(int row) const { return store_.row(row); }
+    int rowAtTime(int64_t rx_ms) const         { return store_.rowAtTime(rx_ms); }
+    int totalFrames() const                    { return store_.total(); }
+
+signals:
+    // Rows that scrolled out of the top of a full ring
+    void historyShifted(int rows);
+
+private:
+    CANFrameStore store_;
+};
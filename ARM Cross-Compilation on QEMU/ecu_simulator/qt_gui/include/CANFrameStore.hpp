@@ -0,0 +1,112 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CANFrameStore
+//
+//  The CAN monitor's history: a fixed ring of
+//  DecodedFrames addressed by sequence number, plus
+//  the indexes that make filtering cheap.
+//
+//    by ID   — per-ID list of sequence numbers
+//    faults  — sequence numbers of is_fault frames
+//    by time — the ring itself: arrival times are
+//              clamped to never go backwards, so any
+//              row range can be binary-searched
+//
+//  A filter selects a view: the sorted list of matching
+//  sequence numbers. Setting a filter builds the view
+//  from the narrowest index (merge of the chosen IDs,
+//  else the fault list, else one pass over the ring);
+//  after that each append tests only the new frames.
+//  Evicting old frames trims every list from the front,
+//  so nothing is ever rescanned.
+//
+//  Plain C++ — the model (CANFrameModel) turns appends
+//  and filter changes into view signals.
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "FrameDecoder.hpp"
+
+class CANFrameStore {
+public:
+    static constexpr int HISTORY_BITS = 20;
+    static constexpr int HISTORY      = 1 << HISTORY_BITS;   // 1 048 576 frames, 32 MB
+
+    struct Filter {
+        std::vector<uint16_t> ids;          // sorted; empty = any ID
+        bool   faults_only = false;
+        bool   use_range   = false;         // value within [min, max]
+        double min = 0;
+        double max = 0;
+
+        bool active() const { return !ids.empty() || faults_only || use_range; }
+        bool matches(const DecodedFrame& f) const;
+    };
+
+    // How an append changes the current view
+    struct Delta {
+        int dropped;   // rows evicted from the top
+        int added;     // rows appended at the bottom
+    };
+
+    CANFrameStore();
+
+    // What append(frames, n) would do to the view, without doing it
+    Delta delta(const DecodedFrame* frames, int n) const;
+
+    // Only the newest HISTORY frames of a burst are kept
+    void append(const DecodedFrame* frames, int n);
+    void clear();
+
+    void          setFilter(const Filter& filter);
+    const Filter& filter() const { return filter_; }
+
+    // ── Current view ─────────────────────────
+    int rows() const {
+        return filter_.active() ? static_cast<int>(view_.size()) : static_cast<int>(next_ - first_);
+    }
+    const DecodedFrame& row(int r) const {
+        return at(filter_.active() ? view_.at(static_cast<size_t>(r)) : first_ + static_cast<uint64_t>(r));
+    }
+
+    // First row that arrived at or after rx_ms; rows() if none
+    int rowAtTime(int64_t rx_ms) const;
+
+    // Frames held, whatever the filter
+    int total() const { return static_cast<int>(next_ - first_); }
+
+private:
+    static constexpr uint64_t MASK = HISTORY - 1;
+
+    // Ascending sequence numbers, trimmed from the front
+    class SeqList {
+    public:
+        void     push(uint64_t seq)   { seqs_.push_back(seq); }
+        size_t   size() const         { return seqs_.size() - head_; }
+        uint64_t at(size_t i) const   { return seqs_[head_ + i]; }
+        size_t   countBefore(uint64_t seq) const;
+        void     dropBefore(uint64_t seq);
+        void     clear()              { seqs_.clear(); head_ = 0; }
+        void     reserve(size_t n)    { seqs_.reserve(n); }
+
+    private:
+        std::vector<uint64_t> seqs_;
+        size_t                head_ = 0;
+    };
+
+    std::vector<DecodedFrame> ring_;
+    uint64_t first_   = 0;   // oldest sequence number held
+    uint64_t next_    = 0;   // sequence number of the next frame
+    int64_t  last_ms_ = 0;
+
+    std::unordered_map<uint16_t, SeqList> by_id_;
+    SeqList faults_;
+
+    Filter  filter_;
+    SeqList view_;
+
+    const DecodedFrame& at(uint64_t seq) const { return ring_[static_cast<size_t>(seq & MASK)]; }
+    void rebuildView();
+};
@@ -1,13 +1,16 @@
 #pragma once
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QCheckBox>
 #include <QPushButton>
+#include <QLabel>
+#include <QLineEdit>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QScrollBar>
 #include "CANParser.hpp"
+#include "CANFrameModel.hpp"
 
 class CANMonitor : public QWidget {
     Q_OBJECT
@@ -16,16 +19,30 @@ public:
 
 public slots:
     void addFrame(const DecodedFrame& frame);
+    void addFrames(const QVector<DecodedFrame>& frames);   // one drain tick
     void clearLog();
 
 private:
-    QTableWidget* table_       = nullptr;
-    QCheckBox*    auto_scroll_ = nullptr;
-    QPushButton*  clear_btn_   = nullptr;
-    QCheckBox*    pause_chk_   = nullptr;
+    QTableView*    table_       = nullptr;
+    CANFrameModel* model_       = nullptr;
+    QCheckBox*     auto_scroll_ = nullptr;
+    QPushButton*   clear_btn_   = nullptr;
+    QCheckBox*     pause_chk_   = nullptr;
+    QLabel*        count_lbl_   = nullptr;
 
-    static constexpr int MAX_ROWS = 500;
+    // Filter bar
+    QLineEdit*     ids_edit_    = nullptr;
+    QLineEdit*     min_edit_    = nullptr;
+    QLineEdit*     max_edit_    = nullptr;
+    QCheckBox*     faults_chk_  = nullptr;
+    QLineEdit*     goto_edit_   = nullptr;
+
+    static constexpr int ROW_HEIGHT = 22;
 
     void setupTable();
-    static QColor rowColor(const DecodedFrame& frame);
+    QHBoxLayout* setupFilterBar();
+    void applyFilter();
+    void jumpToTime();
+    void updateCount();
+    void onHistoryShifted(int rows);
 };
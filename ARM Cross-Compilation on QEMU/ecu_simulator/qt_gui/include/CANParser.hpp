@@ -2,40 +2,70 @@
 // ─────────────────────────────────────────────────────
 //  CANParser
 //
-//  Receives raw CANFrame structs, decodes them by ID,
-//  and emits typed signals the GUI widgets bind to.
+//  GUI-thread end of the decoded-frame ring. The CAN
+//  worker fills the ring with FrameDecoder::decode();
+//  dispatch() routes each DecodedFrame to the typed
+//  signals the widgets bind to, and assembles DTC dumps.
 //
-//  Every signal carries a decoded value + the raw
-//  CANFrame so the CAN monitor can display it too.
+//  A 60 Hz timer drains the ring, so the GUI thread does
+//  one bounded batch per frame of video instead of one
+//  slot call per CAN frame.
 // ─────────────────────────────────────────────────────
-#pragma once
 #include <QObject>
-#include <QString>
-#include <QDateTime>
+#include <QList>
+#include <QVector>
+#include <QTimer>
 #include "ecu_protocol.hpp"
+#include "spsc_ring.hpp"
+#include "FrameDecoder.hpp"
+
+// Per-task run-time stats (CAN 0x7F0)
+struct TaskStats {
+    int id;
+    int cpu_pct;
+    int stack_free_words;
+    int jitter_us;
+    int missed;
+};
+
+// Queue fill levels (CAN 0x7F1)
+struct QueueStats {
+    int ring_fill,   ring_cap, ring_peak, ring_drops;
+    int fault_fill,  fault_cap;
+    int tx_batch_peak, tx_batch_cap;   // largest CAN TX batch in the window
+};
+
+// One freeze frame from a DTC dump (CAN 0x7EA)
+struct DTCFreezeFrame {
+    int    rpm;
+    int    coolant_c;
+    int    battery_mv;
+    double age_s;           // relative to the dump
+};
 
-// A decoded CAN message ready for display
-struct DecodedFrame {
-    QDateTime   timestamp;
-    uint16_t    id;
-    QString     id_str;        // "0x100"
-    QString     name;          // "RPM"
-    QString     value_str;     // "3200 rpm"
-    double      value;         // numeric for charting
-    QString     unit;
-    QByteArray  raw_data;
-    uint8_t     len;
-    bool        is_fault = false;
+// One DTC from a dump (CAN 0x7E9 + its freeze frames)
+struct DTCRecord {
+    uint16_t code;
+    bool     active;
+    int      count;
+    int      last_seen_s;
+    QList<DTCFreezeFrame> freeze_frames;   // newest first
 };
 
+// Worker → GUI hand-off: ~1 s of a 1 Mbit/s link, 256 KB flat
+using DecodedFrameRing = ECU::SpscRing<DecodedFrame, 8192>;
+
 class CANParser : public QObject {
     Q_OBJECT
 
 public:
-    explicit CANParser(QObject* parent = nullptr);
+    // ring is filled by the CAN worker; it must outlive the parser
+    explicit CANParser(DecodedFrameRing* ring, QObject* parent = nullptr);
+
+    static constexpr int DRAIN_HZ = 60;
 
 public slots:
-    void parseFrame(CANFrame frame);
+    void dispatch(const DecodedFrame& frame);
 
 signals:
     // Typed sensor signals — dashboard binds to these
@@ -47,11 +77,27 @@ signals:
     void faultMaskUpdated(uint8_t mask);
     void engineStateUpdated(int state);   // 0=off 1=cranking 2=running 3=fault
     void dtcReceived(uint16_t code, uint8_t count);
+    void taskStatsReceived(TaskStats stats);
+    void queueStatsReceived(QueueStats stats);
+    void dtcDumpStarted();                 // record 0 of a dump (also for an empty store)
+    void dtcRecordReceived(DTCRecord record);
 
-    // Raw decoded frame — CAN monitor table binds to this
-    void frameDecoded(DecodedFrame frame);
+    // Every frame drained in one tick — CAN monitor table binds to this
+    void framesDecoded(QVector<DecodedFrame> frames);
+
+    // The worker outran the GUI; total frames lost so far
+    void framesDropped(quint32 total);
+
+private slots:
+    void drain();
 
 private:
-    DecodedFrame makeFrame(const CANFrame& raw, const QString& name,
-                           double value, const QString& unit) const;
+    DecodedFrameRing*   ring_;
+    QTimer*             drain_timer_ = nullptr;
+    QVector<DecodedFrame> batch_;
+    quint32             drops_seen_ = 0;
+
+    // DTC dump in progress: record waiting for its freeze frames
+    DTCRecord dtc_pending_{};
+    int       dtc_pending_ff_ = 0;
 };
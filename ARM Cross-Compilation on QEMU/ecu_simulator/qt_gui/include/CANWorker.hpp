@@ -0,0 +1,106 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CANWorker
+//
+//  Owns the CAN serial port on its own QThread. Each
+//  read is framed by FrameScanner, decoded by
+//  FrameDecoder::decode() straight into a slot of the
+//  decoded-frame ring and committed. Nothing per frame
+//  is allocated or goes through an event loop once the
+//  reusable buffers have grown; the GUI thread drains
+//  the ring on CANParser's 60 Hz timer. When the GUI
+//  falls a full ring behind, frames are dropped and
+//  counted rather than queued without bound.
+//
+//  The worker is also the capture end of the pipeline:
+//    record — every scanned frame is appended to a
+//             .ecucap file with its read time
+//    replay — a capture is fed into the same ring on a
+//             timer, at a speed factor or as fast as
+//             the GUI drains it, with seeking. A full
+//             ring holds replay back instead of
+//             dropping, so every frame arrives.
+//  Replay closes the serial port; the ring keeps a
+//  single producer either way.
+//
+//  ConnectionManager drives it with queued calls and
+//  gets state back through (queued) signals.
+// ─────────────────────────────────────────────────────
+#include <atomic>
+#include <QObject>
+#include <QSerialPort>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include "CANParser.hpp"
+#include "CaptureFile.hpp"
+#include "FrameScanner.hpp"
+
+class CANWorker : public QObject {
+    Q_OBJECT
+
+public:
+    // No parent: moved to the CAN thread right after construction
+    explicit CANWorker(DecodedFrameRing* ring);
+
+    // Packets rejected by the COBS/CRC check since open — any thread
+    quint32 corruptPacketCount() const { return corrupt_.load(std::memory_order_relaxed); }
+
+public slots:
+    void open(const QString& portName, int baudRate);
+    void close();
+    void setWireFormat(Wire::Format fmt);
+
+    void startRecording(const QString& path);
+    void stopRecording();
+
+    // speed: 1.0 = real time, 10.0 = 10×, 0 = as fast as possible
+    void startReplay(const QString& path, double speed);
+    void setReplaySpeed(double speed);
+    void seekReplay(double pos_s);
+    void stopReplay();
+
+signals:
+    void opened();
+    void closed();
+    void statusMessage(const QString& msg);
+
+    void recordingChanged(bool recording);
+    void replayStarted(double duration_s);
+    void replayPosition(double pos_s);     // ~10 Hz while replaying
+    void replaySeeked(double pos_s);       // frames before this are stale
+    void replayStopped();
+
+private slots:
+    void onReadyRead();
+    void onError(QSerialPort::SerialPortError err);
+    void replayTick();
+
+private:
+    DecodedFrameRing*    ring_;
+    QSerialPort*         serial_ = nullptr;   // created on the CAN thread
+    FrameScanner         scanner_;
+    QByteArray           read_buf_;           // reused across reads
+    QVector<CANFrame>    frames_;             // reused across reads
+    std::atomic<quint32> corrupt_{0};
+
+    // Recording
+    CaptureWriter        writer_;
+    QElapsedTimer        rec_clock_;
+
+    // Replay
+    static constexpr int REPLAY_TICK_MS = 4;
+    CaptureReader        reader_;
+    QTimer*              replay_timer_  = nullptr;
+    QElapsedTimer        replay_clock_;         // since replay_base_us_
+    QElapsedTimer        replay_wall_;          // whole run, for the summary
+    int64_t              replay_base_us_ = 0;   // capture time at replay_clock_ = 0
+    uint64_t             replay_pos_     = 0;   // next record
+    uint64_t             replay_sent_    = 0;
+    double               replay_speed_   = 1.0;
+    qint64               replay_last_report_ms_ = 0;
+
+    int64_t replayNowUs() const;
+    void    rebaseReplay(int64_t capture_us);
+};
@@ -0,0 +1,106 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CampaignEngine
+//
+//  Plays a scenario file (scripts/scenarios/*.scn, the
+//  format run_scenario.py uses) against the live ECU in
+//  real time and measures how fast faults are detected.
+//
+//  Timing: events are scheduled on a QElapsedTimer from
+//  the start of the run; a single-shot precise timer is
+//  armed for the next due event, and everything due when
+//  it fires goes out as ONE TCP write (commandsReady),
+//  so commands sharing a timestamp — or a ramp step that
+//  lands with an injection — reach the firmware together.
+//  How late each write was is recorded.
+//
+//  Latency: every injection is matched against the CAN
+//  stream (onFrames) —
+//    mask  first 0x7E0 frame where the fault's bit rises
+//    DTC   first 0x7E8 frame carrying the fault's code
+//  both at or after the send time. An injection whose
+//  bit was already set has no mask latency; one with no
+//  match within MATCH_TIMEOUT_MS counts as missed. Times
+//  are frame arrival (DecodedFrame::rx_ms) minus send,
+//  so they include the link and the firmware's UART poll.
+// ─────────────────────────────────────────────────────
+#include <cstdint>
+#include <vector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include "FrameDecoder.hpp"
+
+class CampaignEngine : public QObject {
+    Q_OBJECT
+
+public:
+    // One command; ramps are already expanded into throttle steps
+    struct Event {
+        int64_t    t_ms;
+        ControlCmd cmd;
+        uint8_t    arg0;
+        uint8_t    arg1;
+    };
+
+    static constexpr int64_t MATCH_TIMEOUT_MS = 5000;
+
+    explicit CampaignEngine(QObject* parent = nullptr);
+
+    // Parse a .scn file. duration_ms is the time of its 'end' event.
+    static bool load(const QString& path, std::vector<Event>& events,
+                     int64_t& duration_ms, QString& error);
+
+    bool start(const QString& path, int runs);   // false: see statusMessage
+    void stop();
+    bool isRunning() const { return running_; }
+
+    QString summary() const;                      // per-fault latency table
+    bool    saveResults(const QString& path) const;   // one CSV row per injection
+
+public slots:
+    void onFrames(const QVector<DecodedFrame>& frames);
+
+signals:
+    void commandsReady(const QByteArray& pkt);    // → ConnectionManager::sendCommands
+    void progress(double pos_s, double duration_s);
+    void finished();
+    void statusMessage(const QString& msg);
+
+private:
+    struct Injection {
+        int64_t    sent_ms;          // wall clock, comparable with rx_ms
+        ControlCmd cmd;
+        uint8_t    bit;              // FaultCode mask bit
+        uint16_t   dtc;
+        bool       was_active;       // bit already set: no mask latency
+        int64_t    mask_ms = -1;     // latency, -1 = not seen
+        int64_t    dtc_ms  = -1;
+    };
+
+    QTimer*       timer_ = nullptr;
+    QElapsedTimer clock_;
+    std::vector<Event> events_;
+    int64_t       duration_ms_ = 0;
+    int           runs_        = 0;
+    int           run_         = 0;
+    size_t        next_        = 0;
+    bool          running_     = false;
+    bool          draining_    = false;   // all sent, waiting for matches
+
+    std::vector<Injection> injections_;
+    size_t        first_open_  = 0;       // older ones are matched or expired
+    uint8_t       last_mask_   = 0;
+
+    std::vector<int64_t> lateness_us_;    // per write
+    int           commands_sent_ = 0;
+
+    int64_t dueMs(size_t i) const { return run_ * duration_ms_ + events_[i].t_ms; }
+    void    armTimer();
+    void    tick();
+    void    finish();
+    bool    allMatched() const;
+};
@@ -0,0 +1,122 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  CAN capture file (.ecucap)
+//
+//  Fixed-size records in arrival order, so frame i is
+//  at a computed offset and the file can be read
+//  straight from a memory map:
+//
+//    FileHeader   64 B   magic, counts, index offset
+//    Record × N   24 B   t_us since start, id, len, data
+//    IndexEntry × M 16 B one per INDEX_STRIDE records
+//
+//  The writer appends records through a small buffer
+//  and only writes the index and the final counts on
+//  close(). A capture cut short by a crash has a zero
+//  index_offset; the reader then takes the record count
+//  from the file size and binary-searches the records
+//  directly, so it is still fully replayable.
+//
+//  Fields are host byte order (little-endian on every
+//  machine that runs the GUI).
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <QFile>
+#include <QString>
+#include "ecu_protocol.hpp"
+
+namespace Capture {
+
+constexpr char     MAGIC[8]     = {'E', 'C', 'U', 'C', 'A', 'P', '\r', '\n'};
+constexpr uint32_t VERSION      = 1;
+constexpr uint32_t INDEX_STRIDE = 4096;
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    int64_t  start_ms;       // wall clock of t_us = 0, ms since the epoch
+    uint64_t frame_count;    // 0 until close()
+    uint64_t index_offset;   // 0 until close()
+    uint32_t index_stride;
+    uint32_t index_count;
+    uint8_t  reserved[16];
+};
+
+struct Record {
+    int64_t  t_us;           // since start_ms, non-decreasing
+    uint16_t id;
+    uint8_t  len;
+    uint8_t  flags;          // reserved, 0
+    uint8_t  data[8];
+    uint32_t reserved;
+};
+
+struct IndexEntry {
+    int64_t  t_us;           // of record `frame`
+    uint64_t frame;
+};
+
+static_assert(sizeof(FileHeader) == 64, "capture header layout");
+static_assert(sizeof(Record)     == 24, "capture record layout");
+static_assert(sizeof(IndexEntry) == 16, "capture index layout");
+
+} // namespace Capture
+
+class CaptureWriter {
+public:
+    ~CaptureWriter() { close(); }
+
+    // Truncates path. start_ms is the wall clock of t_us = 0.
+    bool open(const QString& path, int64_t start_ms);
+    void append(const CANFrame& frame, int64_t t_us);
+    bool close();                     // flush, write index, patch header
+
+    bool     isOpen() const { return file_.isOpen(); }
+    uint64_t frames() const { return count_; }
+    QString  errorString() const { return file_.errorString(); }
+
+private:
+    static constexpr size_t FLUSH_RECORDS = 4096;
+
+    QFile                            file_;
+    std::vector<Capture::Record>     buf_;
+    std::vector<Capture::IndexEntry> index_;
+    uint64_t count_     = 0;
+    int64_t  start_ms_  = 0;
+    int64_t  last_t_us_ = 0;
+
+    bool flush();
+};
+
+class CaptureReader {
+public:
+    ~CaptureReader() { close(); }
+
+    bool open(const QString& path);   // maps the whole file read-only
+    void close();
+
+    bool     isOpen()     const { return records_ != nullptr; }
+    uint64_t frameCount() const { return count_; }
+    int64_t  startMs()    const { return start_ms_; }
+    int64_t  durationUs() const { return count_ ? records_[count_ - 1].t_us : 0; }
+    QString  errorString() const { return error_; }
+
+    const Capture::Record& record(uint64_t i) const { return records_[i]; }
+    static CANFrame toFrame(const Capture::Record& r);
+
+    // First frame at or after t_us; frameCount() if none
+    uint64_t frameAtTime(int64_t t_us) const;
+
+private:
+    QFile                      file_;
+    uchar*                     map_     = nullptr;
+    const Capture::Record*     records_ = nullptr;
+    const Capture::IndexEntry* index_   = nullptr;
+    uint32_t                   index_count_ = 0;
+    uint64_t                   count_    = 0;
+    int64_t                    start_ms_ = 0;
+    QString                    error_;
+};
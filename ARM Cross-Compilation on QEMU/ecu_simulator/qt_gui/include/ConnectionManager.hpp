@@ -3,32 +3,50 @@
 //  ConnectionManager
 //
 //  Owns two connections to QEMU:
-//    1. QTcpSocket  → TCP :5000 (control commands)
-//    2. QSerialPort → COM port / PTY (CAN frames)
+//    1. QTcpSocket  → TCP :5000 (control commands),
+//                     on the GUI thread
+//    2. QSerialPort → COM port / PTY (CAN frames), on
+//                     a CANWorker in its own QThread
 //
 //  The PTY path is exposed by QEMU on WSL as something
 //  like /dev/pts/3. On Windows you bridge it with a
 //  named pipe or socat. The launch script handles this.
 //
+//  The CAN stream is decoded in either wire format:
+//    LEGACY  — fixed 13-byte frames, SOF/EOF hunting
+//    COBS_V1 — COBS batches with CRC-16 (ecu_wire.hpp)
+//  setWireFormat() switches both ends of the link.
+//  Decoded frames reach the GUI through frameRing(),
+//  which CANParser drains — not through signals.
+//
+//  The CAN stream can be recorded to a .ecucap capture
+//  and a capture replayed in place of the serial port
+//  (see CaptureFile.hpp); both run on the CAN thread.
+//
 //  Signals emitted to the rest of the GUI:
-//    canFrameReceived(CANFrame)
 //    controlConnected / controlDisconnected
 //    canConnected    / canDisconnected
+//    recordingChanged, replayStarted / Position /
+//    Seeked / Stopped
 //    statusMessage(QString)
 // ─────────────────────────────────────────────────────
 #pragma once
 #include <QObject>
 #include <QTcpSocket>
-#include <QSerialPort>
+#include <QThread>
 #include <QTimer>
-#include <QByteArray>
 #include "ecu_protocol.hpp"
+#include "ecu_wire.hpp"
+#include "CANParser.hpp"
+
+class CANWorker;
 
 class ConnectionManager : public QObject {
     Q_OBJECT
 
 public:
     explicit ConnectionManager(QObject* parent = nullptr);
+    ~ConnectionManager() override;
 
     // Connect to QEMU control channel (TCP)
     void connectControl(const QString& host, quint16 port);
@@ -41,43 +59,73 @@ public:
     bool isControlConnected() const;
     bool isCANConnected()     const;
 
+    // Select the CAN wire format. Sent to the firmware now
+    // if the control channel is up, otherwise on connect.
+    void setWireFormat(Wire::Format fmt);
+    Wire::Format wireFormat() const { return wire_format_; }
+
+    // Packets rejected by the COBS/CRC check since connect
+    quint32 corruptPacketCount() const;
+
+    // Filled by the CAN worker thread, drained by CANParser
+    DecodedFrameRing* frameRing() { return &ring_; }
+
+    // Capture of the serial stream
+    void startRecording(const QString& path);
+    void stopRecording();
+
+    // Replay a capture instead of the serial stream.
+    // speed: 1.0 = real time, 10.0 = 10×, 0 = as fast as possible
+    void startReplay(const QString& path, double speed);
+    void setReplaySpeed(double speed);
+    void seekReplay(double pos_s);
+    void stopReplay();
+
+    // Append one encoded command (code + its arg bytes) to pkt
+    static void appendCommand(QByteArray& pkt, ControlCmd cmd,
+                              uint8_t arg0 = 0, uint8_t arg1 = 0);
+
 public slots:
     // Send a control command to the firmware
     void sendCommand(ControlCmd cmd, uint8_t arg0 = 0, uint8_t arg1 = 0);
+    // Several appendCommand()-encoded commands in one TCP write
+    void sendCommands(const QByteArray& pkt);
     void sendThrottle(int pct);
+    void sendSampleRate(int hz);          // 0 = default 10 Hz, no sample stream
     void sendFaultInject(ControlCmd faultCmd);
     void sendClearFaults();
+    void sendDTCDump();
     void sendPing();
 
 signals:
-    void canFrameReceived(CANFrame frame);
     void controlConnected();
     void controlDisconnected();
     void canConnected();
     void canDisconnected();
     void statusMessage(const QString& msg);
 
+    void recordingChanged(bool recording);
+    void replayStarted(double duration_s);
+    void replayPosition(double pos_s);
+    void replaySeeked(double pos_s);
+    void replayStopped();
+
 private slots:
     void onTcpConnected();
     void onTcpDisconnected();
     void onTcpError(QAbstractSocket::SocketError err);
     void onTcpReadyRead();
 
-    void onSerialReadyRead();
-    void onSerialError(QSerialPort::SerialPortError err);
-
     void pingTimer();
 
 private:
     QTcpSocket*  tcp_    = nullptr;
-    QSerialPort* serial_ = nullptr;
     QTimer*      ping_timer_ = nullptr;
 
-    // Framing state machine for incoming serial data
-    enum class FrameState { WAIT_SOF, READ_BODY };
-    FrameState   frame_state_ = FrameState::WAIT_SOF;
-    QByteArray   frame_buf_;
-
-    void processSerialByte(uint8_t b);
-    void dispatchFrame();
+    // CAN stream: serial reader + decoder on their own thread
+    QThread*         can_thread_ = nullptr;
+    CANWorker*       worker_     = nullptr;
+    DecodedFrameRing ring_;
+    bool             can_open_    = false;
+    Wire::Format     wire_format_ = Wire::Format::LEGACY;
 };
@@ -7,6 +7,7 @@
 #include <QHBoxLayout>
 #include <QDateTime>
 #include <QMap>
+#include "CANParser.hpp"
 
 class DTCViewer : public QWidget {
     Q_OBJECT
@@ -15,18 +16,27 @@ public:
 
 public slots:
     void addDTC(uint16_t code, uint8_t count);
+    void addDTCRecord(DTCRecord record);   // from a 0x7E9/0x7EA dump
     void clearDTCs();
 
 signals:
     void clearRequested();
+    void dumpRequested();
 
 private:
     QTableWidget* table_     = nullptr;
     QLabel*       count_lbl_ = nullptr;
     QPushButton*  clear_btn_ = nullptr;
+    QPushButton*  dump_btn_  = nullptr;
+    QTableWidget* freeze_table_ = nullptr;
 
     // Track codes already in table to update count in place
     QMap<uint16_t, int> code_to_row_;
+    QMap<uint16_t, QList<DTCFreezeFrame>> freeze_frames_;
+
+    int  rowFor(uint16_t code);
+    void setStatus(int row, bool active);
+    void showFreezeFrames();
 
     static QString dtcDescription(uint16_t code);
     static QString dtcSeverity(uint16_t code);
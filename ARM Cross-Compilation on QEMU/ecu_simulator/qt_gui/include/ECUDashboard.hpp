@@ -11,7 +11,10 @@
 //    - Engine state badge
 //    - Active fault indicator
 //
-//  All updates come via slots — no polling.
+//  Updates come via slots at CAN rate but are only
+//  recorded; a frame timer at the screen's refresh rate
+//  pushes the latest values to whichever gauges changed,
+//  so a burst of frames costs one repaint per frame.
 // ─────────────────────────────────────────────────────
 #pragma once
 #include <QWidget>
@@ -25,9 +28,16 @@
 #include <QPainterPath>
 #include <QColor>
 #include <QTimer>
+#include <QPixmap>
+#include <climits>
 #include <cmath>
 
 // ── Arc Gauge widget ──────────────────────────────────
+// setValue() only stores the latest value; the dashboard's
+// frame timer calls flush(), which repaints if it changed.
+// Track, unit and title are drawn once into a cached pixmap
+// per size, so a frame is one blit plus the fill arc and
+// the number.
 class ArcGauge : public QWidget {
     Q_OBJECT
     Q_PROPERTY(double value READ value WRITE setValue)
@@ -35,98 +45,56 @@ class ArcGauge : public QWidget {
 public:
     ArcGauge(const QString& title, double min, double max,
              const QString& unit, QWidget* parent = nullptr)
-        : QWidget(parent), title_(title), min_(min), max_(max),
-          unit_(unit), value_(min)
+        : QWidget(parent), title_(title), unit_(unit), min_(min), max_(max),
+          value_(min), pending_(min)
     {
         setMinimumSize(160, 160);
         setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
     }
 
-    double value() const { return value_; }
+    double value() const { return pending_; }
 
     void setWarningThreshold(double v)  { warn_ = v; }
     void setCriticalThreshold(double v) { crit_ = v; }
 
-public slots:
-    void setValue(double v) {
-        value_ = qBound(min_, v, max_);
+    // Repaint if the value changed since the last frame
+    void flush() {
+        if (pending_ == value_) return;
+        value_ = pending_;
         update();
     }
 
-protected:
-    void paintEvent(QPaintEvent*) override {
-        QPainter p(this);
-        p.setRenderHint(QPainter::Antialiasing);
-
-        int side = qMin(width(), height());
-        QRectF rect(
-            (width()  - side) / 2.0 + 10,
-            (height() - side) / 2.0 + 10,
-            side - 20, side - 20
-        );
+public slots:
+    void setValue(double v) { pending_ = qBound(min_, v, max_); }
 
-        // Arc parameters: 225° to 315° (270° sweep, open at bottom-right)
-        constexpr double START_DEG = 225.0;
-        constexpr double SPAN_DEG  = 270.0;
-
-        // Background track
-        QPen track(QColor(60, 60, 60), 12, Qt::SolidLine, Qt::RoundCap);
-        p.setPen(track);
-        p.drawArc(rect, static_cast<int>(START_DEG * 16),
-                  static_cast<int>(-SPAN_DEG * 16));
-
-        // Coloured fill arc
-        double pct    = (value_ - min_) / (max_ - min_);
-        double sweep  = pct * SPAN_DEG;
-        QColor fill;
-        if (crit_ > 0 && value_ >= crit_) fill = QColor(220, 50, 50);
-        else if (warn_ > 0 && value_ >= warn_) fill = QColor(220, 160, 0);
-        else fill = QColor(50, 180, 100);
-
-        QPen arc_pen(fill, 12, Qt::SolidLine, Qt::RoundCap);
-        p.setPen(arc_pen);
-        p.drawArc(rect, static_cast<int>(START_DEG * 16),
-                  static_cast<int>(-sweep * 16));
-
-        // Value text
-        p.setPen(Qt::white);
-        QFont vf = font();
-        vf.setPointSize(static_cast<int>(side * 0.14));
-        vf.setBold(true);
-        p.setFont(vf);
-        p.drawText(rect, Qt::AlignCenter,
-                   QString::number(static_cast<int>(value_)));
-
-        // Unit text
-        QFont uf = font();
-        uf.setPointSize(static_cast<int>(side * 0.08));
-        p.setFont(uf);
-        p.setPen(QColor(160, 160, 160));
-        QRectF unit_rect = rect.adjusted(0, rect.height() * 0.35, 0, 0);
-        p.drawText(unit_rect, Qt::AlignCenter, unit_);
-
-        // Title text
-        QFont tf = font();
-        tf.setPointSize(static_cast<int>(side * 0.08));
-        p.setFont(tf);
-        p.setPen(QColor(180, 180, 180));
-        QRectF title_rect(rect.left(), rect.bottom() - 22, rect.width(), 22);
-        p.drawText(title_rect, Qt::AlignCenter, title_);
-    }
+protected:
+    void paintEvent(QPaintEvent*) override;
+    void resizeEvent(QResizeEvent*) override { background_ = QPixmap(); }
 
 private:
     QString title_, unit_;
-    double  min_, max_, value_;
+    double  min_, max_;
+    double  value_;      // painted
+    double  pending_;    // latest received
     double  warn_ = -1, crit_ = -1;
+
+    QPixmap background_;
+    QFont   value_font_;
+
+    QRectF dialRect() const;
+    void   renderBackground();
 };
 
 // ── Labelled bar gauge ────────────────────────────────
+// Same coalescing as ArcGauge: setters record, flush()
+// touches the progress bar, label and style sheet only
+// when what they show actually changed.
 class BarGauge : public QWidget {
     Q_OBJECT
 public:
     BarGauge(const QString& label, int min, int max,
              const QString& unit, QWidget* parent = nullptr)
-        : QWidget(parent), label_(label), min_(min), max_(max), unit_(unit)
+        : QWidget(parent), label_(label), unit_(unit), min_(min), max_(max)
     {
         auto* lay = new QHBoxLayout(this);
         lay->setContentsMargins(0, 0, 0, 0);
@@ -154,28 +122,41 @@ public:
         lay->addWidget(val_lbl_);
     }
 
-public slots:
-    void setValue(int v) {
-        bar_->setValue(qBound(min_, v, max_));
-        val_lbl_->setText(v < 0
-            ? "Disconnected"
-            : QStringLiteral("%1 %2").arg(v).arg(unit_));
-    }
-    void setValueF(double v) { setValue(static_cast<int>(v)); }
-    void setWarningColor(bool warn) {
-        bar_->setStyleSheet(warn
-            ? "QProgressBar{background:#333;border-radius:4px;}"
-              "QProgressBar::chunk{background:#dc8c14;border-radius:4px;}"
-            : "QProgressBar{background:#333;border-radius:4px;}"
-              "QProgressBar::chunk{background:#3db464;border-radius:4px;}");
+    void flush() {
+        if (pending_ != shown_) {
+            shown_ = pending_;
+            bar_->setValue(qBound(min_, shown_, max_));
+            val_lbl_->setText(shown_ < 0
+                ? "Disconnected"
+                : QStringLiteral("%1 %2").arg(shown_).arg(unit_));
+        }
+        if (pending_warn_ != shown_warn_) {
+            shown_warn_ = pending_warn_;
+            bar_->setStyleSheet(shown_warn_
+                ? "QProgressBar{background:#333;border-radius:4px;}"
+                  "QProgressBar::chunk{background:#dc8c14;border-radius:4px;}"
+                : "QProgressBar{background:#333;border-radius:4px;}"
+                  "QProgressBar::chunk{background:#3db464;border-radius:4px;}");
+        }
     }
 
+public slots:
+    void setValue(int v)          { pending_ = v; }
+    void setValueF(double v)      { setValue(static_cast<int>(v)); }
+    void setWarningColor(bool warn) { pending_warn_ = warn; }
+
 private:
     QLabel* lbl_;
     QLabel* val_lbl_;
     QProgressBar* bar_;
     QString label_, unit_;
     int min_, max_;
+
+    static constexpr int NOT_SHOWN = INT_MIN;   // "--" until the first flush
+    int  pending_      = NOT_SHOWN;
+    int  shown_        = NOT_SHOWN;
+    bool pending_warn_ = false;
+    bool shown_warn_   = false;
 };
 
 // ── Main dashboard widget ─────────────────────────────
@@ -193,6 +174,9 @@ public slots:
     void setFaultMask(uint8_t mask);
     void setEngineState(int state);
 
+protected:
+    void showEvent(QShowEvent* ev) override;
+
 private:
     ArcGauge*  rpm_gauge_     = nullptr;
     ArcGauge*  coolant_gauge_ = nullptr;
@@ -201,7 +185,13 @@ private:
     BarGauge*  battery_bar_   = nullptr;
     QLabel*    engine_state_  = nullptr;
     QLabel*    fault_badge_   = nullptr;
+    QTimer*    frame_timer_   = nullptr;
+
+    // Last shown, -1 = nothing yet; repeats skip the style sheet
+    int        shown_fault_mask_   = -1;
+    int        shown_engine_state_ = -1;
 
+    void repaintDirty();
     static QString engineStateStr(int s);
     static QString engineStateStyle(int s);
 };
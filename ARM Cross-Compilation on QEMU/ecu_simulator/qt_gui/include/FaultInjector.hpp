@@ -6,6 +6,8 @@
 #include <QGroupBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QComboBox>
+#include <QSpinBox>
 #include "ecu_protocol.hpp"
 
 class FaultInjector : public QWidget {
@@ -15,9 +17,20 @@ public:
 
 signals:
     void throttleChanged(int pct);
+    void sampleRateChanged(int hz);
     void injectFault(ControlCmd cmd);
     void clearFaultsRequested();
 
+    // Scenario campaign (see CampaignEngine)
+    void campaignStartRequested(const QString& path, int runs);
+    void campaignStopRequested();
+    void campaignSaveRequested(const QString& path);
+
+public slots:
+    void setCampaignRunning(bool running);
+    void setCampaignProgress(double pos_s, double duration_s);
+    void setCampaignResults(const QString& text);
+
 private slots:
     void onThrottleSlider(int value);
     void onOverheatBtn();
@@ -32,6 +45,15 @@ private:
     QPushButton* sensor_disc_btn_ = nullptr;
     QPushButton* volt_drop_btn_   = nullptr;
     QPushButton* clear_btn_       = nullptr;
+    QComboBox*   rate_combo_      = nullptr;
+
+    QString      campaign_path_;
+    QLabel*      campaign_file_   = nullptr;
+    QSpinBox*    runs_spin_       = nullptr;
+    QPushButton* run_btn_         = nullptr;
+    QPushButton* save_btn_        = nullptr;
+    QLabel*      campaign_status_ = nullptr;
+    QLabel*      campaign_results_= nullptr;
 
     static QPushButton* makeFaultBtn(const QString& label,
                                       const QString& color,
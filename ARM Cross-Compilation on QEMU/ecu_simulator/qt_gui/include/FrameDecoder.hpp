@@ -0,0 +1,49 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  FrameDecoder
+//
+//  Raw CANFrame → DecodedFrame, and DecodedFrame → text.
+//
+//  decode() runs on the CAN worker for every frame. It
+//  only copies the payload and works out the numeric
+//  value, so a DecodedFrame is a flat 32-byte struct:
+//  filling one allocates nothing and the ring slot is
+//  reused as-is.
+//
+//  The text helpers build the monitor's strings from the
+//  payload. They are called only for rows that are
+//  actually shown, so a paused monitor or a burst larger
+//  than the row limit costs no formatting at all.
+// ─────────────────────────────────────────────────────
+#include <cstdint>
+#include <type_traits>
+#include <QString>
+#include "ecu_protocol.hpp"
+
+// A decoded CAN message; display strings are built on demand
+struct DecodedFrame {
+    int64_t  rx_ms;       // arrival, ms since the epoch
+    double   value;       // numeric for charting
+    uint16_t id;
+    uint8_t  len;         // clamped to 8
+    uint8_t  data[8];
+    bool     is_fault;
+};
+static_assert(std::is_trivially_copyable<DecodedFrame>::value,
+              "DecodedFrame must stay a flat copy for the ingest ring");
+
+class FrameDecoder {
+public:
+    // Worker side — any thread, no allocation.
+    // false = too short for its ID, drop it.
+    static bool decode(const CANFrame& frame, int64_t rx_ms, DecodedFrame& out);
+
+    static const char* name(uint16_t id);   // "RPM"
+    static const char* unit(uint16_t id);   // "rpm", "" if none
+
+    // GUI side — one call per visible cell
+    static QString timeText(const DecodedFrame& f);    // "hh:mm:ss.zzz"
+    static QString idText(const DecodedFrame& f);      // "0x100"
+    static QString valueText(const DecodedFrame& f);   // "3200 rpm"
+    static QString rawText(const DecodedFrame& f);     // "0C 80"
+};
@@ -0,0 +1,65 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  FrameScanner
+//
+//  Turns one serial read into a batch of CANFrames.
+//  The read buffer is scanned in place: memchr finds the
+//  next SOF (legacy) or delimiter (COBS v1), and whole
+//  frames/packets are validated where they lie. Only
+//  the tail of a frame split across two reads is copied
+//  into a small carry buffer.
+//
+//    LEGACY  — 13-byte frame = SOF … EOF. A candidate
+//              whose byte 12 is not EOF is skipped by
+//              one byte, so a stray 0xAA costs one
+//              memchr, not a lost frame.
+//    COBS_V1 — packets are decoded in place by
+//              Wire::decode_batch; bytes before the
+//              first delimiter are ignored (joined
+//              mid-packet), damaged packets are counted.
+//
+//  Qt-free apart from QVector, so the ingest benchmark
+//  (bench/) links it without a serial port.
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+#include <QVector>
+#include "ecu_protocol.hpp"
+#include "ecu_wire.hpp"
+
+class FrameScanner {
+public:
+    explicit FrameScanner(Wire::Format fmt = Wire::Format::LEGACY) : format_(fmt) {}
+
+    // Drop any partial frame and switch format
+    void reset(Wire::Format fmt);
+    Wire::Format format() const { return format_; }
+
+    // Scan one read. data is modified (COBS decodes in
+    // place). Complete frames are appended to out.
+    void feed(uint8_t* data, size_t len, QVector<CANFrame>& out);
+
+    // COBS packets rejected since reset(), and why the last one was
+    quint32            corruptPackets() const { return corrupt_; }
+    Wire::DecodeResult lastError()      const { return last_error_; }
+
+private:
+    Wire::Format format_;
+
+    // Legacy: start of a frame that ran past the end of the read
+    uint8_t carry_[FRAME_SIZE];
+    size_t  carry_len_ = 0;
+
+    // COBS: packet bytes since the last delimiter
+    uint8_t cobs_carry_[Wire::MAX_ENCODED];
+    size_t  cobs_len_      = 0;
+    bool    cobs_overflow_ = false;   // packet too long — drop at delimiter
+    bool    cobs_synced_   = false;   // seen a delimiter yet
+
+    quint32            corrupt_    = 0;
+    Wire::DecodeResult last_error_ = Wire::DecodeResult::OK;
+
+    void feedLegacy(const uint8_t* data, size_t len, QVector<CANFrame>& out);
+    void feedCobs(uint8_t* data, size_t len, QVector<CANFrame>& out);
+    void decodeCobs(uint8_t* pkt, size_t len, QVector<CANFrame>& out);
+};
@@ -12,6 +12,7 @@
 #include <QFormLayout>
 #include <QDialogButtonBox>
 #include <QSettings>
+#include <QSlider>
 
 #include "ConnectionManager.hpp"
 #include "CANParser.hpp"
@@ -19,6 +20,9 @@
 #include "FaultInjector.hpp"
 #include "CANMonitor.hpp"
 #include "DTCViewer.hpp"
+#include "TaskStatsViewer.hpp"
+#include "TrendChart.hpp"
+#include "CampaignEngine.hpp"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -33,22 +37,34 @@ private slots:
     void onCANConnected();
     void onCANDisconnected();
     void onStatusMessage(const QString& msg);
+    void toggleRecording(bool on);
+    void openReplay();
 
 private:
     // Core components
     ConnectionManager* conn_mgr_  = nullptr;
     CANParser*         can_parser_= nullptr;
+    CampaignEngine*    campaign_  = nullptr;
 
     // UI panels
     ECUDashboard*  dashboard_  = nullptr;
     FaultInjector* injector_   = nullptr;
     CANMonitor*    can_monitor_= nullptr;
     DTCViewer*     dtc_viewer_ = nullptr;
+    TaskStatsViewer* task_stats_ = nullptr;
+    TrendPanel*    trends_     = nullptr;
 
     // Status bar indicators
     QLabel* ctrl_status_  = nullptr;
     QLabel* can_status_   = nullptr;
 
+    // Capture / replay controls
+    QAction*   record_act_      = nullptr;
+    QAction*   replay_stop_act_ = nullptr;
+    QComboBox* speed_box_       = nullptr;
+    QSlider*   seek_slider_     = nullptr;
+    double     replay_len_s_    = 0;
+
     void buildUI();
     void buildToolbar();
     void wireSignals();
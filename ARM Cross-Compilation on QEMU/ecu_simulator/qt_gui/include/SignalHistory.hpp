@@ -0,0 +1,96 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  SignalHistory
+//
+//  Time series of one CAN signal, kept as a min/max
+//  mipmap so a chart can draw any time window in about
+//  one bucket per pixel:
+//
+//    level 0  raw samples           RAW_CAPACITY
+//    level k  min/max of 8^k        BUCKET_CAPACITY
+//             samples, k = 1..5
+//
+//  Every level is a ring of 16-byte entries, ~13 MB in
+//  all. Level 0 holds the most recent 512 K samples
+//  (9 min at 1 kHz, 14 h at 10 Hz); the coarser levels
+//  reach further back (level 5 spans 2^31 samples —
+//  weeks at 1 kHz), so old history degrades to
+//  envelopes instead of vanishing.
+//  Appending is O(1) amortised; query() picks the finest
+//  level that covers the window with at most FANOUT
+//  entries per column, so its cost depends on the
+//  column count, not on how many samples are stored.
+//
+//  Times are ms since the epoch, stored 32-bit relative
+//  to the first sample and clamped to never go back.
+//  Qt-free, so the bench (bench/) links it directly.
+// ─────────────────────────────────────────────────────
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SignalHistory {
+public:
+    static constexpr int    FANOUT          = 8;
+    static constexpr int    LEVELS          = 6;
+    static constexpr size_t RAW_CAPACITY    = size_t{1} << 19;
+    static constexpr size_t BUCKET_CAPACITY = size_t{1} << 16;
+
+    // One chart column: value envelope of the samples in it
+    struct Column {
+        float min;
+        float max;
+        bool  valid;
+    };
+
+    SignalHistory();
+
+    void append(int64_t t_ms, float value);
+    void clear();
+
+    bool    empty()     const { return raw_.size() == 0; }
+    int64_t firstTime() const;   // oldest sample still held at any level
+    int64_t lastTime()  const { return origin_ms_ + last_t_; }
+    float   lastValue() const { return last_v_; }
+
+    // Envelope of [t0_ms, t1_ms) split into `columns` equal slices
+    void query(int64_t t0_ms, int64_t t1_ms, int columns, std::vector<Column>& out) const;
+
+private:
+    struct Entry {        // level 0: t0 == t1, min == max
+        uint32_t t0, t1;
+        float    min, max;
+    };
+
+    // Fixed-capacity ring, oldest first
+    class Ring {
+    public:
+        explicit Ring(size_t capacity) : buf_(capacity) {}
+        void   push(const Entry& e);
+        size_t size() const          { return size_; }
+        const Entry& at(size_t i) const { return buf_[(start_ + i) % buf_.size()]; }
+        size_t lowerBound(uint32_t t) const;   // first entry with t1 >= t
+        void   clear()               { start_ = size_ = 0; }
+
+    private:
+        std::vector<Entry> buf_;
+        size_t start_ = 0;
+        size_t size_  = 0;
+    };
+
+    // Bucket being filled on each level above 0
+    struct Partial {
+        Entry e;
+        int   n = 0;
+    };
+
+    Ring                 raw_;
+    std::vector<Ring>    levels_;     // levels_[k - 1] is level k
+    std::vector<Partial> partial_;    // partial_[k - 1] feeds level k
+    int64_t  origin_ms_ = 0;
+    uint32_t last_t_    = 0;
+    float    last_v_    = 0;
+
+    const Ring& level(int k) const { return k == 0 ? raw_ : levels_[static_cast<size_t>(k - 1)]; }
+    void        addToLevel(int k, const Entry& e);
+};
@@ -0,0 +1,55 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  TaskStatsViewer
+//
+//  Live firmware run-time diagnostics (CAN 0x7F0/0x7F1,
+//  published by the watchdog task once per second):
+//    - per-task CPU %, stack high-water mark, worst
+//      period jitter and missed deadlines
+//    - session worst jitter, so a one-off spike stays
+//      visible after it scrolls out of the 1 s window
+//    - sample ring / fault queue fill, peak CAN TX batch
+// ─────────────────────────────────────────────────────
+#include <QWidget>
+#include <QTableWidget>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include "CANParser.hpp"
+
+class TaskStatsViewer : public QWidget {
+    Q_OBJECT
+public:
+    explicit TaskStatsViewer(QWidget* parent = nullptr);
+
+public slots:
+    void updateTaskStats(TaskStats stats);
+    void updateQueueStats(QueueStats stats);
+    void resetPeaks();
+
+private:
+    QTableWidget* table_      = nullptr;
+    QLabel*       load_lbl_   = nullptr;
+    QPushButton*  reset_btn_  = nullptr;
+
+    QProgressBar* ring_bar_   = nullptr;
+    QProgressBar* fault_bar_  = nullptr;
+    QProgressBar* tx_bar_     = nullptr;
+    QLabel*       ring_lbl_   = nullptr;
+
+    static constexpr int NUM_TASKS = static_cast<int>(TaskId::COUNT);
+    int      worst_jitter_[NUM_TASKS] = {};
+    int      missed_total_[NUM_TASKS] = {};
+    uint32_t ring_drops_total_ = 0;
+
+    // Below this many free stack words a task is flagged
+    static constexpr int STACK_LOW_WORDS = 64;
+    // Jitter above one tick (1 ms) is flagged
+    static constexpr int JITTER_WARN_US  = 1000;
+
+    QProgressBar* makeQueueBar();
+    static void setQueueBar(QProgressBar* bar, int fill, int cap);
+    static QString taskName(int id);
+};
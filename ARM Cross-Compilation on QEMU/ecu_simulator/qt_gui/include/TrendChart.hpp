@@ -0,0 +1,95 @@
+#pragma once
+// ─────────────────────────────────────────────────────
+//  TrendChart / TrendPanel
+//
+//  History plots of RPM, coolant and battery voltage.
+//
+//  TrendChart draws one SignalHistory over a time window.
+//  Each repaint asks the history for one min/max column
+//  per pixel and draws those as a single polyline, so a
+//  window over millions of samples costs the same as one
+//  over a hundred. Wheel zooms around the cursor, drag
+//  pans, double-click goes back to following live data.
+//
+//  TrendPanel owns the three histories, fills them from
+//  the decoded-frame batches (10 Hz frames and the 1 kHz
+//  sample stream), keeps the charts on a shared window
+//  and repaints at most REFRESH_HZ.
+// ─────────────────────────────────────────────────────
+#include <vector>
+#include <QWidget>
+#include <QColor>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QTimer>
+#include <QVector>
+#include "FrameDecoder.hpp"
+#include "SignalHistory.hpp"
+
+class TrendChart : public QWidget {
+    Q_OBJECT
+
+public:
+    TrendChart(const QString& title, const QString& unit, const QColor& color,
+               const SignalHistory* history, QWidget* parent = nullptr);
+
+    void setWindow(int64_t t0_ms, int64_t t1_ms);
+
+signals:
+    // User zoomed or panned
+    void windowRequested(qint64 t0_ms, qint64 t1_ms);
+    void followRequested();
+
+protected:
+    void paintEvent(QPaintEvent*) override;
+    void wheelEvent(QWheelEvent* ev) override;
+    void mousePressEvent(QMouseEvent* ev) override;
+    void mouseMoveEvent(QMouseEvent* ev) override;
+    void mouseDoubleClickEvent(QMouseEvent* ev) override;
+
+private:
+    static constexpr int LEFT_MARGIN   = 56;
+    static constexpr int RIGHT_MARGIN  = 8;
+    static constexpr int TOP_MARGIN    = 20;
+    static constexpr int BOTTOM_MARGIN = 18;
+
+    QString              title_, unit_;
+    QColor               color_;
+    const SignalHistory* history_;
+    int64_t              t0_ = 0, t1_ = 1;
+
+    std::vector<SignalHistory::Column> cols_;   // reused across repaints
+    int     drag_x_  = 0;
+    int64_t drag_t0_ = 0;
+
+    QRect plotRect() const;
+};
+
+class TrendPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit TrendPanel(QWidget* parent = nullptr);
+
+public slots:
+    void addFrames(const QVector<DecodedFrame>& frames);   // one drain tick
+    void clear();
+
+private:
+    static constexpr int REFRESH_HZ = 30;
+
+    SignalHistory rpm_, coolant_, battery_;
+    QVector<TrendChart*> charts_;
+    QVector<QPushButton*> span_btns_;
+    QCheckBox* follow_chk_ = nullptr;
+    QTimer*    refresh_    = nullptr;
+
+    int64_t span_ms_      = 60'000;
+    int64_t t0_ = 0, t1_ = 1;
+    int64_t sample_t_ms_  = 0;       // running time of the 1 kHz sample stream
+    bool    dirty_        = false;
+
+    void setWindow(int64_t t0_ms, int64_t t1_ms);
+    void refresh();
+    int64_t newest() const;
+};
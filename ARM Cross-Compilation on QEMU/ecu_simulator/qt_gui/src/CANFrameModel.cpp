@@ -0,0 +1,96 @@
+#include "CANFrameModel.hpp"
+#include <QBrush>
+#include <QColor>
+
+namespace {
+
+QColor rowColor(const DecodedFrame& frame) {
+    if (frame.is_fault)         return QColor(60, 20, 20);    // dark red for faults
+    if (frame.id == CAN_ID_RPM) return QColor(16, 28, 42);    // subtle blue for RPM
+    return QColor();                                           // default
+}
+
+} // namespace
+
+CANFrameModel::CANFrameModel(QObject* parent) : QAbstractTableModel(parent) {}
+
+int CANFrameModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : store_.rows();
+}
+
+int CANFrameModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant CANFrameModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    static const char* const titles[COL_COUNT] = {"Time", "ID", "Name", "Value", "Len", "Raw (hex)"};
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return {};
+    if (section < 0 || section >= COL_COUNT) return {};
+    return QString::fromLatin1(titles[section]);
+}
+
+QVariant CANFrameModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return {};
+    const DecodedFrame& f = frameAt(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case COL_TIME:  return FrameDecoder::timeText(f);
+        case COL_ID:    return FrameDecoder::idText(f);
+        case COL_NAME:  return QString::fromUtf8(FrameDecoder::name(f.id));
+        case COL_VALUE: return FrameDecoder::valueText(f);
+        case COL_LEN:   return static_cast<int>(f.len);
+        case COL_RAW:   return FrameDecoder::rawText(f);
+        default:        return {};
+        }
+
+    case Qt::TextAlignmentRole:
+        if (index.column() == COL_ID || index.column() == COL_LEN)
+            return int(Qt::AlignCenter | Qt::AlignVCenter);
+        return int(Qt::AlignVCenter | Qt::AlignLeft);
+
+    case Qt::BackgroundRole: {
+        QColor bg = rowColor(f);
+        return bg.isValid() ? QVariant(QBrush(bg)) : QVariant();
+    }
+
+    default:
+        return {};
+    }
+}
+
+void CANFrameModel::append(const QVector<DecodedFrame>& frames) {
+    const int n = static_cast<int>(frames.size());
+    if (n == 0) return;
+
+    // Net change at the bottom; rows lost at the top are a shift
+    const CANFrameStore::Delta d = store_.delta(frames.constData(), n);
+    const int before = rowCount();
+    const int after  = before - d.dropped + d.added;
+
+    if (after > before)      beginInsertRows(QModelIndex(), before, after - 1);
+    else if (after < before) beginRemoveRows(QModelIndex(), after, before - 1);
+    store_.append(frames.constData(), n);
+    if (after > before)      endInsertRows();
+    else if (after < before) endRemoveRows();
+
+    // Full ring: every row now shows a newer frame. One dataChanged
+    // repaints the viewport instead of moving header sections.
+    if (d.dropped > 0 && after > 0) {
+        emit dataChanged(index(0, 0), index(after - 1, COL_COUNT - 1));
+        emit historyShifted(d.dropped);
+    }
+}
+
+void CANFrameModel::clear() {
+    beginResetModel();
+    store_.clear();
+    endResetModel();
+}
+
+void CANFrameModel::setFilter(const CANFrameStore::Filter& filter) {
+    beginResetModel();
+    store_.setFilter(filter);
+    endResetModel();
+}
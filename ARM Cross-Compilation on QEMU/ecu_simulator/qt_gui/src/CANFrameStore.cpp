@@ -0,0 +1,144 @@
+#include "CANFrameStore.hpp"
+#include <algorithm>
+
+// ── Filter ─────────────────────────────────────────────
+
+bool CANFrameStore::Filter::matches(const DecodedFrame& f) const {
+    if (faults_only && !f.is_fault) return false;
+    if (use_range && (f.value < min || f.value > max)) return false;
+    if (!ids.empty() && !std::binary_search(ids.begin(), ids.end(), f.id)) return false;
+    return true;
+}
+
+// ── SeqList ────────────────────────────────────────────
+
+size_t CANFrameStore::SeqList::countBefore(uint64_t seq) const {
+    auto begin = seqs_.begin() + static_cast<std::ptrdiff_t>(head_);
+    return static_cast<size_t>(std::lower_bound(begin, seqs_.end(), seq) - begin);
+}
+
+void CANFrameStore::SeqList::dropBefore(uint64_t seq) {
+    head_ += countBefore(seq);
+    // Compact once the dead prefix outweighs the live part
+    if (head_ > 4096 && head_ > seqs_.size() / 2) {
+        seqs_.erase(seqs_.begin(), seqs_.begin() + static_cast<std::ptrdiff_t>(head_));
+        head_ = 0;
+    }
+}
+
+// ── Store ──────────────────────────────────────────────
+
+CANFrameStore::CANFrameStore() : ring_(HISTORY) {}
+
+CANFrameStore::Delta CANFrameStore::delta(const DecodedFrame* frames, int n) const {
+    const int      skip      = std::max(0, n - HISTORY);
+    const uint64_t kept      = static_cast<uint64_t>(n - skip);
+    const uint64_t new_first = std::max(first_, next_ + kept > HISTORY ? next_ + kept - HISTORY : 0);
+
+    Delta d{};
+    if (!filter_.active()) {
+        d.dropped = static_cast<int>(new_first - first_);
+        d.added   = static_cast<int>(kept);
+        return d;
+    }
+    d.dropped = static_cast<int>(view_.countBefore(new_first));
+    for (int i = skip; i < n; ++i) {
+        if (filter_.matches(frames[i])) d.added++;
+    }
+    return d;
+}
+
+void CANFrameStore::append(const DecodedFrame* frames, int n) {
+    const int skip = std::max(0, n - HISTORY);
+    for (int i = skip; i < n; ++i) {
+        DecodedFrame& f = ring_[static_cast<size_t>(next_ & MASK)];
+        f = frames[i];
+        // Keep the ring sorted by time even if the wall clock steps back
+        if (f.rx_ms < last_ms_) f.rx_ms = last_ms_;
+        last_ms_ = f.rx_ms;
+
+        by_id_[f.id].push(next_);
+        if (f.is_fault) faults_.push(next_);
+        if (filter_.active() && filter_.matches(f)) view_.push(next_);
+        ++next_;
+    }
+
+    if (next_ - first_ > HISTORY) {
+        first_ = next_ - HISTORY;
+        for (auto& entry : by_id_) entry.second.dropBefore(first_);
+        faults_.dropBefore(first_);
+        view_.dropBefore(first_);
+    }
+}
+
+void CANFrameStore::clear() {
+    first_   = next_ = 0;
+    last_ms_ = 0;
+    by_id_.clear();
+    faults_.clear();
+    view_.clear();
+}
+
+void CANFrameStore::setFilter(const Filter& filter) {
+    filter_ = filter;
+    std::sort(filter_.ids.begin(), filter_.ids.end());
+    filter_.ids.erase(std::unique(filter_.ids.begin(), filter_.ids.end()), filter_.ids.end());
+    rebuildView();
+}
+
+void CANFrameStore::rebuildView() {
+    view_.clear();
+    if (!filter_.active()) return;
+
+    // Chosen IDs: merge their lists in sequence order
+    if (!filter_.ids.empty()) {
+        struct Cursor { const SeqList* list; size_t pos; };
+        std::vector<Cursor> cursors;
+        size_t candidates = 0;
+        for (uint16_t id : filter_.ids) {
+            auto it = by_id_.find(id);
+            if (it == by_id_.end() || it->second.size() == 0) continue;
+            cursors.push_back({&it->second, 0});
+            candidates += it->second.size();
+        }
+        view_.reserve(candidates);
+        while (!cursors.empty()) {
+            size_t best = 0;
+            for (size_t c = 1; c < cursors.size(); ++c) {
+                if (cursors[c].list->at(cursors[c].pos) < cursors[best].list->at(cursors[best].pos))
+                    best = c;
+            }
+            Cursor& cur = cursors[best];
+            const uint64_t seq = cur.list->at(cur.pos);
+            if (filter_.matches(at(seq))) view_.push(seq);
+            if (++cur.pos == cur.list->size()) cursors.erase(cursors.begin() + static_cast<std::ptrdiff_t>(best));
+        }
+        return;
+    }
+
+    // Faults only: walk the fault list
+    if (filter_.faults_only) {
+        view_.reserve(faults_.size());
+        for (size_t i = 0; i < faults_.size(); ++i) {
+            const uint64_t seq = faults_.at(i);
+            if (filter_.matches(at(seq))) view_.push(seq);
+        }
+        return;
+    }
+
+    // Value range alone has no index: one linear pass over the ring
+    for (uint64_t seq = first_; seq < next_; ++seq) {
+        if (filter_.matches(at(seq))) view_.push(seq);
+    }
+}
+
+int CANFrameStore::rowAtTime(int64_t rx_ms) const {
+    int lo = 0;
+    int hi = rows();
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (row(mid).rx_ms < rx_ms) lo = mid + 1;
+        else                        hi = mid;
+    }
+    return lo;
+}
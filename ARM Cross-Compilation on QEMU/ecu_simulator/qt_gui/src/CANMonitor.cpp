@@ -1,5 +1,9 @@
 #include "CANMonitor.hpp"
-#include <QTableWidgetItem>
+#include <QDateTime>
+#include <QDoubleValidator>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QTime>
 
 CANMonitor::CANMonitor(QWidget* parent) : QWidget(parent) {
     setStyleSheet("background:#12121e; color:white;");
@@ -14,6 +18,10 @@ CANMonitor::CANMonitor(QWidget* parent) : QWidget(parent) {
     toolbar->addWidget(title);
     toolbar->addStretch();
 
+    count_lbl_ = new QLabel("0 frames", this);
+    count_lbl_->setStyleSheet("color:#888; font-size:11px;");
+    toolbar->addWidget(count_lbl_);
+
     pause_chk_ = new QCheckBox("Pause", this);
     pause_chk_->setStyleSheet("color:#aaa;");
     toolbar->addWidget(pause_chk_);
@@ -30,6 +38,7 @@ CANMonitor::CANMonitor(QWidget* parent) : QWidget(parent) {
         "QPushButton:hover{background:#444;}");
     toolbar->addWidget(clear_btn_);
     root->addLayout(toolbar);
+    root->addLayout(setupFilterBar());
 
     // ── Table ──────────────────────────────────────
     setupTable();
@@ -39,64 +48,186 @@ CANMonitor::CANMonitor(QWidget* parent) : QWidget(parent) {
 }
 
 void CANMonitor::setupTable() {
-    table_ = new QTableWidget(0, 6, this);
-    table_->setHorizontalHeaderLabels({"Time", "ID", "Name", "Value", "Len", "Raw (hex)"});
+    model_ = new CANFrameModel(this);
+    table_ = new QTableView(this);
+    table_->setModel(model_);
     table_->setStyleSheet(
-        "QTableWidget{background:#12121e;color:#ddd;gridline-color:#2a2a3e;"
-        "selection-background-color:#2a2a4e;border:none;}"
+        "QTableView{background:#12121e;color:#ddd;gridline-color:#2a2a3e;"
+        "selection-background-color:#2a2a4e;border:none;font-size:11px;}"
         "QHeaderView::section{background:#1e1e30;color:#aaa;border:none;"
         "padding:4px;font-size:11px;border-bottom:1px solid #333;}"
-        "QTableWidget::item{padding:3px 6px;font-size:11px;}");
+        "QTableView::item{padding:3px 6px;}");
     table_->setSelectionBehavior(QAbstractItemView::SelectRows);
     table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->setVerticalScrollMode(QAbstractItemView::ScrollPerItem);
     table_->setAlternatingRowColors(false);
-    table_->verticalHeader()->setVisible(false);
-    table_->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-    table_->horizontalHeader()->setStretchLastSection(true);
     table_->setShowGrid(true);
     table_->setWordWrap(false);
+
+    // Uniform rows: the view never measures a row, whatever the history size
+    QHeaderView* rows = table_->verticalHeader();
+    rows->setVisible(false);
+    rows->setSectionResizeMode(QHeaderView::Fixed);
+    rows->setDefaultSectionSize(ROW_HEIGHT);
+
+    // Fixed column widths — ResizeToContents would sample rows every tick
+    QHeaderView* cols = table_->horizontalHeader();
+    cols->setSectionResizeMode(QHeaderView::Interactive);
+    cols->resizeSection(CANFrameModel::COL_TIME,  96);
+    cols->resizeSection(CANFrameModel::COL_ID,    56);
+    cols->resizeSection(CANFrameModel::COL_NAME,  110);
+    cols->resizeSection(CANFrameModel::COL_VALUE, 320);
+    cols->resizeSection(CANFrameModel::COL_LEN,   40);
+    cols->setStretchLastSection(true);
+
+    connect(model_, &CANFrameModel::historyShifted, this, &CANMonitor::onHistoryShifted);
 }
 
-void CANMonitor::addFrame(const DecodedFrame& frame) {
-    if (pause_chk_->isChecked()) return;
+QHBoxLayout* CANMonitor::setupFilterBar() {
+    auto* bar = new QHBoxLayout;
+    const char* edit_style = "background:#0d0d1a;color:white;border:1px solid #333;"
+                             "border-radius:4px;padding:2px 4px;font-size:11px;";
+    auto label = [this, bar](const char* text) {
+        auto* l = new QLabel(text, this);
+        l->setStyleSheet("color:#888; font-size:11px;");
+        bar->addWidget(l);
+    };
 
-    // Enforce row limit — remove oldest
-    if (table_->rowCount() >= MAX_ROWS) {
-        table_->removeRow(0);
+    label("IDs");
+    ids_edit_ = new QLineEdit(this);
+    ids_edit_->setPlaceholderText("hex, e.g. 100 7E0");
+    ids_edit_->setStyleSheet(edit_style);
+    ids_edit_->setMaximumWidth(150);
+    bar->addWidget(ids_edit_);
+
+    label("Value");
+    auto* validator = new QDoubleValidator(this);
+    min_edit_ = new QLineEdit(this);
+    max_edit_ = new QLineEdit(this);
+    for (QLineEdit* e : {min_edit_, max_edit_}) {
+        e->setValidator(validator);
+        e->setStyleSheet(edit_style);
+        e->setMaximumWidth(70);
     }
+    min_edit_->setPlaceholderText("min");
+    max_edit_->setPlaceholderText("max");
+    bar->addWidget(min_edit_);
+    bar->addWidget(max_edit_);
+
+    faults_chk_ = new QCheckBox("Faults only", this);
+    faults_chk_->setStyleSheet("color:#aaa;");
+    bar->addWidget(faults_chk_);
+    bar->addStretch();
+
+    label("Go to");
+    goto_edit_ = new QLineEdit(this);
+    goto_edit_->setPlaceholderText("hh:mm:ss.zzz");
+    goto_edit_->setStyleSheet(edit_style);
+    goto_edit_->setMaximumWidth(110);
+    bar->addWidget(goto_edit_);
+
+    for (QLineEdit* e : {ids_edit_, min_edit_, max_edit_})
+        connect(e, &QLineEdit::editingFinished, this, &CANMonitor::applyFilter);
+    connect(faults_chk_, &QCheckBox::toggled,         this, &CANMonitor::applyFilter);
+    connect(goto_edit_,  &QLineEdit::returnPressed,   this, &CANMonitor::jumpToTime);
+    return bar;
+}
 
-    int row = table_->rowCount();
-    table_->insertRow(row);
+void CANMonitor::applyFilter() {
+    CANFrameStore::Filter f;
+
+    const QStringList tokens = ids_edit_->text().split(QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+    for (const QString& t : tokens) {
+        bool ok = false;
+        const uint id = t.toUInt(&ok, 16);   // accepts a 0x prefix too
+        if (!ok || id > 0x7FF) {
+            ids_edit_->setToolTip(QStringLiteral("Not an 11-bit CAN ID: ") + t);
+            ids_edit_->setStyleSheet(ids_edit_->styleSheet() + "border-color:#c0392b;");
+            return;
+        }
+        f.ids.push_back(static_cast<uint16_t>(id));
+    }
 
-    auto item = [&](const QString& text, Qt::Alignment align = Qt::AlignVCenter | Qt::AlignLeft) {
-        auto* it = new QTableWidgetItem(text);
-        it->setTextAlignment(align);
-        QColor bg = rowColor(frame);
-        if (bg.isValid()) it->setBackground(bg);
-        return it;
-    };
+    ids_edit_->setToolTip(QString());
+    ids_edit_->setStyleSheet(ids_edit_->styleSheet().remove("border-color:#c0392b;"));
+
+    f.faults_only = faults_chk_->isChecked();
+    const bool has_min = !min_edit_->text().isEmpty();
+    const bool has_max = !max_edit_->text().isEmpty();
+    if (has_min || has_max) {
+        f.use_range = true;
+        f.min = has_min ? min_edit_->text().toDouble() : -1e300;
+        f.max = has_max ? max_edit_->text().toDouble() :  1e300;
+    }
+
+    const CANFrameStore::Filter& cur = model_->filter();
+    if (f.ids == cur.ids && f.faults_only == cur.faults_only && f.use_range == cur.use_range
+        && f.min == cur.min && f.max == cur.max) {
+        updateCount();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    model_->setFilter(f);
+    count_lbl_->setToolTip(QStringLiteral("Filter built in %1 ms").arg(timer.elapsed()));
+    updateCount();
+    if (auto_scroll_->isChecked()) table_->scrollToBottom();
+}
 
-    QString time_str = frame.timestamp.toString("hh:mm:ss.zzz");
-    QString raw_hex  = frame.raw_data.toHex(' ').toUpper();
+// Time of day on the date of the newest frame; the rows are time-sorted
+void CANMonitor::jumpToTime() {
+    const int rows = model_->rowCount();
+    if (rows == 0) return;
 
-    table_->setItem(row, 0, item(time_str));
-    table_->setItem(row, 1, item(frame.id_str, Qt::AlignCenter | Qt::AlignVCenter));
-    table_->setItem(row, 2, item(frame.name));
-    table_->setItem(row, 3, item(frame.value_str));
-    table_->setItem(row, 4, item(QString::number(frame.len), Qt::AlignCenter | Qt::AlignVCenter));
-    table_->setItem(row, 5, item(raw_hex));
+    QTime t = QTime::fromString(goto_edit_->text().trimmed(), "hh:mm:ss.zzz");
+    if (!t.isValid()) t = QTime::fromString(goto_edit_->text().trimmed(), "hh:mm:ss");
+    if (!t.isValid()) {
+        goto_edit_->setToolTip(QStringLiteral("Time must be hh:mm:ss[.zzz]"));
+        return;
+    }
+    goto_edit_->setToolTip(QString());
+
+    const QDate day = QDateTime::fromMSecsSinceEpoch(model_->frameAt(rows - 1).rx_ms).date();
+    const int row   = qMin(model_->rowAtTime(QDateTime(day, t).toMSecsSinceEpoch()), rows - 1);
+
+    auto_scroll_->setChecked(false);
+    const QModelIndex idx = model_->index(row, 0);
+    table_->scrollTo(idx, QAbstractItemView::PositionAtTop);
+    table_->selectRow(row);
+}
+
+void CANMonitor::updateCount() {
+    if (model_->filter().active()) {
+        count_lbl_->setText(QStringLiteral("%1 of %2 frames")
+                                .arg(model_->rowCount()).arg(model_->totalFrames()));
+    } else {
+        count_lbl_->setText(QStringLiteral("%1 frames").arg(model_->rowCount()));
+    }
+}
 
+void CANMonitor::addFrame(const DecodedFrame& frame) {
+    addFrames({frame});
+}
+
+void CANMonitor::addFrames(const QVector<DecodedFrame>& frames) {
+    if (pause_chk_->isChecked() || frames.isEmpty()) return;
+
+    model_->append(frames);
+    updateCount();
     if (auto_scroll_->isChecked()) {
         table_->scrollToBottom();
     }
 }
 
-void CANMonitor::clearLog() {
-    table_->setRowCount(0);
+// Full ring: rows moved up — keep what the user is reading in place
+void CANMonitor::onHistoryShifted(int rows) {
+    if (auto_scroll_->isChecked()) return;
+    QScrollBar* bar = table_->verticalScrollBar();
+    bar->setValue(bar->value() - rows);
 }
 
-QColor CANMonitor::rowColor(const DecodedFrame& frame) {
-    if (frame.is_fault)         return QColor(60, 20, 20);    // dark red for faults
-    if (frame.id == CAN_ID_RPM) return QColor(16, 28, 42);    // subtle blue for RPM
-    return QColor();                                           // default
+void CANMonitor::clearLog() {
+    model_->clear();
+    updateCount();
 }
@@ -1,120 +1,121 @@
 #include "CANParser.hpp"
 
-CANParser::CANParser(QObject* parent) : QObject(parent) {}
+CANParser::CANParser(DecodedFrameRing* ring, QObject* parent)
+    : QObject(parent), ring_(ring)
+{
+    batch_.reserve(static_cast<int>(DecodedFrameRing::capacity()));
 
-void CANParser::parseFrame(CANFrame frame) {
-    QByteArray raw(reinterpret_cast<const char*>(frame.data), frame.len);
-
-    switch (frame.id) {
+    drain_timer_ = new QTimer(this);
+    drain_timer_->setTimerType(Qt::PreciseTimer);
+    drain_timer_->setInterval(1000 / DRAIN_HZ);
+    connect(drain_timer_, &QTimer::timeout, this, &CANParser::drain);
+    drain_timer_->start();
+}
 
-    case CAN_ID_RPM: {
-        if (frame.len < 2) return;
-        int rpm = (frame.data[0] << 8) | frame.data[1];
-        emit rpmUpdated(rpm);
-        emit frameDecoded(makeFrame(frame, "RPM", rpm, "rpm"));
-        break;
-    }
+// ── GUI thread: drain the worker's ring ────────────────
 
-    case CAN_ID_THROTTLE: {
-        if (frame.len < 1) return;
-        int pct = frame.data[0];
-        emit throttleUpdated(pct);
-        emit frameDecoded(makeFrame(frame, "Throttle", pct, "%"));
-        break;
+void CANParser::drain() {
+    // Take only what is queued now so a flood cannot pin this tick
+    size_t n = ring_->size();
+    if (n != 0) {
+        batch_.clear();
+        while (n-- > 0) {
+            batch_.append(*ring_->front());
+            ring_->pop();
+        }
+        for (const DecodedFrame& df : batch_) dispatch(df);
+        emit framesDecoded(batch_);
     }
 
-    case CAN_ID_COOLANT_TEMP: {
-        if (frame.len < 2) return;
-        // Signed 16-bit, scaled ×10
-        int16_t raw16 = static_cast<int16_t>((frame.data[0] << 8) | frame.data[1]);
-        double  degC  = raw16 / 10.0;
-        emit coolantTempUpdated(degC);
-        emit frameDecoded(makeFrame(frame, "Coolant temp", degC, "°C"));
-        break;
+    quint32 drops = ring_->drops();
+    if (drops != drops_seen_) {
+        drops_seen_ = drops;
+        emit framesDropped(drops);
     }
+}
 
-    case CAN_ID_FUEL_LEVEL: {
-        if (frame.len < 1) return;
-        int pct = frame.data[0];
-        // 0xFF = sensor disconnected
-        emit fuelLevelUpdated(pct == 0xFF ? -1 : pct);
-        emit frameDecoded(makeFrame(frame, "Fuel level",
-                                    pct == 0xFF ? -1.0 : pct, "%"));
-        break;
-    }
+void CANParser::dispatch(const DecodedFrame& df) {
+    const uint8_t* d = df.data;
 
-    case CAN_ID_VOLTAGE: {
-        if (frame.len < 2) return;
-        uint16_t mv    = static_cast<uint16_t>((frame.data[0] << 8) | frame.data[1]);
-        double   volts = mv / 1000.0;
-        emit batteryVoltageUpdated(volts);
-        emit frameDecoded(makeFrame(frame, "Battery", volts, "V"));
-        break;
-    }
+    switch (df.id) {
+    case CAN_ID_RPM:          emit rpmUpdated(static_cast<int>(df.value));         break;
+    case CAN_ID_THROTTLE:     emit throttleUpdated(static_cast<int>(df.value));    break;
+    case CAN_ID_COOLANT_TEMP: emit coolantTempUpdated(df.value);                   break;
+    case CAN_ID_FUEL_LEVEL:   emit fuelLevelUpdated(static_cast<int>(df.value));   break;
+    case CAN_ID_VOLTAGE:      emit batteryVoltageUpdated(df.value);                break;
 
     case CAN_ID_FAULT: {
-        if (frame.len < 1) return;
-        uint8_t mask = frame.data[0];
+        uint8_t mask = d[0];
         // data[1] carries engine_state when len >= 2
-        if (frame.len >= 2) {
-            emit engineStateUpdated(static_cast<int>(frame.data[1]));
+        if (df.len >= 2) {
+            emit engineStateUpdated(static_cast<int>(d[1]));
         } else {
             // Infer: any fault → fault state; no fault → running (if we had RPM)
             emit engineStateUpdated(mask ? 3 : 2);
         }
         emit faultMaskUpdated(mask);
-        DecodedFrame df = makeFrame(frame, "Fault mask", mask, "");
-        df.is_fault  = (mask != 0);
-        df.value_str = QStringLiteral("0x%1").arg(mask, 2, 16, QLatin1Char('0')).toUpper();
-        emit frameDecoded(df);
         break;
     }
 
-    case CAN_ID_DTC: {
-        if (frame.len < 3) return;
-        uint16_t code  = static_cast<uint16_t>((frame.data[0] << 8) | frame.data[1]);
-        uint8_t  count = frame.data[2];
-        emit dtcReceived(code, count);
-        DecodedFrame df = makeFrame(frame, "DTC", code, "");
-        df.is_fault  = true;
-        df.value_str = QStringLiteral("P%1 ×%2")
-                           .arg(code, 4, 16, QLatin1Char('0')).toUpper()
-                           .arg(count);
-        emit frameDecoded(df);
+    case CAN_ID_DTC:
+        emit dtcReceived(static_cast<uint16_t>((d[0] << 8) | d[1]), d[2]);
+        break;
+
+    case CAN_ID_DTC_RECORD: {
+        int index = d[5];
+        int total = d[6];
+        if (index == 0) emit dtcDumpStarted();
+        if (total == 0) break;
+
+        dtc_pending_ = DTCRecord{};
+        dtc_pending_.code        = static_cast<uint16_t>((d[0] << 8) | d[1]);
+        dtc_pending_.active      = (d[2] & 0x01) != 0;
+        dtc_pending_.count       = d[3];
+        dtc_pending_.last_seen_s = d[7];
+        dtc_pending_ff_          = d[4];
+        if (dtc_pending_ff_ == 0) emit dtcRecordReceived(dtc_pending_);
         break;
     }
 
-    default: {
-        // Unknown frame — pass through to monitor
-        DecodedFrame df;
-        df.timestamp = QDateTime::currentDateTime();
-        df.id        = frame.id;
-        df.id_str    = QStringLiteral("0x%1").arg(frame.id, 3, 16, QLatin1Char('0')).toUpper();
-        df.name      = "Unknown";
-        df.len       = frame.len;
-        df.raw_data  = QByteArray(reinterpret_cast<const char*>(frame.data), frame.len);
-        df.value     = 0;
-        df.value_str = df.raw_data.toHex(' ').toUpper();
-        df.unit      = "";
-        emit frameDecoded(df);
+    case CAN_ID_DTC_FREEZE: {
+        // A freeze frame without a pending record (lost 0x7E9) is only displayed
+        if (dtc_pending_ff_ == 0) break;
+        DTCFreezeFrame ff{};
+        ff.rpm        = (d[0] << 8) | d[1];
+        ff.coolant_c  = static_cast<int16_t>((d[2] << 8) | d[3]);
+        ff.battery_mv = (d[4] << 8) | d[5];
+        ff.age_s      = ((d[6] << 8) | d[7]) / 10.0;
+        dtc_pending_.freeze_frames.append(ff);
+        if (--dtc_pending_ff_ == 0) emit dtcRecordReceived(dtc_pending_);
         break;
     }
+
+    case CAN_ID_TASK_STATS: {
+        TaskStats ts{};
+        ts.id               = d[0];
+        ts.cpu_pct          = d[1];
+        ts.stack_free_words = (d[2] << 8) | d[3];
+        ts.jitter_us        = (d[4] << 8) | d[5];
+        ts.missed           = d[6];
+        emit taskStatsReceived(ts);
+        break;
     }
-}
 
-DecodedFrame CANParser::makeFrame(const CANFrame& raw, const QString& name,
-                                   double value, const QString& unit) const {
-    DecodedFrame df;
-    df.timestamp = QDateTime::currentDateTime();
-    df.id        = raw.id;
-    df.id_str    = QStringLiteral("0x%1").arg(raw.id, 3, 16, QLatin1Char('0')).toUpper();
-    df.name      = name;
-    df.value     = value;
-    df.unit      = unit;
-    df.len       = raw.len;
-    df.raw_data  = QByteArray(reinterpret_cast<const char*>(raw.data), raw.len);
-    df.value_str = unit.isEmpty()
-                       ? QString::number(value)
-                       : QStringLiteral("%1 %2").arg(value).arg(unit);
-    return df;
+    case CAN_ID_QUEUE_STATS: {
+        QueueStats qs{};
+        qs.ring_fill   = d[0];
+        qs.ring_cap    = d[1];
+        qs.ring_peak   = d[2];
+        qs.ring_drops  = d[3];
+        qs.fault_fill  = d[4];
+        qs.fault_cap   = d[5];
+        qs.tx_batch_peak = d[6];
+        qs.tx_batch_cap  = d[7];
+        emit queueStatsReceived(qs);
+        break;
+    }
+
+    default:
+        break;
+    }
 }
@@ -0,0 +1,214 @@
+#include "CANWorker.hpp"
+#include <QDateTime>
+#include "FrameDecoder.hpp"
+#include <limits>
+
+CANWorker::CANWorker(DecodedFrameRing* ring) : QObject(nullptr), ring_(ring) {}
+
+void CANWorker::open(const QString& portName, int baudRate) {
+    if (reader_.isOpen()) stopReplay();
+    if (!serial_) {
+        serial_ = new QSerialPort(this);
+        connect(serial_, &QSerialPort::readyRead,     this, &CANWorker::onReadyRead);
+        connect(serial_, &QSerialPort::errorOccurred, this, &CANWorker::onError);
+    }
+    if (serial_->isOpen()) serial_->close();
+
+    serial_->setPortName(portName);
+    serial_->setBaudRate(baudRate);
+    serial_->setDataBits(QSerialPort::Data8);
+    serial_->setParity(QSerialPort::NoParity);
+    serial_->setStopBits(QSerialPort::OneStop);
+    serial_->setFlowControl(QSerialPort::NoFlowControl);
+
+    scanner_.reset(scanner_.format());
+    corrupt_.store(0, std::memory_order_relaxed);
+
+    if (serial_->open(QIODevice::ReadOnly)) {
+        emit statusMessage(QStringLiteral("CAN stream connected on ") + portName);
+        emit opened();
+    } else {
+        emit statusMessage(QStringLiteral("CAN serial open failed: ") + serial_->errorString());
+    }
+}
+
+void CANWorker::close() {
+    if (serial_ && serial_->isOpen()) {
+        serial_->close();
+        emit closed();
+    }
+}
+
+void CANWorker::setWireFormat(Wire::Format fmt) {
+    if (fmt == scanner_.format()) return;
+    scanner_.reset(fmt);
+    corrupt_.store(0, std::memory_order_relaxed);
+}
+
+void CANWorker::onReadyRead() {
+    const qint64 avail = serial_->bytesAvailable();
+    if (avail <= 0) return;
+    if (read_buf_.size() < avail) read_buf_.resize(avail);
+    const qint64 n = serial_->read(read_buf_.data(), avail);
+    if (n <= 0) return;
+
+    frames_.clear();
+    scanner_.feed(reinterpret_cast<uint8_t*>(read_buf_.data()), static_cast<size_t>(n), frames_);
+
+    if (scanner_.corruptPackets() != corrupt_.load(std::memory_order_relaxed)) {
+        corrupt_.store(scanner_.corruptPackets(), std::memory_order_relaxed);
+        emit statusMessage(QStringLiteral("CAN packet dropped: %1 (%2 total)")
+                               .arg(QLatin1String(Wire::decode_result_str(scanner_.lastError())))
+                               .arg(scanner_.corruptPackets()));
+    }
+
+    if (writer_.isOpen()) {
+        const int64_t t_us = rec_clock_.nsecsElapsed() / 1000;
+        for (const CANFrame& f : frames_) writer_.append(f, t_us);
+    }
+
+    // One arrival time per read; decode in place into the ring
+    const int64_t rx_ms = QDateTime::currentMSecsSinceEpoch();
+    for (const CANFrame& f : frames_) {
+        DecodedFrame* slot = ring_->acquire();
+        if (!slot) {
+            ring_->note_drop();
+            continue;
+        }
+        if (FrameDecoder::decode(f, rx_ms, *slot)) ring_->commit();
+    }
+}
+
+void CANWorker::onError(QSerialPort::SerialPortError err) {
+    if (err != QSerialPort::NoError) {
+        emit statusMessage(QStringLiteral("Serial error: ") + serial_->errorString());
+        emit closed();
+    }
+}
+
+// ── Recording ──────────────────────────────────────────
+
+void CANWorker::startRecording(const QString& path) {
+    stopRecording();
+    if (!writer_.open(path, QDateTime::currentMSecsSinceEpoch())) {
+        emit statusMessage(QStringLiteral("Capture open failed: ") + writer_.errorString());
+        emit recordingChanged(false);
+        return;
+    }
+    rec_clock_.start();
+    emit statusMessage(QStringLiteral("Recording CAN to ") + path);
+    emit recordingChanged(true);
+}
+
+void CANWorker::stopRecording() {
+    if (!writer_.isOpen()) return;
+    const uint64_t n = writer_.frames();
+    if (writer_.close()) {
+        emit statusMessage(QStringLiteral("Capture saved: %1 frames").arg(n));
+    } else {
+        emit statusMessage(QStringLiteral("Capture write failed: ") + writer_.errorString());
+    }
+    emit recordingChanged(false);
+}
+
+// ── Replay ─────────────────────────────────────────────
+
+void CANWorker::startReplay(const QString& path, double speed) {
+    stopReplay();
+    close();   // one producer: the capture replaces the serial stream
+
+    if (!reader_.open(path)) {
+        emit statusMessage(QStringLiteral("Capture open failed: ") + reader_.errorString());
+        return;
+    }
+    if (!replay_timer_) {
+        replay_timer_ = new QTimer(this);
+        replay_timer_->setTimerType(Qt::PreciseTimer);
+        connect(replay_timer_, &QTimer::timeout, this, &CANWorker::replayTick);
+    }
+
+    replay_pos_  = 0;
+    replay_sent_ = 0;
+    replay_last_report_ms_ = 0;
+    replay_wall_.start();
+    emit replayStarted(reader_.durationUs() / 1e6);
+    emit statusMessage(QStringLiteral("Replaying %1 frames from ").arg(reader_.frameCount()) + path);
+    setReplaySpeed(speed);
+}
+
+void CANWorker::setReplaySpeed(double speed) {
+    const int64_t now_us = reader_.isOpen() ? replayNowUs() : 0;
+    replay_speed_ = speed < 0 ? 0 : speed;
+    if (!reader_.isOpen()) return;
+    rebaseReplay(now_us);
+    // Max speed: tick whenever the event loop is idle
+    if (replay_pos_ < reader_.frameCount()) {
+        replay_timer_->start(replay_speed_ > 0 ? REPLAY_TICK_MS : 0);
+    }
+}
+
+void CANWorker::seekReplay(double pos_s) {
+    if (!reader_.isOpen()) return;
+    const int64_t t_us = static_cast<int64_t>(pos_s * 1e6);
+    replay_pos_ = reader_.frameAtTime(t_us);
+    rebaseReplay(t_us);
+    emit replaySeeked(pos_s);
+    if (!replay_timer_->isActive() && replay_pos_ < reader_.frameCount()) {
+        replay_timer_->start(replay_speed_ > 0 ? REPLAY_TICK_MS : 0);
+    }
+}
+
+void CANWorker::stopReplay() {
+    if (!reader_.isOpen()) return;
+    replay_timer_->stop();
+    reader_.close();
+    emit replayStopped();
+}
+
+int64_t CANWorker::replayNowUs() const {
+    if (replay_speed_ <= 0) return std::numeric_limits<int64_t>::max();
+    return replay_base_us_ + static_cast<int64_t>(replay_clock_.nsecsElapsed() / 1000 * replay_speed_);
+}
+
+void CANWorker::rebaseReplay(int64_t capture_us) {
+    // Max speed has no clock; carry on from the next record
+    if (capture_us == std::numeric_limits<int64_t>::max()) {
+        capture_us = replay_pos_ < reader_.frameCount() ? reader_.record(replay_pos_).t_us
+                                                        : reader_.durationUs();
+    }
+    replay_base_us_ = capture_us;
+    replay_clock_.start();
+}
+
+void CANWorker::replayTick() {
+    const int64_t  now_us = replayNowUs();
+    const uint64_t count  = reader_.frameCount();
+
+    while (replay_pos_ < count) {
+        const Capture::Record& r = reader_.record(replay_pos_);
+        if (r.t_us > now_us) break;
+        DecodedFrame* slot = ring_->acquire();
+        if (!slot) break;   // GUI behind — hold back, never drop a replayed frame
+
+        const int64_t rx_ms = reader_.startMs() + r.t_us / 1000;
+        if (FrameDecoder::decode(CaptureReader::toFrame(r), rx_ms, *slot)) ring_->commit();
+        ++replay_pos_;
+        ++replay_sent_;
+    }
+
+    const int64_t pos_us = replay_pos_ < count ? reader_.record(replay_pos_).t_us : reader_.durationUs();
+    const qint64  wall   = replay_wall_.elapsed();
+    if (wall - replay_last_report_ms_ >= 100) {
+        replay_last_report_ms_ = wall;
+        emit replayPosition(pos_us / 1e6);
+    }
+
+    if (replay_pos_ >= count) {
+        replay_timer_->stop();
+        emit replayPosition(pos_us / 1e6);
+        const double secs = wall / 1000.0;
+        emit statusMessage(QStringLiteral("Replay finished: %1 frames in %2 s (%3 frames/s)")
+                               .arg(replay_sent_).arg(secs, 0, 'f', 2)
+                               .arg(secs > 0 ? replay_sent_ / secs : 0.0, 0, 'f', 0));
+    }
+}
@@ -0,0 +1,350 @@
+#include "CampaignEngine.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include "ConnectionManager.hpp"
+
+namespace {
+
+// Injection command → fault mask bit and the DTC task_diag reports for it
+struct FaultInfo {
+    ControlCmd  cmd;
+    const char* name;       // scenario keyword
+    uint8_t     bit;
+    uint16_t    dtc;
+};
+constexpr FaultInfo FAULTS[] = {
+    {ControlCmd::INJECT_OVERHEAT,    "overheat",     static_cast<uint8_t>(FaultCode::OVERHEAT),     0x0217},
+    {ControlCmd::INJECT_SENSOR_DISC, "sensor_disc",  static_cast<uint8_t>(FaultCode::SENSOR_DISC),  0x0197},
+    {ControlCmd::INJECT_VOLT_DROP,   "voltage_drop", static_cast<uint8_t>(FaultCode::VOLTAGE_DROP), 0x0562},
+};
+
+const FaultInfo* faultFor(ControlCmd cmd) {
+    for (const FaultInfo& f : FAULTS) {
+        if (f.cmd == cmd) return &f;
+    }
+    return nullptr;
+}
+
+// Nearest-rank percentile of a sorted sample
+int64_t percentile(const std::vector<int64_t>& sorted, int pct) {
+    if (sorted.empty()) return -1;
+    size_t i = (sorted.size() * static_cast<size_t>(pct) + 99) / 100;
+    return sorted[std::min(sorted.size(), std::max<size_t>(i, 1)) - 1];
+}
+
+QString distText(std::vector<int64_t> v) {
+    if (v.empty()) return QStringLiteral("—");
+    std::sort(v.begin(), v.end());
+    return QStringLiteral("%1 / %2 / %3")
+        .arg(percentile(v, 50)).arg(percentile(v, 95)).arg(v.back());
+}
+
+} // namespace
+
+CampaignEngine::CampaignEngine(QObject* parent) : QObject(parent) {
+    timer_ = new QTimer(this);
+    timer_->setSingleShot(true);
+    timer_->setTimerType(Qt::PreciseTimer);
+    connect(timer_, &QTimer::timeout, this, &CampaignEngine::tick);
+}
+
+// ── Scenario file ──────────────────────────────────────
+// Same grammar as scripts/ecu_link.py load_scenario()
+
+bool CampaignEngine::load(const QString& path, std::vector<Event>& events,
+                          int64_t& duration_ms, QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = file.errorString();
+        return false;
+    }
+
+    events.clear();
+    duration_ms = -1;
+    int64_t last_t   = 0;
+    int     throttle = 0;
+    int     lineno   = 0;
+    const QString name = QFileInfo(path).fileName();
+    auto fail = [&](const QString& msg) {
+        error = QStringLiteral("%1:%2: %3").arg(name).arg(lineno).arg(msg);
+        return false;
+    };
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        ++lineno;
+        QString line = in.readLine();
+        const int hash = line.indexOf('#');
+        if (hash >= 0) line.truncate(hash);
+        const QStringList tok = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        if (tok.isEmpty()) continue;
+
+        bool ok = tok.size() >= 2;
+        const int64_t t = ok ? tok[0].toLongLong(&ok) : 0;
+        std::vector<int> args;
+        for (int i = 2; ok && i < tok.size(); ++i) args.push_back(tok[i].toInt(&ok));
+        if (!ok) return fail(QStringLiteral("expected '<t_ms> <command> [arg]'"));
+        if (duration_ms >= 0) return fail(QStringLiteral("events after 'end'"));
+        if (t < last_t)       return fail(QStringLiteral("events must be in time order"));
+        last_t = t;
+
+        const QString& cmd = tok[1];
+        const int arg = args.empty() ? 0 : args[0];
+        if (cmd == "throttle") {
+            throttle = qBound(0, arg, 100);
+            events.push_back({t, ControlCmd::SET_THROTTLE, static_cast<uint8_t>(throttle), 0});
+        } else if (cmd == "ramp") {
+            if (args.size() != 2 || args[0] < 0 || args[0] > 100)
+                return fail(QStringLiteral("expected '<t_ms> ramp <0-100> <duration_ms>'"));
+            // One event per 1 % step, the last at t + duration
+            const int to    = args[0];
+            const int steps = std::abs(to - throttle);
+            const int64_t span = std::max(args[1], 0);
+            if (steps == 0 || span == 0) {
+                events.push_back({t + span, ControlCmd::SET_THROTTLE, static_cast<uint8_t>(to), 0});
+            } else {
+                const int sign = to > throttle ? 1 : -1;
+                for (int k = 1; k <= steps; ++k) {
+                    events.push_back({t + span * k / steps, ControlCmd::SET_THROTTLE,
+                                      static_cast<uint8_t>(throttle + sign * k), 0});
+                }
+            }
+            throttle = to;
+        } else if (cmd == "sample_rate") {
+            const uint16_t hz = static_cast<uint16_t>(qBound(0, arg, 1000));
+            events.push_back({t, ControlCmd::SET_SAMPLE_RATE,
+                              static_cast<uint8_t>(hz >> 8), static_cast<uint8_t>(hz & 0xFF)});
+        } else if (cmd == "clear") {
+            events.push_back({t, ControlCmd::CLEAR_FAULTS, 0, 0});
+        } else if (cmd == "dtc_dump") {
+            events.push_back({t, ControlCmd::DTC_DUMP, 0, 0});
+        } else if (cmd == "end") {
+            duration_ms = t;
+        } else {
+            const FaultInfo* f = nullptr;
+            for (const FaultInfo& fi : FAULTS) {
+                if (cmd == fi.name) f = &fi;
+            }
+            if (!f) return fail(QStringLiteral("unknown command '%1'").arg(cmd));
+            events.push_back({t, f->cmd, 0, 0});
+        }
+    }
+
+    if (duration_ms < 0) {
+        error = QStringLiteral("%1: scenario must finish with an 'end' event").arg(name);
+        return false;
+    }
+    // Ramps may run past the lines after them, but not past 'end'
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.t_ms < b.t_ms; });
+    if (!events.empty() && events.back().t_ms > duration_ms) {
+        error = QStringLiteral("%1: a ramp runs past 'end'").arg(name);
+        return false;
+    }
+    return true;
+}
+
+// ── Playback ───────────────────────────────────────────
+
+bool CampaignEngine::start(const QString& path, int runs) {
+    stop();
+    QString error;
+    if (!load(path, events_, duration_ms_, error)) {
+        emit statusMessage(QStringLiteral("Campaign: %1").arg(error));
+        return false;
+    }
+    runs_     = std::max(runs, 1);
+    run_      = 0;
+    next_     = 0;
+    running_  = true;
+    draining_ = false;
+    injections_.clear();
+    first_open_ = 0;
+    lateness_us_.clear();
+    commands_sent_ = 0;
+
+    emit statusMessage(QStringLiteral("Campaign: %1 — %2 commands × %3 runs, %4 s")
+                           .arg(QFileInfo(path).fileName()).arg(events_.size())
+                           .arg(runs_).arg(duration_ms_ * runs_ / 1000.0, 0, 'f', 1));
+    clock_.start();
+    armTimer();
+    return true;
+}
+
+void CampaignEngine::stop() {
+    if (!running_) return;
+    timer_->stop();
+    running_  = false;
+    draining_ = false;
+    emit statusMessage(QStringLiteral("Campaign stopped"));
+    emit finished();
+}
+
+void CampaignEngine::armTimer() {
+    // Next event, or the end of this run when it has none left
+    const int64_t due = next_ < events_.size() ? dueMs(next_) : (run_ + 1) * duration_ms_;
+    timer_->start(static_cast<int>(std::max<int64_t>(0, due - clock_.elapsed())));
+}
+
+void CampaignEngine::tick() {
+    if (draining_) {   // match window is over
+        finish();
+        return;
+    }
+
+    const int64_t now_us = clock_.nsecsElapsed() / 1000;
+    const int64_t now_ms = now_us / 1000;
+
+    // Everything that is due, across run boundaries, in one write
+    QByteArray pkt;
+    int64_t first_due = -1;
+    while (run_ < runs_) {
+        if (next_ >= events_.size()) {
+            if ((run_ + 1) * duration_ms_ > now_ms) break;
+            ++run_;
+            next_ = 0;
+            continue;
+        }
+        if (dueMs(next_) > now_ms) break;
+
+        const Event& e = events_[next_++];
+        if (first_due < 0) first_due = dueMs(next_ - 1);
+        ConnectionManager::appendCommand(pkt, e.cmd, e.arg0, e.arg1);
+        ++commands_sent_;
+
+        if (e.cmd == ControlCmd::CLEAR_FAULTS) last_mask_ = 0;
+        if (const FaultInfo* f = faultFor(e.cmd)) {
+            Injection inj;
+            inj.sent_ms    = QDateTime::currentMSecsSinceEpoch();
+            inj.cmd        = e.cmd;
+            inj.bit        = f->bit;
+            inj.dtc        = f->dtc;
+            inj.was_active = (last_mask_ & f->bit) != 0;
+            injections_.push_back(inj);
+        }
+    }
+    if (!pkt.isEmpty()) {
+        emit commandsReady(pkt);
+        lateness_us_.push_back(now_us - first_due * 1000);
+    }
+
+    const int64_t total_ms = runs_ * duration_ms_;
+    emit progress(std::min(now_ms, total_ms) / 1000.0, total_ms / 1000.0);
+
+    if (run_ >= runs_) {
+        // Give the last injections time to show up in the stream
+        draining_ = true;
+        if (allMatched()) finish();
+        else              timer_->start(static_cast<int>(MATCH_TIMEOUT_MS));
+        return;
+    }
+    armTimer();
+}
+
+void CampaignEngine::finish() {
+    timer_->stop();
+    running_  = false;
+    draining_ = false;
+    emit statusMessage(QStringLiteral("Campaign finished — %1 injections").arg(injections_.size()));
+    emit finished();
+}
+
+// ── Latency matching ───────────────────────────────────
+
+bool CampaignEngine::allMatched() const {
+    for (size_t i = first_open_; i < injections_.size(); ++i) {
+        const Injection& inj = injections_[i];
+        if (inj.dtc_ms < 0 || (!inj.was_active && inj.mask_ms < 0)) return false;
+    }
+    return true;
+}
+
+void CampaignEngine::onFrames(const QVector<DecodedFrame>& frames) {
+    if (!running_) return;
+
+    for (const DecodedFrame& f : frames) {
+        if (f.id != CAN_ID_FAULT && f.id != CAN_ID_DTC) continue;
+        const uint8_t  mask = f.data[0];
+        const uint16_t code = static_cast<uint16_t>((f.data[0] << 8) | f.data[1]);
+
+        // Oldest open injection for each set bit / the DTC code
+        uint8_t unclaimed = f.id == CAN_ID_FAULT ? mask : 0;
+        for (size_t i = first_open_; i < injections_.size(); ++i) {
+            Injection& inj = injections_[i];
+            if (f.rx_ms < inj.sent_ms) break;   // sent after this frame
+            if (f.rx_ms - inj.sent_ms > MATCH_TIMEOUT_MS) continue;
+            if ((unclaimed & inj.bit) && !inj.was_active && inj.mask_ms < 0) {
+                inj.mask_ms = f.rx_ms - inj.sent_ms;
+                unclaimed &= static_cast<uint8_t>(~inj.bit);
+            }
+            if (f.id == CAN_ID_DTC && inj.dtc_ms < 0 && code == inj.dtc) {
+                inj.dtc_ms = f.rx_ms - inj.sent_ms;
+                break;
+            }
+        }
+        if (f.id == CAN_ID_FAULT) last_mask_ = mask;
+    }
+
+    // Skip past injections that are done or can no longer match
+    const int64_t now = QDateTime::currentMSecsSinceEpoch();
+    while (first_open_ < injections_.size()) {
+        const Injection& inj = injections_[first_open_];
+        const bool done = inj.dtc_ms >= 0 && (inj.was_active || inj.mask_ms >= 0);
+        if (!done && now - inj.sent_ms <= MATCH_TIMEOUT_MS) break;
+        ++first_open_;
+    }
+    if (draining_ && first_open_ == injections_.size()) finish();
+}
+
+// ── Results ────────────────────────────────────────────
+
+QString CampaignEngine::summary() const {
+    if (injections_.empty()) return QStringLiteral("No injections yet");
+
+    QString out;
+    QTextStream s(&out);
+    s << QStringLiteral("%1 %2 %3 %4 %5\n")
+             .arg(QStringLiteral("fault"), -13).arg(QStringLiteral("n"), 4)
+             .arg(QStringLiteral("mask p50/p95/max"), 20)
+             .arg(QStringLiteral("DTC p50/p95/max"), 20).arg(QStringLiteral("miss"), 5);
+    for (const FaultInfo& fi : FAULTS) {
+        std::vector<int64_t> mask, dtc;
+        int n = 0, missed = 0;
+        for (const Injection& inj : injections_) {
+            if (inj.cmd != fi.cmd) continue;
+            ++n;
+            if (inj.mask_ms >= 0) mask.push_back(inj.mask_ms);
+            if (inj.dtc_ms  >= 0) dtc.push_back(inj.dtc_ms);
+            if (inj.dtc_ms < 0 || (!inj.was_active && inj.mask_ms < 0)) ++missed;
+        }
+        if (n == 0) continue;
+        s << QStringLiteral("%1 %2 %3 %4 %5\n")
+                 .arg(QString::fromLatin1(fi.name), -13).arg(n, 4)
+                 .arg(distText(mask), 20).arg(distText(dtc), 20).arg(missed, 5);
+    }
+
+    std::vector<int64_t> late = lateness_us_;
+    std::sort(late.begin(), late.end());
+    s << QStringLiteral("latency in ms; %1 commands in %2 writes, send lateness p50 %3 µs, max %4 µs")
+             .arg(commands_sent_).arg(late.size())
+             .arg(percentile(late, 50)).arg(late.empty() ? 0 : late.back());
+    return out;
+}
+
+bool CampaignEngine::saveResults(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
+    QTextStream out(&file);
+    out << "sent_ms,fault,was_active,mask_latency_ms,dtc_latency_ms\n";
+    for (const Injection& inj : injections_) {
+        const FaultInfo* f = faultFor(inj.cmd);
+        out << inj.sent_ms << ',' << (f ? f->name : "?") << ',' << (inj.was_active ? 1 : 0) << ','
+            << inj.mask_ms << ',' << inj.dtc_ms << '\n';
+    }
+    return out.status() == QTextStream::Ok;
+}
@@ -0,0 +1,167 @@
+#include "CaptureFile.hpp"
+#include <algorithm>
+#include <cstring>
+
+// ── Writer ─────────────────────────────────────────────
+
+bool CaptureWriter::open(const QString& path, int64_t start_ms) {
+    close();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    count_     = 0;
+    start_ms_  = start_ms;
+    last_t_us_ = 0;
+    buf_.clear();
+    buf_.reserve(FLUSH_RECORDS);
+    index_.clear();
+
+    // Counts stay 0 until close(), which marks the file complete
+    Capture::FileHeader hdr{};
+    memcpy(hdr.magic, Capture::MAGIC, sizeof(hdr.magic));
+    hdr.version      = Capture::VERSION;
+    hdr.record_size  = sizeof(Capture::Record);
+    hdr.start_ms     = start_ms;
+    hdr.index_stride = Capture::INDEX_STRIDE;
+    if (file_.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr)) != sizeof(hdr)) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+void CaptureWriter::append(const CANFrame& frame, int64_t t_us) {
+    if (!file_.isOpen()) return;
+
+    Capture::Record r{};
+    r.t_us = std::max(t_us, last_t_us_);   // keep the file seekable by time
+    r.id   = frame.id;
+    r.len  = frame.len < 8 ? frame.len : 8;
+    memcpy(r.data, frame.data, sizeof(r.data));
+    last_t_us_ = r.t_us;
+
+    if (count_ % Capture::INDEX_STRIDE == 0) index_.push_back({r.t_us, count_});
+    buf_.push_back(r);
+    ++count_;
+    if (buf_.size() >= FLUSH_RECORDS) flush();
+}
+
+bool CaptureWriter::flush() {
+    if (buf_.empty()) return true;
+    const qint64 bytes = static_cast<qint64>(buf_.size() * sizeof(Capture::Record));
+    const bool ok = file_.write(reinterpret_cast<const char*>(buf_.data()), bytes) == bytes;
+    buf_.clear();
+    return ok;
+}
+
+bool CaptureWriter::close() {
+    if (!file_.isOpen()) return true;
+    bool ok = flush();
+
+    Capture::FileHeader hdr{};
+    memcpy(hdr.magic, Capture::MAGIC, sizeof(hdr.magic));
+    hdr.version      = Capture::VERSION;
+    hdr.record_size  = sizeof(Capture::Record);
+    hdr.start_ms     = start_ms_;
+    hdr.frame_count  = count_;
+    hdr.index_offset = sizeof(hdr) + count_ * sizeof(Capture::Record);
+    hdr.index_stride = Capture::INDEX_STRIDE;
+    hdr.index_count  = static_cast<uint32_t>(index_.size());
+
+    const qint64 index_bytes = static_cast<qint64>(index_.size() * sizeof(Capture::IndexEntry));
+    ok = ok && file_.write(reinterpret_cast<const char*>(index_.data()), index_bytes) == index_bytes;
+    ok = ok && file_.seek(0);
+    ok = ok && file_.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr)) == sizeof(hdr);
+    file_.close();
+    return ok;
+}
+
+// ── Reader ─────────────────────────────────────────────
+
+bool CaptureReader::open(const QString& path) {
+    close();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        error_ = file_.errorString();
+        return false;
+    }
+
+    const qint64 size = file_.size();
+    Capture::FileHeader hdr{};
+    if (size < static_cast<qint64>(sizeof(hdr))
+        || file_.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) != sizeof(hdr)
+        || memcmp(hdr.magic, Capture::MAGIC, sizeof(hdr.magic)) != 0
+        || hdr.version != Capture::VERSION
+        || hdr.record_size != sizeof(Capture::Record)) {
+        error_ = QStringLiteral("not an ECU capture file");
+        file_.close();
+        return false;
+    }
+
+    const uint64_t body      = static_cast<uint64_t>(size) - sizeof(hdr);
+    const uint64_t max_count = body / sizeof(Capture::Record);
+    const bool     complete  = hdr.index_offset != 0
+        && hdr.frame_count <= max_count
+        && hdr.index_offset == sizeof(hdr) + hdr.frame_count * sizeof(Capture::Record)
+        && hdr.index_offset + uint64_t{hdr.index_count} * sizeof(Capture::IndexEntry)
+               <= static_cast<uint64_t>(size);
+
+    count_    = complete ? hdr.frame_count : max_count;   // cut short: use what is there
+    start_ms_ = hdr.start_ms;
+
+    map_ = file_.map(0, size);
+    if (!map_) {
+        error_ = file_.errorString();
+        file_.close();
+        return false;
+    }
+    records_ = reinterpret_cast<const Capture::Record*>(map_ + sizeof(hdr));
+    if (complete && hdr.index_stride == Capture::INDEX_STRIDE) {
+        index_       = reinterpret_cast<const Capture::IndexEntry*>(map_ + hdr.index_offset);
+        index_count_ = hdr.index_count;
+    }
+    error_.clear();
+    return true;
+}
+
+void CaptureReader::close() {
+    if (map_) file_.unmap(map_);
+    if (file_.isOpen()) file_.close();
+    map_         = nullptr;
+    records_     = nullptr;
+    index_       = nullptr;
+    index_count_ = 0;
+    count_       = 0;
+}
+
+CANFrame CaptureReader::toFrame(const Capture::Record& r) {
+    CANFrame f{};
+    f.sof = FRAME_SOF;
+    f.id  = r.id;
+    f.len = r.len;
+    memcpy(f.data, r.data, sizeof(f.data));
+    f.eof = FRAME_EOF;
+    return f;
+}
+
+uint64_t CaptureReader::frameAtTime(int64_t t_us) const {
+    uint64_t lo = 0;
+    uint64_t hi = count_;
+
+    // The index narrows the search to one stride of records,
+    // so a seek touches a couple of pages, not log2(N)
+    if (index_count_ > 0) {
+        const Capture::IndexEntry* end = index_ + index_count_;
+        const Capture::IndexEntry* it  = std::lower_bound(index_, end, t_us,
+            [](const Capture::IndexEntry& e, int64_t t) { return e.t_us < t; });
+        if (it != index_) lo = (it - 1)->frame;
+        if (it != end)    hi = std::min(hi, it->frame + 1);
+    }
+
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (records_[mid].t_us < t_us) lo = mid + 1;
+        else                           hi = mid;
+    }
+    return lo;
+}
@@ -1,11 +1,11 @@
 #include "ConnectionManager.hpp"
+#include "CANWorker.hpp"
 #include <QDebug>
 
 ConnectionManager::ConnectionManager(QObject* parent)
     : QObject(parent)
 {
-    tcp_    = new QTcpSocket(this);
-    serial_ = new QSerialPort(this);
+    tcp_ = new QTcpSocket(this);
 
     // TCP signals
     connect(tcp_, &QTcpSocket::connected,    this, &ConnectionManager::onTcpConnected);
@@ -13,9 +13,27 @@ ConnectionManager::ConnectionManager(QObject* parent)
     connect(tcp_, &QTcpSocket::readyRead,    this, &ConnectionManager::onTcpReadyRead);
     connect(tcp_, &QTcpSocket::errorOccurred,this, &ConnectionManager::onTcpError);
 
-    // Serial signals
-    connect(serial_, &QSerialPort::readyRead, this, &ConnectionManager::onSerialReadyRead);
-    connect(serial_, &QSerialPort::errorOccurred, this, &ConnectionManager::onSerialError);
+    // CAN worker thread — signals arrive queued on the GUI thread
+    can_thread_ = new QThread(this);
+    can_thread_->setObjectName("CAN");
+    worker_ = new CANWorker(&ring_);
+    worker_->moveToThread(can_thread_);
+    connect(can_thread_, &QThread::finished, worker_, &QObject::deleteLater);
+    connect(worker_, &CANWorker::opened, this, [this]{
+        can_open_ = true;
+        emit canConnected();
+    });
+    connect(worker_, &CANWorker::closed, this, [this]{
+        can_open_ = false;
+        emit canDisconnected();
+    });
+    connect(worker_, &CANWorker::statusMessage,    this, &ConnectionManager::statusMessage);
+    connect(worker_, &CANWorker::recordingChanged, this, &ConnectionManager::recordingChanged);
+    connect(worker_, &CANWorker::replayStarted,    this, &ConnectionManager::replayStarted);
+    connect(worker_, &CANWorker::replayPosition,   this, &ConnectionManager::replayPosition);
+    connect(worker_, &CANWorker::replaySeeked,     this, &ConnectionManager::replaySeeked);
+    connect(worker_, &CANWorker::replayStopped,    this, &ConnectionManager::replayStopped);
+    can_thread_->start();
 
     // Keepalive ping every 2s
     ping_timer_ = new QTimer(this);
@@ -23,6 +41,12 @@ ConnectionManager::ConnectionManager(QObject* parent)
     connect(ping_timer_, &QTimer::timeout, this, &ConnectionManager::pingTimer);
 }
 
+ConnectionManager::~ConnectionManager() {
+    // Stop the worker before ring_ goes away
+    can_thread_->quit();
+    can_thread_->wait();
+}
+
 // ── Control (TCP) ──────────────────────────────────────
 
 void ConnectionManager::connectControl(const QString& host, quint16 port) {
@@ -40,9 +64,13 @@ bool ConnectionManager::isControlConnected() const {
 }
 
 void ConnectionManager::onTcpConnected() {
+    // Commands are a few bytes; don't let Nagle hold them back
+    tcp_->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     emit statusMessage(QStringLiteral("Control channel connected"));
     emit controlConnected();
     ping_timer_->start();
+    // Firmware may still be in a format from a previous session
+    sendCommand(ControlCmd::SET_WIRE_FORMAT, static_cast<uint8_t>(wire_format_));
 }
 
 void ConnectionManager::onTcpDisconnected() {
@@ -64,106 +92,103 @@ void ConnectionManager::onTcpReadyRead() {
 // ── CAN serial stream ──────────────────────────────────
 
 void ConnectionManager::connectCAN(const QString& portName, int baudRate) {
-    serial_->setPortName(portName);
-    serial_->setBaudRate(baudRate);
-    serial_->setDataBits(QSerialPort::Data8);
-    serial_->setParity(QSerialPort::NoParity);
-    serial_->setStopBits(QSerialPort::OneStop);
-    serial_->setFlowControl(QSerialPort::NoFlowControl);
-
-    if (serial_->open(QIODevice::ReadOnly)) {
-        emit statusMessage(QStringLiteral("CAN stream connected on ") + portName);
-        emit canConnected();
-    } else {
-        emit statusMessage(QStringLiteral("CAN serial open failed: ") + serial_->errorString());
-    }
+    QMetaObject::invokeMethod(worker_, [w = worker_, portName, baudRate] {
+        w->open(portName, baudRate);
+    }, Qt::QueuedConnection);
 }
 
 void ConnectionManager::disconnectCAN() {
-    if (serial_->isOpen()) serial_->close();
+    QMetaObject::invokeMethod(worker_, &CANWorker::close, Qt::QueuedConnection);
 }
 
 bool ConnectionManager::isCANConnected() const {
-    return serial_->isOpen();
+    return can_open_;
 }
 
-void ConnectionManager::onSerialReadyRead() {
-    QByteArray data = serial_->readAll();
-    for (char c : data) {
-        processSerialByte(static_cast<uint8_t>(c));
-    }
+quint32 ConnectionManager::corruptPacketCount() const {
+    return worker_->corruptPacketCount();
 }
 
-void ConnectionManager::onSerialError(QSerialPort::SerialPortError err) {
-    if (err != QSerialPort::NoError) {
-        emit statusMessage(QStringLiteral("Serial error: ") + serial_->errorString());
-        emit canDisconnected();
+void ConnectionManager::setWireFormat(Wire::Format fmt) {
+    if (fmt == wire_format_) return;
+    wire_format_ = fmt;
+    QMetaObject::invokeMethod(worker_, [w = worker_, fmt] { w->setWireFormat(fmt); },
+                              Qt::QueuedConnection);
+    if (isControlConnected()) {
+        sendCommand(ControlCmd::SET_WIRE_FORMAT, static_cast<uint8_t>(fmt));
     }
 }
 
-// ── Frame parser state machine ─────────────────────────
-
-void ConnectionManager::processSerialByte(uint8_t b) {
-    switch (frame_state_) {
-    case FrameState::WAIT_SOF:
-        if (b == FRAME_SOF) {
-            frame_buf_.clear();
-            frame_buf_.append(static_cast<char>(b));
-            frame_state_ = FrameState::READ_BODY;
-        }
-        break;
-
-    case FrameState::READ_BODY:
-        frame_buf_.append(static_cast<char>(b));
-        if (frame_buf_.size() == FRAME_SIZE) {
-            if (static_cast<uint8_t>(frame_buf_.back()) == FRAME_EOF) {
-                dispatchFrame();
-            }
-            // Either way, reset and hunt for next SOF
-            frame_state_ = FrameState::WAIT_SOF;
-            frame_buf_.clear();
-        }
-        break;
-    }
+// ── Capture and replay ─────────────────────────────────
+
+void ConnectionManager::startRecording(const QString& path) {
+    QMetaObject::invokeMethod(worker_, [w = worker_, path] { w->startRecording(path); },
+                              Qt::QueuedConnection);
 }
 
-void ConnectionManager::dispatchFrame() {
-    if (frame_buf_.size() != FRAME_SIZE) return;
+void ConnectionManager::stopRecording() {
+    QMetaObject::invokeMethod(worker_, &CANWorker::stopRecording, Qt::QueuedConnection);
+}
 
-    CANFrame f;
-    const uint8_t* raw = reinterpret_cast<const uint8_t*>(frame_buf_.constData());
-    f.sof  = raw[0];
-    f.id   = static_cast<uint16_t>((raw[1] << 8) | raw[2]);
-    f.len  = raw[3];
-    memcpy(f.data, raw + 4, 8);
-    f.eof  = raw[12];
+void ConnectionManager::startReplay(const QString& path, double speed) {
+    QMetaObject::invokeMethod(worker_, [w = worker_, path, speed] { w->startReplay(path, speed); },
+                              Qt::QueuedConnection);
+}
+
+void ConnectionManager::setReplaySpeed(double speed) {
+    QMetaObject::invokeMethod(worker_, [w = worker_, speed] { w->setReplaySpeed(speed); },
+                              Qt::QueuedConnection);
+}
 
-    emit canFrameReceived(f);
+void ConnectionManager::seekReplay(double pos_s) {
+    QMetaObject::invokeMethod(worker_, [w = worker_, pos_s] { w->seekReplay(pos_s); },
+                              Qt::QueuedConnection);
+}
+
+void ConnectionManager::stopReplay() {
+    QMetaObject::invokeMethod(worker_, &CANWorker::stopReplay, Qt::QueuedConnection);
 }
 
 // ── Command sending ────────────────────────────────────
 
-void ConnectionManager::sendCommand(ControlCmd cmd, uint8_t arg0, uint8_t arg1) {
-    if (!isControlConnected()) {
-        emit statusMessage(QStringLiteral("Not connected — command dropped"));
-        return;
-    }
-    QByteArray pkt;
+void ConnectionManager::appendCommand(QByteArray& pkt, ControlCmd cmd, uint8_t arg0, uint8_t arg1) {
     pkt.append(static_cast<char>(static_cast<uint8_t>(cmd)));
     // Determine how many arg bytes to send
-    if (cmd == ControlCmd::SET_THROTTLE) {
+    if (cmd == ControlCmd::SET_THROTTLE || cmd == ControlCmd::SET_WIRE_FORMAT) {
         pkt.append(static_cast<char>(arg0));
-    } else if (cmd == ControlCmd::SET_RPM_TARGET) {
+    } else if (cmd == ControlCmd::SET_RPM_TARGET || cmd == ControlCmd::SET_SAMPLE_RATE) {
         pkt.append(static_cast<char>(arg0));
         pkt.append(static_cast<char>(arg1));
     }
+}
+
+void ConnectionManager::sendCommand(ControlCmd cmd, uint8_t arg0, uint8_t arg1) {
+    QByteArray pkt;
+    appendCommand(pkt, cmd, arg0, arg1);
+    sendCommands(pkt);
+}
+
+void ConnectionManager::sendCommands(const QByteArray& pkt) {
+    if (!isControlConnected()) {
+        emit statusMessage(QStringLiteral("Not connected — command dropped"));
+        return;
+    }
+    // The firmware parses commands back to back, so a batch
+    // is just their concatenation in one segment
     tcp_->write(pkt);
+    tcp_->flush();
 }
 
 void ConnectionManager::sendThrottle(int pct) {
     sendCommand(ControlCmd::SET_THROTTLE, static_cast<uint8_t>(qBound(0, pct, 100)));
 }
 
+void ConnectionManager::sendSampleRate(int hz) {
+    uint16_t v = static_cast<uint16_t>(qBound(0, hz, 1000));
+    sendCommand(ControlCmd::SET_SAMPLE_RATE,
+                static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v & 0xFF));
+}
+
 void ConnectionManager::sendFaultInject(ControlCmd faultCmd) {
     sendCommand(faultCmd);
 }
@@ -172,6 +197,10 @@ void ConnectionManager::sendClearFaults() {
     sendCommand(ControlCmd::CLEAR_FAULTS);
 }
 
+void ConnectionManager::sendDTCDump() {
+    sendCommand(ControlCmd::DTC_DUMP);
+}
+
 void ConnectionManager::sendPing() {
     sendCommand(ControlCmd::PING);
 }
@@ -19,6 +19,14 @@ DTCViewer::DTCViewer(QWidget* parent) : QWidget(parent) {
     count_lbl_->setStyleSheet("color:#888; font-size:12px;");
     header_row->addWidget(count_lbl_);
 
+    dump_btn_ = new QPushButton("Read DTCs", this);
+    dump_btn_->setFixedSize(88, 26);
+    dump_btn_->setToolTip("Dump the ECU's DTC store with freeze frames");
+    dump_btn_->setStyleSheet(
+        "QPushButton{background:#2a4a3a;color:#3db464;border:none;border-radius:4px;}"
+        "QPushButton:hover{background:#3a5a4a;}");
+    header_row->addWidget(dump_btn_);
+
     clear_btn_ = new QPushButton("Clear DTCs", this);
     clear_btn_->setFixedSize(88, 26);
     clear_btn_->setStyleSheet(
@@ -28,21 +36,40 @@ DTCViewer::DTCViewer(QWidget* parent) : QWidget(parent) {
     root->addLayout(header_row);
 
     // ── Table ──────────────────────────────────────
-    table_ = new QTableWidget(0, 5, this);
-    table_->setHorizontalHeaderLabels({"Code", "Description", "Severity", "Count", "First seen"});
-    table_->setStyleSheet(
+    const QString table_style =
         "QTableWidget{background:#12121e;color:#ddd;gridline-color:#2a2a3e;"
         "selection-background-color:#2a2a4e;border:none;}"
         "QHeaderView::section{background:#1e1e30;color:#aaa;border:none;"
         "padding:4px;font-size:11px;border-bottom:1px solid #333;}"
-        "QTableWidget::item{padding:4px 8px;font-size:12px;}");
+        "QTableWidget::item{padding:4px 8px;font-size:12px;}";
+
+    table_ = new QTableWidget(0, 6, this);
+    table_->setHorizontalHeaderLabels({"Code", "Description", "Severity", "Status", "Count", "First seen"});
+    table_->setStyleSheet(table_style);
     table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setSelectionMode(QAbstractItemView::SingleSelection);
     table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table_->verticalHeader()->setVisible(false);
     table_->horizontalHeader()->setStretchLastSection(true);
     table_->setShowGrid(true);
-    root->addWidget(table_);
-
+    root->addWidget(table_, 3);
+
+    // ── Freeze frames of the selected DTC ──────────
+    auto* ff_title = new QLabel("Freeze frames (newest first)", this);
+    ff_title->setStyleSheet("color:#888; font-size:11px;");
+    root->addWidget(ff_title);
+
+    freeze_table_ = new QTableWidget(0, 4, this);
+    freeze_table_->setHorizontalHeaderLabels({"Age", "RPM", "Coolant", "Battery"});
+    freeze_table_->setStyleSheet(table_style);
+    freeze_table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    freeze_table_->setSelectionMode(QAbstractItemView::NoSelection);
+    freeze_table_->verticalHeader()->setVisible(false);
+    freeze_table_->horizontalHeader()->setStretchLastSection(true);
+    root->addWidget(freeze_table_, 1);
+
+    connect(table_, &QTableWidget::itemSelectionChanged, this, &DTCViewer::showFreezeFrames);
+    connect(dump_btn_, &QPushButton::clicked, this, &DTCViewer::dumpRequested);
     connect(clear_btn_, &QPushButton::clicked, this, [this]{
         clearDTCs();
         emit clearRequested();
@@ -50,15 +77,31 @@ DTCViewer::DTCViewer(QWidget* parent) : QWidget(parent) {
 }
 
 void DTCViewer::addDTC(uint16_t code, uint8_t count) {
-    QString code_str = QStringLiteral("P%1")
-                           .arg(code, 4, 16, QLatin1Char('0')).toUpper();
+    int row = rowFor(code);
+    table_->item(row, 4)->setText(QString::number(count));
+    setStatus(row, true);
+}
 
-    // Update existing row if already present
-    if (code_to_row_.contains(code)) {
-        int row = code_to_row_[code];
-        table_->item(row, 3)->setText(QString::number(count));
-        return;
+void DTCViewer::addDTCRecord(DTCRecord record) {
+    int row = rowFor(record.code);
+    table_->item(row, 4)->setText(QString::number(record.count));
+    setStatus(row, record.active);
+    if (!record.active) {
+        table_->item(row, 3)->setToolTip(
+            QStringLiteral("Last reported %1 s before the dump").arg(record.last_seen_s));
     }
+    freeze_frames_[record.code] = record.freeze_frames;
+
+    // Refresh the freeze-frame pane if this code is selected
+    const auto sel = table_->selectedItems();
+    if (!sel.isEmpty() && sel.first()->row() == row) showFreezeFrames();
+}
+
+int DTCViewer::rowFor(uint16_t code) {
+    if (code_to_row_.contains(code)) return code_to_row_[code];
+
+    QString code_str = QStringLiteral("P%1")
+                           .arg(code, 4, 16, QLatin1Char('0')).toUpper();
 
     // Insert new row
     int row = table_->rowCount();
@@ -80,17 +123,44 @@ void DTCViewer::addDTC(uint16_t code, uint8_t count) {
     table_->setItem(row, 0, cell(code_str, QColor("#ff8888")));
     table_->setItem(row, 1, cell(dtcDescription(code)));
     table_->setItem(row, 2, cell(sev, sev_color));
-    table_->setItem(row, 3, cell(QString::number(count)));
-    table_->setItem(row, 4, cell(QDateTime::currentDateTime().toString("hh:mm:ss")));
+    table_->setItem(row, 3, cell(QString()));
+    table_->setItem(row, 4, cell(QStringLiteral("0")));
+    table_->setItem(row, 5, cell(QDateTime::currentDateTime().toString("hh:mm:ss")));
 
     count_lbl_->setText(QStringLiteral("%1 DTC%2")
                             .arg(table_->rowCount())
                             .arg(table_->rowCount() == 1 ? "" : "s"));
+    return row;
+}
+
+void DTCViewer::setStatus(int row, bool active) {
+    auto* it = table_->item(row, 3);
+    it->setText(active ? "Active" : "Stored");
+    it->setForeground(active ? QColor("#ff5555") : QColor("#aaaaaa"));
+}
+
+void DTCViewer::showFreezeFrames() {
+    freeze_table_->setRowCount(0);
+    const auto sel = table_->selectedItems();
+    if (sel.isEmpty()) return;
+
+    const uint16_t code = code_to_row_.key(sel.first()->row());
+    const auto frames   = freeze_frames_.value(code);
+    freeze_table_->setRowCount(frames.size());
+    for (int i = 0; i < frames.size(); ++i) {
+        const DTCFreezeFrame& ff = frames[i];
+        freeze_table_->setItem(i, 0, new QTableWidgetItem(QStringLiteral("-%1 s").arg(ff.age_s, 0, 'f', 1)));
+        freeze_table_->setItem(i, 1, new QTableWidgetItem(QString::number(ff.rpm)));
+        freeze_table_->setItem(i, 2, new QTableWidgetItem(QStringLiteral("%1 °C").arg(ff.coolant_c)));
+        freeze_table_->setItem(i, 3, new QTableWidgetItem(QStringLiteral("%1 V").arg(ff.battery_mv / 1000.0, 0, 'f', 2)));
+    }
 }
 
 void DTCViewer::clearDTCs() {
     table_->setRowCount(0);
+    freeze_table_->setRowCount(0);
     code_to_row_.clear();
+    freeze_frames_.clear();
     count_lbl_->setText("0 DTCs");
 }
 
@@ -1,5 +1,86 @@
 #include "ECUDashboard.hpp"
 #include <QGroupBox>
+#include <QScreen>
+
+// ── ArcGauge ───────────────────────────────────────────
+
+// Arc parameters: 225° to 315° (270° sweep, open at bottom-right)
+static constexpr double START_DEG = 225.0;
+static constexpr double SPAN_DEG  = 270.0;
+
+QRectF ArcGauge::dialRect() const {
+    const int side = qMin(width(), height());
+    return QRectF((width()  - side) / 2.0 + 10,
+                  (height() - side) / 2.0 + 10,
+                  side - 20, side - 20);
+}
+
+// Everything that does not depend on the value
+void ArcGauge::renderBackground() {
+    const qreal dpr = devicePixelRatioF();
+    background_ = QPixmap(size() * dpr);
+    background_.setDevicePixelRatio(dpr);
+    background_.fill(Qt::transparent);
+
+    QPainter p(&background_);
+    p.setRenderHint(QPainter::Antialiasing);
+    const int    side = qMin(width(), height());
+    const QRectF rect = dialRect();
+
+    // Background track
+    QPen track(QColor(60, 60, 60), 12, Qt::SolidLine, Qt::RoundCap);
+    p.setPen(track);
+    p.drawArc(rect, static_cast<int>(START_DEG * 16),
+              static_cast<int>(-SPAN_DEG * 16));
+
+    // Unit text
+    QFont uf = font();
+    uf.setPointSize(qMax(1, static_cast<int>(side * 0.08)));
+    p.setFont(uf);
+    p.setPen(QColor(160, 160, 160));
+    QRectF unit_rect = rect.adjusted(0, rect.height() * 0.35, 0, 0);
+    p.drawText(unit_rect, Qt::AlignCenter, unit_);
+
+    // Title text
+    p.setPen(QColor(180, 180, 180));
+    QRectF title_rect(rect.left(), rect.bottom() - 22, rect.width(), 22);
+    p.drawText(title_rect, Qt::AlignCenter, title_);
+
+    value_font_ = font();
+    value_font_.setPointSize(qMax(1, static_cast<int>(side * 0.14)));
+    value_font_.setBold(true);
+}
+
+void ArcGauge::paintEvent(QPaintEvent*) {
+    if (background_.isNull() || background_.devicePixelRatio() != devicePixelRatioF())
+        renderBackground();
+
+    QPainter p(this);
+    p.drawPixmap(0, 0, background_);
+    p.setRenderHint(QPainter::Antialiasing);
+    const QRectF rect = dialRect();
+
+    // Coloured fill arc
+    double pct    = (value_ - min_) / (max_ - min_);
+    double sweep  = pct * SPAN_DEG;
+    QColor fill;
+    if (crit_ > 0 && value_ >= crit_) fill = QColor(220, 50, 50);
+    else if (warn_ > 0 && value_ >= warn_) fill = QColor(220, 160, 0);
+    else fill = QColor(50, 180, 100);
+
+    QPen arc_pen(fill, 12, Qt::SolidLine, Qt::RoundCap);
+    p.setPen(arc_pen);
+    p.drawArc(rect, static_cast<int>(START_DEG * 16),
+              static_cast<int>(-sweep * 16));
+
+    // Value text
+    p.setPen(Qt::white);
+    p.setFont(value_font_);
+    p.drawText(rect, Qt::AlignCenter,
+               QString::number(static_cast<int>(value_)));
+}
+
+// ── ECUDashboard ───────────────────────────────────────
 
 ECUDashboard::ECUDashboard(QWidget* parent) : QWidget(parent) {
     setStyleSheet("background-color: #1a1a2e; color: white;");
@@ -63,6 +144,31 @@ ECUDashboard::ECUDashboard(QWidget* parent) : QWidget(parent) {
     root->addWidget(bars_group);
 
     root->addStretch();
+
+    // One repaint pass per display frame; interval set in showEvent()
+    frame_timer_ = new QTimer(this);
+    frame_timer_->setTimerType(Qt::PreciseTimer);
+    frame_timer_->setInterval(16);
+    connect(frame_timer_, &QTimer::timeout, this, &ECUDashboard::repaintDirty);
+    frame_timer_->start();
+}
+
+// Match the timer to the screen the dashboard is on
+void ECUDashboard::showEvent(QShowEvent* ev) {
+    QWidget::showEvent(ev);
+    if (QScreen* s = screen()) {
+        const double hz = s->refreshRate() > 1 ? s->refreshRate() : 60.0;
+        frame_timer_->setInterval(qMax(1, static_cast<int>(1000.0 / hz)));
+    }
+}
+
+void ECUDashboard::repaintDirty() {
+    if (!isVisible()) return;
+    rpm_gauge_->flush();
+    coolant_gauge_->flush();
+    throttle_bar_->flush();
+    fuel_bar_->flush();
+    battery_bar_->flush();
 }
 
 void ECUDashboard::setRPM(int rpm) {
@@ -75,13 +181,11 @@ void ECUDashboard::setThrottle(int pct) {
 
 void ECUDashboard::setCoolantTemp(double degC) {
     coolant_gauge_->setValue(degC);
-    coolant_gauge_->update();
 }
 
 void ECUDashboard::setFuelLevel(int pct) {
     fuel_bar_->setValue(pct);
-    if (pct >= 0 && pct < 15) fuel_bar_->setWarningColor(true);
-    else                       fuel_bar_->setWarningColor(false);
+    fuel_bar_->setWarningColor(pct >= 0 && pct < 15);
 }
 
 void ECUDashboard::setBatteryVoltage(double volts) {
@@ -91,6 +195,8 @@ void ECUDashboard::setBatteryVoltage(double volts) {
 }
 
 void ECUDashboard::setFaultMask(uint8_t mask) {
+    if (mask == shown_fault_mask_) return;
+    shown_fault_mask_ = mask;
     if (mask == 0) {
         fault_badge_->setText("  NO FAULTS  ");
         fault_badge_->setStyleSheet(
@@ -110,6 +216,8 @@ void ECUDashboard::setFaultMask(uint8_t mask) {
 }
 
 void ECUDashboard::setEngineState(int s) {
+    if (s == shown_engine_state_) return;
+    shown_engine_state_ = s;
     engine_state_->setText(engineStateStr(s));
     engine_state_->setStyleSheet(engineStateStyle(s));
 }
@@ -1,4 +1,6 @@
 #include "FaultInjector.hpp"
+#include <QFileDialog>
+#include <QFileInfo>
 
 FaultInjector::FaultInjector(QWidget* parent) : QWidget(parent) {
     setStyleSheet("background:#1a1a2e; color:white;");
@@ -64,6 +66,101 @@ FaultInjector::FaultInjector(QWidget* parent) : QWidget(parent) {
     connect(sensor_disc_btn_, &QPushButton::clicked, this, &FaultInjector::onSensorDiscBtn);
     connect(volt_drop_btn_,   &QPushButton::clicked, this, &FaultInjector::onVoltDropBtn);
 
+    // ── Telemetry rate ─────────────────────────────
+    auto* rate_box = new QGroupBox("Telemetry", this);
+    rate_box->setStyleSheet(throttle_box->styleSheet());
+    auto* rlay = new QHBoxLayout(rate_box);
+    QLabel* rate_lbl = new QLabel("Sample stream:", this);
+    rate_lbl->setStyleSheet("color:#aaa; font-size:12px;");
+    rate_combo_ = new QComboBox(this);
+    rate_combo_->addItem("Off (10 Hz)", 0);
+    rate_combo_->addItem("100 Hz",      100);
+    rate_combo_->addItem("500 Hz",      500);
+    rate_combo_->addItem("1 kHz",       1000);
+    rate_combo_->setStyleSheet(
+        "QComboBox{background:#0d0d1a;color:white;border:1px solid #333;"
+        "border-radius:4px;padding:3px 8px;}");
+    rlay->addWidget(rate_lbl);
+    rlay->addWidget(rate_combo_, 1);
+    root->addWidget(rate_box);
+
+    connect(rate_combo_, &QComboBox::currentIndexChanged, this, [this](int idx) {
+        emit sampleRateChanged(rate_combo_->itemData(idx).toInt());
+    });
+
+    // ── Campaign ───────────────────────────────────
+    // Plays a scenario file with precise timing and reports
+    // injection → fault mask / DTC latency per fault
+    auto* camp_box = new QGroupBox("Campaign", this);
+    camp_box->setStyleSheet(throttle_box->styleSheet());
+    auto* clay = new QVBoxLayout(camp_box);
+    clay->setSpacing(6);
+
+    const QString btn_style =
+        "QPushButton{background:#333;color:#ddd;border:none;border-radius:4px;padding:4px 10px;}"
+        "QPushButton:hover{background:#444;}"
+        "QPushButton:checked{background:#4a3a1a;color:#e6a23c;}"
+        "QPushButton:disabled{color:#555;}";
+
+    auto* file_row = new QHBoxLayout;
+    auto* load_btn = new QPushButton("Load…", this);
+    load_btn->setStyleSheet(btn_style);
+    campaign_file_ = new QLabel("no scenario", this);
+    campaign_file_->setStyleSheet("color:#888; font-size:12px;");
+    file_row->addWidget(load_btn);
+    file_row->addWidget(campaign_file_, 1);
+    clay->addLayout(file_row);
+
+    auto* run_row = new QHBoxLayout;
+    QLabel* runs_lbl = new QLabel("Runs:", this);
+    runs_lbl->setStyleSheet("color:#aaa; font-size:12px;");
+    runs_spin_ = new QSpinBox(this);
+    runs_spin_->setRange(1, 1000);
+    runs_spin_->setStyleSheet(
+        "QSpinBox{background:#0d0d1a;color:white;border:1px solid #333;"
+        "border-radius:4px;padding:3px 8px;}");
+    run_btn_ = new QPushButton("▶  Run", this);
+    run_btn_->setCheckable(true);
+    run_btn_->setEnabled(false);
+    run_btn_->setStyleSheet(btn_style);
+    save_btn_ = new QPushButton("Save CSV…", this);
+    save_btn_->setEnabled(false);
+    save_btn_->setStyleSheet(btn_style);
+    run_row->addWidget(runs_lbl);
+    run_row->addWidget(runs_spin_);
+    run_row->addStretch();
+    run_row->addWidget(run_btn_);
+    run_row->addWidget(save_btn_);
+    clay->addLayout(run_row);
+
+    campaign_status_ = new QLabel(this);
+    campaign_status_->setStyleSheet("color:#aaa; font-size:11px;");
+    clay->addWidget(campaign_status_);
+    campaign_results_ = new QLabel(this);
+    campaign_results_->setStyleSheet("color:#ddd; font-family:monospace; font-size:11px;");
+    campaign_results_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    clay->addWidget(campaign_results_);
+    root->addWidget(camp_box);
+
+    connect(load_btn, &QPushButton::clicked, this, [this] {
+        const QString path = QFileDialog::getOpenFileName(
+            this, "Load scenario", campaign_path_, "Scenarios (*.scn);;All files (*)");
+        if (path.isEmpty()) return;
+        campaign_path_ = path;
+        campaign_file_->setText(QFileInfo(path).fileName());
+        campaign_file_->setToolTip(path);
+        run_btn_->setEnabled(true);
+    });
+    connect(run_btn_, &QPushButton::clicked, this, [this](bool checked) {
+        if (checked) emit campaignStartRequested(campaign_path_, runs_spin_->value());
+        else         emit campaignStopRequested();
+    });
+    connect(save_btn_, &QPushButton::clicked, this, [this] {
+        const QString path = QFileDialog::getSaveFileName(
+            this, "Save latency results", QString(), "CSV (*.csv)");
+        if (!path.isEmpty()) emit campaignSaveRequested(path);
+    });
+
     // ── Clear faults ────────────────────────────────
     clear_btn_ = new QPushButton("✔  Clear All Faults", this);
     clear_btn_->setFixedHeight(40);
@@ -78,6 +175,24 @@ FaultInjector::FaultInjector(QWidget* parent) : QWidget(parent) {
     root->addStretch();
 }
 
+void FaultInjector::setCampaignRunning(bool running) {
+    QSignalBlocker block(run_btn_);
+    run_btn_->setChecked(running);
+    run_btn_->setText(running ? "■  Stop" : "▶  Run");
+    runs_spin_->setEnabled(!running);
+    if (running) save_btn_->setEnabled(false);
+}
+
+void FaultInjector::setCampaignProgress(double pos_s, double duration_s) {
+    campaign_status_->setText(QStringLiteral("%1 / %2 s")
+                                  .arg(pos_s, 0, 'f', 1).arg(duration_s, 0, 'f', 1));
+}
+
+void FaultInjector::setCampaignResults(const QString& text) {
+    campaign_results_->setText(text);
+    save_btn_->setEnabled(!run_btn_->isChecked() && !text.isEmpty());
+}
+
 void FaultInjector::onThrottleSlider(int value) {
     throttle_label_->setText(QStringLiteral("Throttle: %1%").arg(value));
     emit throttleChanged(value);
@@ -0,0 +1,186 @@
+#include "FrameDecoder.hpp"
+#include <cstring>
+#include <QByteArray>
+#include <QDateTime>
+
+namespace {
+
+inline int u16(const uint8_t* d) { return (d[0] << 8) | d[1]; }
+inline int s16(const uint8_t* d) { return static_cast<int16_t>((d[0] << 8) | d[1]); }
+
+// Shortest payload each known ID needs; unknown IDs pass with any length
+int minLength(uint16_t id) {
+    switch (id) {
+    case CAN_ID_THROTTLE:
+    case CAN_ID_FUEL_LEVEL:
+    case CAN_ID_FAULT:        return 1;
+    case CAN_ID_RPM:
+    case CAN_ID_COOLANT_TEMP:
+    case CAN_ID_VOLTAGE:      return 2;
+    case CAN_ID_DTC:          return 3;
+    case CAN_ID_TASK_STATS:   return 7;
+    case CAN_ID_SAMPLE_HDR:
+    case CAN_ID_SAMPLE:
+    case CAN_ID_DTC_RECORD:
+    case CAN_ID_DTC_FREEZE:
+    case CAN_ID_QUEUE_STATS:  return 8;
+    default:                  return 0;
+    }
+}
+
+} // namespace
+
+// ── Worker thread: raw frame → flat record ─────────────
+
+bool FrameDecoder::decode(const CANFrame& frame, int64_t rx_ms, DecodedFrame& out) {
+    const uint8_t len = frame.len < 8 ? frame.len : 8;
+    if (len < minLength(frame.id)) return false;
+
+    out.rx_ms    = rx_ms;
+    out.id       = frame.id;
+    out.len      = len;
+    out.is_fault = false;
+    memcpy(out.data, frame.data, sizeof(out.data));
+
+    const uint8_t* d = out.data;
+    switch (frame.id) {
+    case CAN_ID_RPM:          out.value = u16(d);                      break;
+    case CAN_ID_THROTTLE:     out.value = d[0];                        break;
+    case CAN_ID_SAMPLE_HDR:   out.value = d[6];                        break;   // sample count
+    case CAN_ID_SAMPLE:       out.value = u16(d + 1);                  break;   // rpm
+    case CAN_ID_COOLANT_TEMP: out.value = s16(d) / 10.0;               break;   // signed, ×10
+    case CAN_ID_FUEL_LEVEL:   out.value = d[0] == 0xFF ? -1.0 : d[0];  break;   // 0xFF = disconnected
+    case CAN_ID_VOLTAGE:      out.value = u16(d) / 1000.0;             break;
+    case CAN_ID_TASK_STATS:   out.value = d[1];                        break;   // CPU %
+    case CAN_ID_QUEUE_STATS:  out.value = d[0];                        break;   // ring fill
+    case CAN_ID_DTC_FREEZE:   out.value = u16(d);                      break;   // rpm
+
+    case CAN_ID_FAULT:
+        out.value    = d[0];
+        out.is_fault = d[0] != 0;
+        break;
+
+    case CAN_ID_DTC:
+        out.value    = u16(d);
+        out.is_fault = true;
+        break;
+
+    case CAN_ID_DTC_RECORD:
+        out.value    = d[6];                                      // total
+        out.is_fault = d[6] != 0 && (d[2] & 0x01) != 0;           // active
+        break;
+
+    default:
+        out.value = 0;
+        break;
+    }
+    return true;
+}
+
+const char* FrameDecoder::name(uint16_t id) {
+    switch (id) {
+    case CAN_ID_RPM:          return "RPM";
+    case CAN_ID_THROTTLE:     return "Throttle";
+    case CAN_ID_SAMPLE_HDR:   return "Sample batch";
+    case CAN_ID_SAMPLE:       return "Sample";
+    case CAN_ID_COOLANT_TEMP: return "Coolant temp";
+    case CAN_ID_FUEL_LEVEL:   return "Fuel level";
+    case CAN_ID_VOLTAGE:      return "Battery";
+    case CAN_ID_FAULT:        return "Fault mask";
+    case CAN_ID_DTC:          return "DTC";
+    case CAN_ID_DTC_RECORD:   return "DTC record";
+    case CAN_ID_DTC_FREEZE:   return "Freeze frame";
+    case CAN_ID_TASK_STATS:   return "Task stats";
+    case CAN_ID_QUEUE_STATS:  return "Queue stats";
+    default:                  return "Unknown";
+    }
+}
+
+const char* FrameDecoder::unit(uint16_t id) {
+    switch (id) {
+    case CAN_ID_RPM:
+    case CAN_ID_SAMPLE:
+    case CAN_ID_DTC_FREEZE:   return "rpm";
+    case CAN_ID_THROTTLE:
+    case CAN_ID_FUEL_LEVEL:
+    case CAN_ID_TASK_STATS:   return "%";
+    case CAN_ID_COOLANT_TEMP: return "°C";
+    case CAN_ID_VOLTAGE:      return "V";
+    default:                  return "";
+    }
+}
+
+// ── GUI thread: text for visible rows ──────────────────
+
+QString FrameDecoder::timeText(const DecodedFrame& f) {
+    return QDateTime::fromMSecsSinceEpoch(f.rx_ms).toString(QStringLiteral("hh:mm:ss.zzz"));
+}
+
+QString FrameDecoder::idText(const DecodedFrame& f) {
+    return QStringLiteral("0x%1").arg(f.id, 3, 16, QLatin1Char('0')).toUpper();
+}
+
+QString FrameDecoder::rawText(const DecodedFrame& f) {
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(f.data), f.len)
+               .toHex(' ').toUpper();
+}
+
+QString FrameDecoder::valueText(const DecodedFrame& f) {
+    const uint8_t* d = f.data;
+
+    switch (f.id) {
+    case CAN_ID_SAMPLE_HDR:
+        return QStringLiteral("#%1  %2 × %3 ms")
+                   .arg(u16(d + 4)).arg(static_cast<int>(d[6])).arg(static_cast<int>(d[7]));
+
+    case CAN_ID_SAMPLE:
+        return QStringLiteral("+%1 ms  %2 rpm  %3 %  %4 °C  %5 V")
+                   .arg(static_cast<int>(d[0])).arg(u16(d + 1)).arg(static_cast<int>(d[3]))
+                   .arg(s16(d + 4) / 10.0, 0, 'f', 1).arg(u16(d + 6) / 1000.0, 0, 'f', 2);
+
+    case CAN_ID_FAULT:
+        return QStringLiteral("0x%1").arg(static_cast<int>(d[0]), 2, 16, QLatin1Char('0')).toUpper();
+
+    case CAN_ID_DTC:
+        return QStringLiteral("P%1 ×%2")
+                   .arg(QString::number(u16(d), 16).rightJustified(4, '0').toUpper())
+                   .arg(static_cast<int>(d[2]));
+
+    case CAN_ID_DTC_RECORD:
+        if (d[6] == 0) return QStringLiteral("store empty");
+        return QStringLiteral("%1/%2  P%3 %4 ×%5  %6 freeze")
+                   .arg(d[5] + 1).arg(static_cast<int>(d[6]))
+                   .arg(QString::number(u16(d), 16).rightJustified(4, '0').toUpper())
+                   .arg((d[2] & 0x01) ? "active" : "stored")
+                   .arg(static_cast<int>(d[3]))
+                   .arg(static_cast<int>(d[4]));
+
+    case CAN_ID_DTC_FREEZE:
+        return QStringLiteral("-%1 s  %2 rpm  %3 °C  %4 V")
+                   .arg(u16(d + 6) / 10.0, 0, 'f', 1).arg(u16(d)).arg(s16(d + 2))
+                   .arg(u16(d + 4) / 1000.0, 0, 'f', 2);
+
+    case CAN_ID_TASK_STATS:
+        return QStringLiteral("#%1  %2 %  stack %3  jitter %4 µs  missed %5")
+                   .arg(static_cast<int>(d[0])).arg(static_cast<int>(d[1]))
+                   .arg(u16(d + 2)).arg(u16(d + 4))
+                   .arg(static_cast<int>(d[6]));
+
+    case CAN_ID_QUEUE_STATS:
+        return QStringLiteral("ring %1/%2 (peak %3, drops %4)  fault %5/%6  tx batch %7/%8")
+                   .arg(static_cast<int>(d[0])).arg(static_cast<int>(d[1]))
+                   .arg(static_cast<int>(d[2])).arg(static_cast<int>(d[3]))
+                   .arg(static_cast<int>(d[4])).arg(static_cast<int>(d[5]))
+                   .arg(static_cast<int>(d[6])).arg(static_cast<int>(d[7]));
+
+    case CAN_ID_RPM:
+    case CAN_ID_THROTTLE:
+    case CAN_ID_COOLANT_TEMP:
+    case CAN_ID_FUEL_LEVEL:
+    case CAN_ID_VOLTAGE:
+        return QStringLiteral("%1 %2").arg(f.value).arg(QString::fromUtf8(unit(f.id)));
+
+    default:
+        return rawText(f);   // unknown frame — show the payload
+    }
+}
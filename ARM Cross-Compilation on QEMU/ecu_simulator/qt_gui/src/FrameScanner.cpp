@@ -0,0 +1,134 @@
+#include "FrameScanner.hpp"
+#include <cstring>
+
+namespace {
+
+CANFrame unpackLegacy(const uint8_t* raw) {
+    CANFrame f;
+    f.sof = raw[0];
+    f.id  = static_cast<uint16_t>((raw[1] << 8) | raw[2]);
+    f.len = raw[3];
+    memcpy(f.data, raw + 4, 8);
+    f.eof = raw[12];
+    return f;
+}
+
+} // namespace
+
+void FrameScanner::reset(Wire::Format fmt) {
+    format_        = fmt;
+    carry_len_     = 0;
+    cobs_len_      = 0;
+    cobs_overflow_ = false;
+    cobs_synced_   = false;
+    corrupt_       = 0;
+    last_error_    = Wire::DecodeResult::OK;
+}
+
+void FrameScanner::feed(uint8_t* data, size_t len, QVector<CANFrame>& out) {
+    if (format_ == Wire::Format::COBS_V1) {
+        feedCobs(data, len, out);
+    } else {
+        feedLegacy(data, len, out);
+    }
+}
+
+// ── Legacy 13-byte frames ──────────────────────────────
+
+void FrameScanner::feedLegacy(const uint8_t* data, size_t len, QVector<CANFrame>& out) {
+    size_t i = 0;
+
+    // Finish a frame split across reads
+    while (carry_len_ > 0) {
+        size_t take = FRAME_SIZE - carry_len_;
+        if (take > len - i) take = len - i;
+        memcpy(carry_ + carry_len_, data + i, take);
+        carry_len_ += take;
+        i          += take;
+        if (carry_len_ < FRAME_SIZE) return;
+
+        if (carry_[FRAME_SIZE - 1] == FRAME_EOF) {
+            out.push_back(unpackLegacy(carry_));
+            carry_len_ = 0;
+            break;
+        }
+        // Not a frame: resync on the next SOF inside the carry
+        auto* sof = static_cast<const uint8_t*>(memchr(carry_ + 1, FRAME_SOF, FRAME_SIZE - 1));
+        if (!sof) {
+            carry_len_ = 0;
+        } else {
+            carry_len_ = static_cast<size_t>(carry_ + FRAME_SIZE - sof);
+            memmove(carry_, sof, carry_len_);
+        }
+    }
+
+    // Whole frames straight from the read buffer
+    while (i < len) {
+        auto* sof = static_cast<const uint8_t*>(memchr(data + i, FRAME_SOF, len - i));
+        if (!sof) return;
+        i = static_cast<size_t>(sof - data);
+
+        if (len - i < FRAME_SIZE) {
+            carry_len_ = len - i;
+            memcpy(carry_, data + i, carry_len_);
+            return;
+        }
+        if (data[i + FRAME_SIZE - 1] == FRAME_EOF) {
+            out.push_back(unpackLegacy(data + i));
+            i += FRAME_SIZE;
+        } else {
+            ++i;
+        }
+    }
+}
+
+// ── COBS v1 packets ────────────────────────────────────
+
+void FrameScanner::feedCobs(uint8_t* data, size_t len, QVector<CANFrame>& out) {
+    size_t i = 0;
+    while (i < len) {
+        auto* delim = static_cast<uint8_t*>(memchr(data + i, Wire::DELIMITER, len - i));
+        size_t end  = delim ? static_cast<size_t>(delim - data) : len;
+        size_t n    = end - i;
+
+        if (!delim) {
+            // Packet continues in the next read
+            if (cobs_len_ + n < Wire::MAX_ENCODED) {
+                memcpy(cobs_carry_ + cobs_len_, data + i, n);
+                cobs_len_ += n;
+            } else {
+                cobs_overflow_ = true;
+            }
+            return;
+        }
+
+        // Bytes before the first delimiter are the tail of a packet
+        // we joined mid-stream, not corruption
+        if (cobs_synced_) {
+            if (cobs_overflow_ || cobs_len_ + n >= Wire::MAX_ENCODED) {
+                ++corrupt_;
+                last_error_ = Wire::DecodeResult::BAD_LENGTH;
+            } else if (cobs_len_ > 0) {
+                memcpy(cobs_carry_ + cobs_len_, data + i, n);
+                decodeCobs(cobs_carry_, cobs_len_ + n, out);
+            } else if (n > 0) {
+                decodeCobs(data + i, n, out);   // in place, no copy
+            }
+        }
+        cobs_synced_   = true;
+        cobs_len_      = 0;
+        cobs_overflow_ = false;
+        i = end + 1;
+    }
+}
+
+void FrameScanner::decodeCobs(uint8_t* pkt, size_t len, QVector<CANFrame>& out) {
+    uint32_t ts_ms = 0;
+    Wire::DecodeResult r = Wire::decode_batch(pkt, len, ts_ms, [&out](const CANFrame& f) {
+        out.push_back(f);
+    });
+    if (r != Wire::DecodeResult::OK) {
+        ++corrupt_;
+        last_error_ = r;
+    }
+}
@@ -1,6 +1,8 @@
 #include "MainWindow.hpp"
 #include <QSplitter>
 #include <QMessageBox>
+#include <QDateTime>
+#include <QFileDialog>
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     setWindowTitle("ECU Simulator — QEMU RISC-V");
@@ -8,7 +10,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     setStyleSheet("QMainWindow{background:#0d0d1a;} QTabWidget::pane{border:none;}");
 
     conn_mgr_  = new ConnectionManager(this);
-    can_parser_= new CANParser(this);
+    can_parser_= new CANParser(conn_mgr_->frameRing(), this);
+    campaign_  = new CampaignEngine(this);
 
     buildUI();
     buildToolbar();
@@ -35,7 +38,7 @@ void MainWindow::buildUI() {
     left_lay->addWidget(injector_,  2);
     splitter->addWidget(left_panel);
 
-    // Right: tabbed CAN monitor + DTC viewer
+    // Right: tabbed CAN monitor + DTC viewer + task stats
     auto* tabs = new QTabWidget(this);
     tabs->setStyleSheet(
         "QTabBar::tab{background:#1a1a2e;color:#888;padding:8px 18px;"
@@ -46,8 +49,12 @@ void MainWindow::buildUI() {
 
     can_monitor_ = new CANMonitor(this);
     dtc_viewer_  = new DTCViewer(this);
+    task_stats_  = new TaskStatsViewer(this);
+    trends_      = new TrendPanel(this);
     tabs->addTab(can_monitor_, "CAN Monitor");
+    tabs->addTab(trends_,      "Trends");
     tabs->addTab(dtc_viewer_,  "DTC Viewer");
+    tabs->addTab(task_stats_,  "Task Stats");
     splitter->addWidget(tabs);
 
     splitter->setStretchFactor(0, 2);
@@ -76,10 +83,45 @@ void MainWindow::buildToolbar() {
     auto* connect_act = new QAction("⚡  Connect to QEMU", this);
     auto* about_act   = new QAction("?  About", this);
 
+    record_act_ = new QAction("⏺  Record", this);
+    record_act_->setCheckable(true);
+    auto* replay_act = new QAction("▶  Replay…", this);
+    replay_stop_act_ = new QAction("⏹  Stop replay", this);
+    replay_stop_act_->setEnabled(false);
+
+    speed_box_ = new QComboBox(this);
+    speed_box_->addItem("1×",  1.0);
+    speed_box_->addItem("10×", 10.0);
+    speed_box_->addItem("Max", 0.0);
+    speed_box_->setStyleSheet("QComboBox{background:#0d0d1a;color:#aaa;border:1px solid #333;"
+                              "border-radius:4px;padding:2px 6px;}");
+
+    // Position in the capture, in thousandths of its length
+    seek_slider_ = new QSlider(Qt::Horizontal, this);
+    seek_slider_->setRange(0, 1000);
+    seek_slider_->setFixedWidth(200);
+    seek_slider_->setEnabled(false);
+
     tb->addAction(connect_act);
     tb->addSeparator();
+    tb->addAction(record_act_);
+    tb->addAction(replay_act);
+    tb->addWidget(speed_box_);
+    tb->addWidget(seek_slider_);
+    tb->addAction(replay_stop_act_);
+    tb->addSeparator();
     tb->addAction(about_act);
 
+    connect(record_act_,      &QAction::toggled,   this, &MainWindow::toggleRecording);
+    connect(replay_act,       &QAction::triggered, this, &MainWindow::openReplay);
+    connect(replay_stop_act_, &QAction::triggered, conn_mgr_, &ConnectionManager::stopReplay);
+    connect(speed_box_, &QComboBox::currentIndexChanged, this, [this] {
+        conn_mgr_->setReplaySpeed(speed_box_->currentData().toDouble());
+    });
+    connect(seek_slider_, &QSlider::sliderReleased, this, [this] {
+        conn_mgr_->seekReplay(replay_len_s_ * seek_slider_->value() / 1000.0);
+    });
+
     connect(connect_act, &QAction::triggered, this, &MainWindow::openConnectDialog);
     connect(about_act,   &QAction::triggered, this, [this]{
         QMessageBox::information(this, "About",
@@ -89,10 +131,7 @@ void MainWindow::buildToolbar() {
 }
 
 void MainWindow::wireSignals() {
-    // CAN frames: connection → parser → widgets
-    connect(conn_mgr_,  &ConnectionManager::canFrameReceived,
-            can_parser_, &CANParser::parseFrame);
-
+    // CAN frames: worker thread → ring → parser (60 Hz drain) → widgets
     connect(can_parser_, &CANParser::rpmUpdated,
             dashboard_,  &ECUDashboard::setRPM);
     connect(can_parser_, &CANParser::throttleUpdated,
@@ -107,20 +146,67 @@ void MainWindow::wireSignals() {
             dashboard_,  &ECUDashboard::setFaultMask);
     connect(can_parser_, &CANParser::engineStateUpdated,
             dashboard_,  &ECUDashboard::setEngineState);
-    connect(can_parser_, &CANParser::frameDecoded,
-            can_monitor_,&CANMonitor::addFrame);
+    connect(can_parser_, &CANParser::framesDecoded,
+            can_monitor_,&CANMonitor::addFrames);
+    connect(can_parser_, &CANParser::framesDecoded,
+            trends_,     &TrendPanel::addFrames);
+    connect(can_parser_, &CANParser::framesDropped, this, [this](quint32 total) {
+        onStatusMessage(QStringLiteral("GUI fell behind the CAN stream — %1 frames dropped").arg(total));
+    });
     connect(can_parser_, &CANParser::dtcReceived,
             dtc_viewer_, &DTCViewer::addDTC);
+    connect(can_parser_, &CANParser::dtcDumpStarted,
+            dtc_viewer_, &DTCViewer::clearDTCs);
+    connect(can_parser_, &CANParser::dtcRecordReceived,
+            dtc_viewer_, &DTCViewer::addDTCRecord);
+    connect(can_parser_, &CANParser::taskStatsReceived,
+            task_stats_, &TaskStatsViewer::updateTaskStats);
+    connect(can_parser_, &CANParser::queueStatsReceived,
+            task_stats_, &TaskStatsViewer::updateQueueStats);
 
     // Fault injector → connection manager
     connect(injector_, &FaultInjector::throttleChanged,
             conn_mgr_, &ConnectionManager::sendThrottle);
+    connect(injector_, &FaultInjector::sampleRateChanged,
+            conn_mgr_, &ConnectionManager::sendSampleRate);
     connect(injector_, &FaultInjector::injectFault,
             conn_mgr_, &ConnectionManager::sendFaultInject);
     connect(injector_, &FaultInjector::clearFaultsRequested,
             conn_mgr_, &ConnectionManager::sendClearFaults);
+
+    // Campaign: scheduled commands out, decoded frames in for latency
+    connect(campaign_,   &CampaignEngine::commandsReady,
+            conn_mgr_,   &ConnectionManager::sendCommands);
+    connect(can_parser_, &CANParser::framesDecoded,
+            campaign_,   &CampaignEngine::onFrames);
+    connect(campaign_,   &CampaignEngine::statusMessage, this, &MainWindow::onStatusMessage);
+    connect(campaign_,   &CampaignEngine::progress, this, [this](double pos_s, double len_s) {
+        injector_->setCampaignProgress(pos_s, len_s);
+        injector_->setCampaignResults(campaign_->summary());
+    });
+    connect(campaign_,   &CampaignEngine::finished, this, [this] {
+        injector_->setCampaignRunning(false);
+        injector_->setCampaignResults(campaign_->summary());
+    });
+    connect(injector_, &FaultInjector::campaignStartRequested, this, [this](const QString& path, int runs) {
+        if (!conn_mgr_->isControlConnected()) {
+            onStatusMessage(QStringLiteral("Campaign needs the control channel — connect first"));
+            injector_->setCampaignRunning(false);
+            return;
+        }
+        injector_->setCampaignRunning(campaign_->start(path, runs));
+    });
+    connect(injector_, &FaultInjector::campaignStopRequested, campaign_, &CampaignEngine::stop);
+    connect(injector_, &FaultInjector::campaignSaveRequested, this, [this](const QString& path) {
+        if (!campaign_->saveResults(path))
+            QMessageBox::warning(this, "Campaign", QStringLiteral("Could not write %1").arg(path));
+    });
+    connect(conn_mgr_, &ConnectionManager::controlDisconnected, campaign_, &CampaignEngine::stop);
+
     connect(dtc_viewer_, &DTCViewer::clearRequested,
             conn_mgr_,   &ConnectionManager::sendClearFaults);
+    connect(dtc_viewer_, &DTCViewer::dumpRequested,
+            conn_mgr_,   &ConnectionManager::sendDTCDump);
 
     // Connection status
     connect(conn_mgr_, &ConnectionManager::controlConnected,    this, &MainWindow::onControlConnected);
@@ -128,6 +214,62 @@ void MainWindow::wireSignals() {
     connect(conn_mgr_, &ConnectionManager::canConnected,        this, &MainWindow::onCANConnected);
     connect(conn_mgr_, &ConnectionManager::canDisconnected,     this, &MainWindow::onCANDisconnected);
     connect(conn_mgr_, &ConnectionManager::statusMessage,       this, &MainWindow::onStatusMessage);
+
+    // Capture / replay. A replay (or a seek) starts a fresh monitor
+    // history, since the store expects arrival times to only go forward.
+    connect(conn_mgr_, &ConnectionManager::recordingChanged, this, [this](bool on) {
+        QSignalBlocker block(record_act_);
+        record_act_->setChecked(on);
+    });
+    connect(conn_mgr_, &ConnectionManager::replayStarted, this, [this](double len_s) {
+        replay_len_s_ = len_s;
+        seek_slider_->setEnabled(len_s > 0);
+        seek_slider_->setValue(0);
+        replay_stop_act_->setEnabled(true);
+        can_monitor_->clearLog();
+        trends_->clear();
+        can_status_->setText("CAN: ▶ Replay");
+        can_status_->setStyleSheet("color:#e6a23c; padding:0 8px;");
+    });
+    connect(conn_mgr_, &ConnectionManager::replayPosition, this, [this](double pos_s) {
+        if (!seek_slider_->isSliderDown() && replay_len_s_ > 0)
+            seek_slider_->setValue(static_cast<int>(pos_s / replay_len_s_ * 1000.0));
+        seek_slider_->setToolTip(QStringLiteral("%1 / %2 s").arg(pos_s, 0, 'f', 1)
+                                                             .arg(replay_len_s_, 0, 'f', 1));
+    });
+    connect(conn_mgr_, &ConnectionManager::replaySeeked, can_monitor_, &CANMonitor::clearLog);
+    connect(conn_mgr_, &ConnectionManager::replaySeeked, trends_,      &TrendPanel::clear);
+    connect(conn_mgr_, &ConnectionManager::replayStopped, this, [this] {
+        seek_slider_->setEnabled(false);
+        replay_stop_act_->setEnabled(false);
+        onCANDisconnected();
+    });
+}
+
+// ── Capture / replay ──────────────────────────────────
+
+void MainWindow::toggleRecording(bool on) {
+    if (!on) {
+        conn_mgr_->stopRecording();
+        return;
+    }
+    const QString path = QFileDialog::getSaveFileName(
+        this, "Record CAN capture",
+        QDateTime::currentDateTime().toString("'can_'yyyyMMdd_hhmmss'.ecucap'"),
+        "ECU captures (*.ecucap)");
+    if (path.isEmpty()) {
+        QSignalBlocker block(record_act_);
+        record_act_->setChecked(false);
+        return;
+    }
+    conn_mgr_->startRecording(path);
+}
+
+void MainWindow::openReplay() {
+    const QString path = QFileDialog::getOpenFileName(
+        this, "Replay CAN capture", QString(), "ECU captures (*.ecucap)");
+    if (path.isEmpty()) return;
+    conn_mgr_->startReplay(path, speed_box_->currentData().toDouble());
 }
 
 // ── Connection dialog ─────────────────────────────────
@@ -158,9 +300,16 @@ void MainWindow::openConnectDialog() {
     auto* serial_port = new QLineEdit(s.value("serial_port", "COM3").toString(), dlg);
     // On WSL, QEMU exposes a PTY; socat or npiperelay maps it to a COM port on Windows.
 
+    auto* wire_format = new QComboBox(dlg);
+    wire_format->addItem("Legacy (13-byte frames)",  static_cast<int>(Wire::Format::LEGACY));
+    wire_format->addItem("Compact (COBS + CRC-16)",  static_cast<int>(Wire::Format::COBS_V1));
+    wire_format->setCurrentIndex(
+        wire_format->findData(s.value("wire_format", static_cast<int>(Wire::Format::LEGACY)).toInt()));
+
     form->addRow("Control host:",  tcp_host);
     form->addRow("Control port:",  tcp_port);
     form->addRow("CAN serial port:", serial_port);
+    form->addRow("CAN wire format:", wire_format);
 
     auto* note = new QLabel(
         "💡 Start QEMU via scripts/launch_qemu.sh first.\n"
@@ -180,7 +329,9 @@ void MainWindow::openConnectDialog() {
         s.setValue("tcp_host",    tcp_host->text());
         s.setValue("tcp_port",    tcp_port->value());
         s.setValue("serial_port", serial_port->text());
+        s.setValue("wire_format", wire_format->currentData().toInt());
 
+        conn_mgr_->setWireFormat(static_cast<Wire::Format>(wire_format->currentData().toInt()));
         conn_mgr_->connectControl(tcp_host->text(),
                                    static_cast<quint16>(tcp_port->value()));
         conn_mgr_->connectCAN(serial_port->text());
@@ -0,0 +1,140 @@
+#include "SignalHistory.hpp"
+#include <algorithm>
+#include <limits>
+
+// ── Ring ───────────────────────────────────────────────
+
+void SignalHistory::Ring::push(const Entry& e) {
+    if (size_ < buf_.size()) {
+        buf_[(start_ + size_) % buf_.size()] = e;
+        ++size_;
+    } else {
+        buf_[start_] = e;   // overwrite the oldest
+        start_ = (start_ + 1) % buf_.size();
+    }
+}
+
+size_t SignalHistory::Ring::lowerBound(uint32_t t) const {
+    size_t lo = 0;
+    size_t hi = size_;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).t1 < t) lo = mid + 1;
+        else                hi = mid;
+    }
+    return lo;
+}
+
+// ── History ────────────────────────────────────────────
+
+SignalHistory::SignalHistory()
+    : raw_(RAW_CAPACITY),
+      levels_(LEVELS - 1, Ring(BUCKET_CAPACITY)),
+      partial_(LEVELS - 1) {}
+
+void SignalHistory::clear() {
+    raw_.clear();
+    for (auto& l : levels_)  l.clear();
+    for (auto& p : partial_) p.n = 0;
+    origin_ms_ = 0;
+    last_t_    = 0;
+    last_v_    = 0;
+}
+
+void SignalHistory::append(int64_t t_ms, float value) {
+    if (empty()) origin_ms_ = t_ms;
+
+    // Relative, clamped to [last, UINT32_MAX] so every ring stays sorted
+    int64_t rel = t_ms - origin_ms_;
+    rel = std::max<int64_t>(rel, last_t_);
+    rel = std::min<int64_t>(rel, std::numeric_limits<uint32_t>::max());
+    last_t_ = static_cast<uint32_t>(rel);
+    last_v_ = value;
+
+    const Entry e{last_t_, last_t_, value, value};
+    raw_.push(e);
+    addToLevel(1, e);
+}
+
+// Fold e into level k's open bucket; a full bucket moves up
+void SignalHistory::addToLevel(int k, const Entry& e) {
+    if (k >= LEVELS) return;
+    Partial& p = partial_[static_cast<size_t>(k - 1)];
+    if (p.n == 0) {
+        p.e = e;
+    } else {
+        p.e.t1  = e.t1;
+        p.e.min = std::min(p.e.min, e.min);
+        p.e.max = std::max(p.e.max, e.max);
+    }
+    if (++p.n == FANOUT) {
+        levels_[static_cast<size_t>(k - 1)].push(p.e);
+        p.n = 0;
+        addToLevel(k + 1, p.e);
+    }
+}
+
+int64_t SignalHistory::firstTime() const {
+    for (int k = LEVELS - 1; k >= 0; --k) {
+        if (level(k).size() > 0) return origin_ms_ + level(k).at(0).t0;
+    }
+    return origin_ms_;
+}
+
+void SignalHistory::query(int64_t t0_ms, int64_t t1_ms, int columns, std::vector<Column>& out) const {
+    out.assign(static_cast<size_t>(std::max(columns, 0)), Column{0, 0, false});
+    if (empty() || columns <= 0 || t1_ms <= t0_ms || t1_ms <= origin_ms_) return;
+
+    const int64_t  max_rel = std::numeric_limits<uint32_t>::max();
+    const uint32_t q0 = static_cast<uint32_t>(std::clamp<int64_t>(t0_ms - origin_ms_, 0, max_rel));
+    const uint32_t q1 = static_cast<uint32_t>(std::clamp<int64_t>(t1_ms - origin_ms_, 0, max_rel));
+
+    // Finest level still holding the start of the window
+    int k = 0;
+    while (k < LEVELS - 1 && (level(k).size() == 0 || level(k).at(0).t0 > q0)) {
+        if (level(k + 1).size() == 0) break;
+        ++k;
+    }
+    // Coarser while there are more than FANOUT entries per column
+    auto entriesIn = [&](int lvl) {
+        const Ring& r = level(lvl);
+        return r.lowerBound(q1) - r.lowerBound(q0);
+    };
+    while (k < LEVELS - 1 && level(k + 1).size() > 0
+           && entriesIn(k) > static_cast<size_t>(FANOUT) * static_cast<size_t>(columns)) {
+        ++k;
+    }
+
+    const int64_t span = t1_ms - t0_ms;
+    auto column = [&](uint32_t t_rel) {
+        const int64_t c = (origin_ms_ + t_rel - t0_ms) * columns / span;
+        return static_cast<int>(std::clamp<int64_t>(c, 0, columns - 1));
+    };
+    auto fold = [&](const Entry& e) {
+        const int64_t a = origin_ms_ + e.t0;
+        const int64_t b = origin_ms_ + e.t1;
+        if (b < t0_ms || a >= t1_ms) return;
+        for (int c = column(e.t0), last = column(e.t1); c <= last; ++c) {
+            Column& col = out[static_cast<size_t>(c)];
+            if (!col.valid) {
+                col = Column{e.min, e.max, true};
+            } else {
+                col.min = std::min(col.min, e.min);
+                col.max = std::max(col.max, e.max);
+            }
+        }
+    };
+
+    const Ring& r = level(k);
+    for (size_t i = r.lowerBound(q0); i < r.size(); ++i) {
+        const Entry& e = r.at(i);
+        if (origin_ms_ + e.t0 >= t1_ms) break;
+        fold(e);
+    }
+    // Samples not yet in a complete level-k bucket sit in the
+    // open buckets of levels 1..k
+    for (int j = k; j >= 1; --j) {
+        const Partial& p = partial_[static_cast<size_t>(j - 1)];
+        if (p.n > 0) fold(p.e);
+    }
+}
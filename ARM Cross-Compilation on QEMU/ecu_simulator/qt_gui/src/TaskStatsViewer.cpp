@@ -0,0 +1,178 @@
+#include "TaskStatsViewer.hpp"
+#include <QTableWidgetItem>
+#include <QHeaderView>
+#include <QGroupBox>
+#include <QFormLayout>
+
+TaskStatsViewer::TaskStatsViewer(QWidget* parent) : QWidget(parent) {
+    setStyleSheet("background:#12121e; color:white;");
+    auto* root = new QVBoxLayout(this);
+    root->setContentsMargins(8, 8, 8, 8);
+    root->setSpacing(6);
+
+    // ── Header ─────────────────────────────────────
+    auto* header_row = new QHBoxLayout;
+    auto* title = new QLabel("Task Statistics", this);
+    title->setStyleSheet("font-weight:bold; font-size:13px;");
+    header_row->addWidget(title);
+    header_row->addStretch();
+
+    load_lbl_ = new QLabel("CPU load: —", this);
+    load_lbl_->setStyleSheet("color:#888; font-size:12px;");
+    header_row->addWidget(load_lbl_);
+
+    reset_btn_ = new QPushButton("Reset peaks", this);
+    reset_btn_->setFixedSize(96, 26);
+    reset_btn_->setStyleSheet(
+        "QPushButton{background:#333;color:#aaa;border:none;border-radius:4px;}"
+        "QPushButton:hover{background:#444;}");
+    header_row->addWidget(reset_btn_);
+    root->addLayout(header_row);
+
+    // ── Task table ─────────────────────────────────
+    table_ = new QTableWidget(NUM_TASKS, 6, this);
+    table_->setHorizontalHeaderLabels(
+        {"Task", "CPU %", "Stack free (words)", "Jitter (µs)", "Worst jitter (µs)", "Missed"});
+    table_->setStyleSheet(
+        "QTableWidget{background:#12121e;color:#ddd;gridline-color:#2a2a3e;"
+        "selection-background-color:#2a2a4e;border:none;}"
+        "QHeaderView::section{background:#1e1e30;color:#aaa;border:none;"
+        "padding:4px;font-size:11px;border-bottom:1px solid #333;}"
+        "QTableWidget::item{padding:4px 8px;font-size:12px;}");
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->verticalHeader()->setVisible(false);
+    table_->horizontalHeader()->setStretchLastSection(true);
+    table_->setShowGrid(true);
+    for (int row = 0; row < NUM_TASKS; ++row) {
+        table_->setItem(row, 0, new QTableWidgetItem(taskName(row)));
+        for (int col = 1; col < 6; ++col) {
+            auto* it = new QTableWidgetItem("—");
+            it->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table_->setItem(row, col, it);
+        }
+    }
+    root->addWidget(table_, 1);
+
+    // ── Queues ─────────────────────────────────────
+    auto* queues = new QGroupBox("Queues", this);
+    queues->setStyleSheet(
+        "QGroupBox { color:#aaa; border:1px solid #333; border-radius:6px;"
+        "margin-top:8px; padding-top:8px; }"
+        "QGroupBox::title { subcontrol-origin:margin; left:10px; }"
+    );
+    auto* form = new QFormLayout(queues);
+    form->setSpacing(8);
+
+    ring_bar_  = makeQueueBar();
+    fault_bar_ = makeQueueBar();
+    tx_bar_    = makeQueueBar();
+    ring_lbl_  = new QLabel("peak — · drops 0", queues);
+    ring_lbl_->setStyleSheet("color:#888; font-size:11px;");
+
+    form->addRow("Sample ring:", ring_bar_);
+    form->addRow("",             ring_lbl_);
+    form->addRow("Fault queue:", fault_bar_);
+    form->addRow("CAN TX batch peak:", tx_bar_);
+    root->addWidget(queues);
+
+    connect(reset_btn_, &QPushButton::clicked, this, &TaskStatsViewer::resetPeaks);
+}
+
+void TaskStatsViewer::updateTaskStats(TaskStats s) {
+    if (s.id >= NUM_TASKS) return;
+    int row = s.id;
+
+    worst_jitter_[row]  = qMax(worst_jitter_[row], s.jitter_us);
+    missed_total_[row] += s.missed;
+
+    auto set = [&](int col, const QString& text, const QColor& fg = QColor("#ddd")) {
+        table_->item(row, col)->setText(text);
+        table_->item(row, col)->setForeground(fg);
+    };
+
+    // Event-driven tasks have no period, so no jitter to report
+    bool periodic = s.id == static_cast<int>(TaskId::ENGINE)  ||
+                    s.id == static_cast<int>(TaskId::SENSORS) ||
+                    s.id == static_cast<int>(TaskId::CAN_TX)  ||
+                    s.id == static_cast<int>(TaskId::WATCHDOG);
+
+    set(1, QString::number(s.cpu_pct));
+    set(2, QString::number(s.stack_free_words),
+        s.stack_free_words < STACK_LOW_WORDS ? QColor("#ff5555") : QColor("#ddd"));
+    if (periodic) {
+        set(3, QString::number(s.jitter_us),
+            s.jitter_us > JITTER_WARN_US ? QColor("#ddaa22") : QColor("#ddd"));
+        set(4, QString::number(worst_jitter_[row]),
+            worst_jitter_[row] > JITTER_WARN_US ? QColor("#ddaa22") : QColor("#ddd"));
+        set(5, QString::number(missed_total_[row]),
+            missed_total_[row] ? QColor("#ff5555") : QColor("#ddd"));
+    }
+
+    if (s.id == static_cast<int>(TaskId::IDLE)) {
+        int load = 100 - s.cpu_pct;
+        load_lbl_->setText(QStringLiteral("CPU load: %1 %").arg(load));
+        load_lbl_->setStyleSheet(load > 80 ? "color:#ff5555; font-size:12px;"
+                                           : "color:#888; font-size:12px;");
+    }
+}
+
+void TaskStatsViewer::updateQueueStats(QueueStats s) {
+    ring_drops_total_ += s.ring_drops;
+    setQueueBar(ring_bar_,  s.ring_fill,  s.ring_cap);
+    setQueueBar(fault_bar_, s.fault_fill, s.fault_cap);
+    setQueueBar(tx_bar_,    s.tx_batch_peak, s.tx_batch_cap);
+    ring_lbl_->setText(QStringLiteral("peak %1 / %2 · drops %3")
+                           .arg(s.ring_peak).arg(s.ring_cap).arg(ring_drops_total_));
+    ring_lbl_->setStyleSheet(ring_drops_total_ ? "color:#ff5555; font-size:11px;"
+                                               : "color:#888; font-size:11px;");
+}
+
+void TaskStatsViewer::resetPeaks() {
+    for (int row = 0; row < NUM_TASKS; ++row) {
+        worst_jitter_[row] = 0;
+        missed_total_[row] = 0;
+        table_->item(row, 4)->setText("—");
+        table_->item(row, 5)->setText("—");
+    }
+    ring_drops_total_ = 0;
+    ring_lbl_->setText("peak — · drops 0");
+    ring_lbl_->setStyleSheet("color:#888; font-size:11px;");
+}
+
+QProgressBar* TaskStatsViewer::makeQueueBar() {
+    auto* bar = new QProgressBar(this);
+    bar->setRange(0, 1);
+    bar->setValue(0);
+    bar->setFormat("%v / %m");
+    bar->setFixedHeight(16);
+    bar->setStyleSheet(
+        "QProgressBar{background:#0d0d1a;border:1px solid #333;border-radius:4px;"
+        "color:#ddd;font-size:11px;text-align:center;}"
+        "QProgressBar::chunk{background:#3db464;border-radius:3px;}");
+    return bar;
+}
+
+void TaskStatsViewer::setQueueBar(QProgressBar* bar, int fill, int cap) {
+    bar->setRange(0, qMax(cap, 1));
+    bar->setValue(fill);
+    bool high = cap > 0 && fill * 4 >= cap * 3;
+    bar->setStyleSheet(QStringLiteral(
+        "QProgressBar{background:#0d0d1a;border:1px solid #333;border-radius:4px;"
+        "color:#ddd;font-size:11px;text-align:center;}"
+        "QProgressBar::chunk{background:%1;border-radius:3px;}")
+            .arg(high ? "#ddaa22" : "#3db464"));
+}
+
+QString TaskStatsViewer::taskName(int id) {
+    switch (static_cast<TaskId>(id)) {
+    case TaskId::ENGINE:   return "Engine";
+    case TaskId::SENSORS:  return "Sensors";
+    case TaskId::CAN_TX:   return "CAN TX";
+    case TaskId::DIAG:     return "Diag";
+    case TaskId::WATCHDOG: return "Watchdog";
+    case TaskId::UART_RX:  return "UART RX";
+    case TaskId::IDLE:     return "Idle";
+    default:               return QStringLiteral("Task %1").arg(id);
+    }
+}
@@ -0,0 +1,277 @@
+#include "TrendChart.hpp"
+#include <algorithm>
+#include <limits>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPolygonF>
+#include <QVBoxLayout>
+#include <QWheelEvent>
+
+// ── TrendChart ─────────────────────────────────────────
+
+TrendChart::TrendChart(const QString& title, const QString& unit, const QColor& color,
+                       const SignalHistory* history, QWidget* parent)
+    : QWidget(parent), title_(title), unit_(unit), color_(color), history_(history)
+{
+    setMinimumHeight(120);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void TrendChart::setWindow(int64_t t0_ms, int64_t t1_ms) {
+    t0_ = t0_ms;
+    t1_ = std::max(t1_ms, t0_ms + 1);
+    update();
+}
+
+QRect TrendChart::plotRect() const {
+    return rect().adjusted(LEFT_MARGIN, TOP_MARGIN, -RIGHT_MARGIN, -BOTTOM_MARGIN);
+}
+
+void TrendChart::paintEvent(QPaintEvent*) {
+    QPainter p(this);
+    p.fillRect(rect(), QColor(0x12, 0x12, 0x1e));
+
+    const QRect plot = plotRect();
+    if (plot.width() <= 0 || plot.height() <= 0) return;
+
+    // Title and latest value
+    p.setPen(QColor(180, 180, 180));
+    QFont f = font();
+    f.setPointSize(9);
+    p.setFont(f);
+    QString head = title_;
+    if (!history_->empty())
+        head += QStringLiteral("   %1 %2").arg(history_->lastValue(), 0, 'f', 1).arg(unit_);
+    p.drawText(QRect(plot.left(), 2, plot.width(), TOP_MARGIN - 4), Qt::AlignLeft | Qt::AlignVCenter, head);
+
+    // One column per pixel
+    history_->query(t0_, t1_, plot.width(), cols_);
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    for (const auto& c : cols_) {
+        if (!c.valid) continue;
+        lo = std::min(lo, c.min);
+        hi = std::max(hi, c.max);
+    }
+
+    p.setPen(QColor(0x2a, 0x2a, 0x3e));
+    p.drawRect(plot.adjusted(0, 0, -1, -1));
+    if (lo > hi) {
+        p.setPen(QColor(100, 100, 100));
+        p.drawText(plot, Qt::AlignCenter, QStringLiteral("no data in window"));
+        return;
+    }
+    if (hi - lo < 1e-3f) { lo -= 1; hi += 1; }
+    const float pad = (hi - lo) * 0.05f;
+    lo -= pad;
+    hi += pad;
+    auto y = [&](float v) { return plot.bottom() - (v - lo) / (hi - lo) * plot.height(); };
+
+    // Grid and value labels
+    p.setPen(QColor(120, 120, 140));
+    for (int i = 0; i <= 4; ++i) {
+        const float v  = lo + (hi - lo) * i / 4.0f;
+        const qreal yy = y(v);
+        p.setPen(QColor(0x22, 0x22, 0x34));
+        p.drawLine(QPointF(plot.left(), yy), QPointF(plot.right(), yy));
+        p.setPen(QColor(120, 120, 140));
+        p.drawText(QRectF(0, yy - 8, LEFT_MARGIN - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                   QString::number(v, 'f', hi - lo < 10 ? 1 : 0));
+    }
+
+    // Time labels at both ends
+    const QString fmt = (t1_ - t0_) > 86'400'000 ? "dd.MM hh:mm" : "hh:mm:ss";
+    const QRect tl(plot.left(), plot.bottom() + 2, plot.width(), BOTTOM_MARGIN - 2);
+    p.drawText(tl, Qt::AlignLeft  | Qt::AlignVCenter, QDateTime::fromMSecsSinceEpoch(t0_).toString(fmt));
+    p.drawText(tl, Qt::AlignRight | Qt::AlignVCenter, QDateTime::fromMSecsSinceEpoch(t1_).toString(fmt));
+
+    // Envelope: min → max in each column, joined across columns
+    QPolygonF trace;
+    trace.reserve(static_cast<int>(cols_.size()) * 2);
+    for (size_t x = 0; x < cols_.size(); ++x) {
+        const auto& c = cols_[x];
+        if (!c.valid) continue;
+        const qreal px = plot.left() + static_cast<qreal>(x) + 0.5;
+        trace << QPointF(px, y(c.min)) << QPointF(px, y(c.max));
+    }
+    p.setRenderHint(QPainter::Antialiasing, false);   // 1 px columns, AA only blurs
+    p.setPen(QPen(color_, 1));
+    p.drawPolyline(trace);
+}
+
+void TrendChart::wheelEvent(QWheelEvent* ev) {
+    const QRect plot = plotRect();
+    if (plot.width() <= 0) return;
+    const double frac  = std::clamp((ev->position().x() - plot.left()) / plot.width(), 0.0, 1.0);
+    const double scale = ev->angleDelta().y() > 0 ? 0.8 : 1.25;
+    const int64_t span   = t1_ - t0_;
+    const int64_t anchor = t0_ + static_cast<int64_t>(span * frac);
+    const int64_t nspan  = std::max<int64_t>(100, static_cast<int64_t>(span * scale));
+    const int64_t n0     = anchor - static_cast<int64_t>(nspan * frac);
+    emit windowRequested(n0, n0 + nspan);
+    ev->accept();
+}
+
+void TrendChart::mousePressEvent(QMouseEvent* ev) {
+    drag_x_  = static_cast<int>(ev->position().x());
+    drag_t0_ = t0_;
+}
+
+void TrendChart::mouseMoveEvent(QMouseEvent* ev) {
+    if (!(ev->buttons() & Qt::LeftButton)) return;
+    const QRect plot = plotRect();
+    if (plot.width() <= 0) return;
+    const int64_t span = t1_ - t0_;
+    const int64_t dt   = static_cast<int64_t>((drag_x_ - ev->position().x()) * span / plot.width());
+    emit windowRequested(drag_t0_ + dt, drag_t0_ + dt + span);
+}
+
+void TrendChart::mouseDoubleClickEvent(QMouseEvent*) {
+    emit followRequested();
+}
+
+// ── TrendPanel ─────────────────────────────────────────
+
+TrendPanel::TrendPanel(QWidget* parent) : QWidget(parent) {
+    setStyleSheet("background:#12121e; color:white;");
+    auto* root = new QVBoxLayout(this);
+    root->setContentsMargins(8, 8, 8, 8);
+    root->setSpacing(6);
+
+    // ── Toolbar ────────────────────────────────────
+    auto* toolbar = new QHBoxLayout;
+    auto* title = new QLabel("Signal Trends", this);
+    title->setStyleSheet("font-weight:bold; font-size:13px;");
+    toolbar->addWidget(title);
+    toolbar->addStretch();
+
+    const struct { const char* label; int64_t ms; } spans[] = {
+        {"1 min", 60'000}, {"10 min", 600'000}, {"1 h", 3'600'000}, {"All", 0},
+    };
+    for (const auto& s : spans) {
+        auto* b = new QPushButton(s.label, this);
+        b->setCheckable(true);
+        b->setChecked(s.ms == span_ms_);
+        b->setFixedSize(56, 24);
+        b->setStyleSheet(
+            "QPushButton{background:#333;color:#aaa;border:none;border-radius:4px;}"
+            "QPushButton:checked{background:#2a4a3a;color:#3db464;}"
+            "QPushButton:hover{background:#444;}");
+        const int64_t ms = s.ms;
+        connect(b, &QPushButton::clicked, this, [this, b, ms] {
+            for (auto* other : span_btns_) other->setChecked(other == b);
+            span_ms_ = ms;
+            follow_chk_->setChecked(true);
+            refresh();
+        });
+        span_btns_.append(b);
+        toolbar->addWidget(b);
+    }
+
+    follow_chk_ = new QCheckBox("Follow", this);
+    follow_chk_->setChecked(true);
+    follow_chk_->setStyleSheet("color:#aaa;");
+    toolbar->addWidget(follow_chk_);
+    root->addLayout(toolbar);
+
+    // ── Charts ─────────────────────────────────────
+    charts_ = {
+        new TrendChart("RPM",     "rpm", QColor(80, 160, 255),  &rpm_,     this),
+        new TrendChart("Coolant", "°C",  QColor(255, 140, 60),  &coolant_, this),
+        new TrendChart("Battery", "V",   QColor(61, 180, 100),  &battery_, this),
+    };
+    for (TrendChart* c : charts_) {
+        root->addWidget(c, 1);
+        connect(c, &TrendChart::windowRequested, this, [this](qint64 t0, qint64 t1) {
+            follow_chk_->setChecked(false);
+            setWindow(t0, t1);
+        });
+        connect(c, &TrendChart::followRequested, this, [this] {
+            follow_chk_->setChecked(true);
+            refresh();
+        });
+    }
+
+    // Repaint at a fixed rate, and only when something changed
+    refresh_ = new QTimer(this);
+    refresh_->setInterval(1000 / REFRESH_HZ);
+    connect(refresh_, &QTimer::timeout, this, [this] {
+        if (dirty_ && follow_chk_->isChecked()) refresh();
+        dirty_ = false;
+    });
+    refresh_->start();
+}
+
+void TrendPanel::addFrames(const QVector<DecodedFrame>& frames) {
+    for (const DecodedFrame& f : frames) {
+        const uint8_t* d = f.data;
+        switch (f.id) {
+        case CAN_ID_RPM:          rpm_.append(f.rx_ms, static_cast<float>(f.value));     break;
+        case CAN_ID_COOLANT_TEMP: coolant_.append(f.rx_ms, static_cast<float>(f.value)); break;
+        case CAN_ID_VOLTAGE:      battery_.append(f.rx_ms, static_cast<float>(f.value)); break;
+
+        // Sample stream: the batch was taken over count × period ms
+        // before its header arrived; each sample carries its offset
+        // from the previous one
+        case CAN_ID_SAMPLE_HDR:
+            sample_t_ms_ = f.rx_ms - d[6] * d[7];
+            break;
+        case CAN_ID_SAMPLE:
+            sample_t_ms_ += d[0];
+            rpm_.append(sample_t_ms_, unpack_u16(d + 1));
+            coolant_.append(sample_t_ms_, static_cast<int16_t>(unpack_u16(d + 4)) / 10.0f);
+            battery_.append(sample_t_ms_, unpack_u16(d + 6) / 1000.0f);
+            break;
+
+        default:
+            continue;
+        }
+        dirty_ = true;
+    }
+}
+
+void TrendPanel::clear() {
+    rpm_.clear();
+    coolant_.clear();
+    battery_.clear();
+    sample_t_ms_ = 0;
+    refresh();
+}
+
+int64_t TrendPanel::newest() const {
+    int64_t t = std::numeric_limits<int64_t>::min();
+    for (const SignalHistory* h : {&rpm_, &coolant_, &battery_}) {
+        if (!h->empty()) t = std::max(t, h->lastTime());
+    }
+    return t;
+}
+
+// Follow mode: the span ending at the newest sample ("All": everything held)
+void TrendPanel::refresh() {
+    if (follow_chk_->isChecked()) {
+        const int64_t end = newest();
+        if (end == std::numeric_limits<int64_t>::min()) {
+            setWindow(0, 1);
+            return;
+        }
+        int64_t start = end - span_ms_;
+        if (span_ms_ == 0) {
+            start = end;
+            for (const SignalHistory* h : {&rpm_, &coolant_, &battery_}) {
+                if (!h->empty()) start = std::min(start, h->firstTime());
+            }
+        }
+        setWindow(start, end + 1);
+        return;
+    }
+    setWindow(t0_, t1_);
+}
+
+void TrendPanel::setWindow(int64_t t0_ms, int64_t t1_ms) {
+    t0_ = t0_ms;
+    t1_ = t1_ms;
+    for (TrendChart* c : charts_) c->setWindow(t0_, t1_);
+}
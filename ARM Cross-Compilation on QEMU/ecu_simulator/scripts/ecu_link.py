@@ -0,0 +1,332 @@
+"""
+ecu_link.py — host-side helpers for talking to the ECU firmware.
+
+Mirrors firmware/include/ecu_protocol.hpp and ecu_wire.hpp:
+  * ControlLink  — control channel (UART1): TCP :5001 or host-build pipes
+  * FrameDecoder — CAN stream decoder for both wire formats
+  * load_scenario / trace_line — scenario files and CAN trace format
+"""
+import os
+import select
+import socket
+import struct
+
+# ── ecu_protocol.hpp ──────────────────────────────────────
+FRAME_SOF  = 0xAA
+FRAME_EOF  = 0x55
+FRAME_SIZE = 13
+
+CAN_ID_RPM          = 0x100
+CAN_ID_THROTTLE     = 0x101
+CAN_ID_SAMPLE_HDR   = 0x110
+CAN_ID_SAMPLE       = 0x111
+CAN_ID_COOLANT_TEMP = 0x200
+CAN_ID_FUEL_LEVEL   = 0x201
+CAN_ID_VOLTAGE      = 0x202
+CAN_ID_FAULT        = 0x7E0
+CAN_ID_DTC          = 0x7E8
+CAN_ID_DTC_RECORD   = 0x7E9
+CAN_ID_DTC_FREEZE   = 0x7EA
+
+CMD_SET_THROTTLE       = 0x01
+CMD_INJECT_OVERHEAT    = 0x10
+CMD_INJECT_SENSOR_DISC = 0x11
+CMD_INJECT_VOLT_DROP   = 0x12
+CMD_CLEAR_FAULTS       = 0x20
+CMD_DTC_DUMP           = 0x21
+CMD_SET_RPM_TARGET     = 0x30
+CMD_SET_SAMPLE_RATE    = 0x31
+CMD_SET_WIRE_FORMAT    = 0x40
+CMD_SIM_MODE           = 0x50
+CMD_SIM_STEP           = 0x51
+CMD_PING               = 0xFF
+
+FORMAT_LEGACY  = 0
+FORMAT_COBS_V1 = 1
+
+CLOCK_REALTIME = 0
+CLOCK_LOCKSTEP = 1
+SIM_STEP_MAX   = 0xFFFF
+
+# ── ecu_wire.hpp ──────────────────────────────────────────
+WIRE_VERSION_V1 = 0x01
+
+
+def crc16(data: bytes, crc: int = 0xFFFF) -> int:
+    """CRC-16/CCITT-FALSE."""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data: bytes) -> bytes | None:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class FrameDecoder:
+    """
+    Incremental CAN stream decoder. feed() returns a list of
+    (batch_ts_ms | None, can_id, data) tuples; batch_ts_ms is only
+    known in the COBS format.
+    """
+
+    def __init__(self, fmt: int = FORMAT_LEGACY, synced: bool = False):
+        # synced=True when the stream is known to start on a packet
+        # boundary (e.g. a pipe from process start)
+        self.fmt = fmt
+        self.buf = bytearray()
+        self.synced = synced
+        self.corrupt = 0
+
+    def feed(self, chunk: bytes) -> list:
+        self.buf += chunk
+        return self._feed_cobs() if self.fmt == FORMAT_COBS_V1 else self._feed_legacy()
+
+    def _feed_legacy(self) -> list:
+        frames = []
+        while True:
+            start = self.buf.find(FRAME_SOF)
+            if start < 0:
+                self.buf.clear()
+                break
+            if len(self.buf) - start < FRAME_SIZE:
+                del self.buf[:start]
+                break
+            raw = self.buf[start:start + FRAME_SIZE]
+            if raw[-1] != FRAME_EOF:
+                del self.buf[:start + 1]
+                continue
+            can_id = (raw[1] << 8) | raw[2]
+            length = min(raw[3], 8)
+            frames.append((None, can_id, bytes(raw[4:4 + length])))
+            del self.buf[:start + FRAME_SIZE]
+        return frames
+
+    def _feed_cobs(self) -> list:
+        frames = []
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                break
+            pkt = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if not self.synced:
+                self.synced = True
+                continue
+            if pkt:
+                batch = self._decode_batch(pkt)
+                if batch is None:
+                    self.corrupt += 1
+                else:
+                    frames += batch
+        return frames
+
+    @staticmethod
+    def _decode_batch(pkt: bytes) -> list | None:
+        raw = cobs_decode(pkt)
+        if raw is None or len(raw) < 7:
+            return None
+        body, crc = raw[:-2], struct.unpack(">H", raw[-2:])[0]
+        if crc16(body) != crc or body[0] != WIRE_VERSION_V1:
+            return None
+        ts = struct.unpack(">I", body[1:5])[0]
+        frames, p = [], 5
+        while p < len(body):
+            if p + 2 > len(body):
+                return None
+            hdr = struct.unpack(">H", body[p:p + 2])[0]
+            can_id, length = hdr >> 4, hdr & 0x0F
+            if length > 8 or p + 2 + length > len(body):
+                return None
+            frames.append((ts, can_id, bytes(body[p + 2:p + 2 + length])))
+            p += 2 + length
+        return frames
+
+
+class ControlLink:
+    """
+    Control channel (UART1). Also carries the firmware debug log back.
+    `sock` may be any object with sendall/recv/settimeout/close —
+    see PipeTransport for the host build.
+    """
+
+    def __init__(self, host: str, port: int = 5001, sock=None):
+        self.sock = sock or socket.create_connection((host, port))
+        self.rx = bytearray()
+
+    def send(self, cmd: int, *args: int):
+        self.sock.sendall(bytes([cmd, *args]))
+
+    def set_wire_format(self, fmt: int):
+        self.send(CMD_SET_WIRE_FORMAT, fmt)
+
+    def set_sample_rate(self, hz: int):
+        self.send(CMD_SET_SAMPLE_RATE, (hz >> 8) & 0xFF, hz & 0xFF)
+
+    def read_line(self, timeout: float = 5.0) -> str:
+        """Next debug line from UART1 (\\r\\n stripped)."""
+        self.sock.settimeout(timeout)
+        while b"\n" not in self.rx:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("control channel closed")
+            self.rx += chunk
+        line, _, rest = self.rx.partition(b"\n")
+        self.rx = bytearray(rest)
+        return line.decode(errors="replace").rstrip("\r")
+
+    def wait_sim_ack(self, timeout: float) -> int:
+        """Waits for '[SIM] t=<ms>' and returns the virtual time."""
+        while True:
+            line = self.read_line(timeout)
+            if line.startswith("[SIM] t="):
+                if line.endswith("stalled"):
+                    raise RuntimeError(f"firmware reported a stalled task: {line}")
+                return int(line[len("[SIM] t="):])
+
+    def sim_mode(self, mode: int, timeout: float = 5.0) -> int:
+        self.send(CMD_SIM_MODE, mode)
+        return self.wait_sim_ack(timeout)
+
+    def sim_step(self, ms: int, timeout: float = 30.0) -> int:
+        """Advances the virtual clock; blocks until the firmware has caught up."""
+        t = None
+        while ms > 0:
+            n = min(ms, SIM_STEP_MAX)
+            self.send(CMD_SIM_STEP, (n >> 8) & 0xFF, n & 0xFF)
+            t = self.wait_sim_ack(timeout)
+            ms -= n
+        return t
+
+    def close(self):
+        self.sock.close()
+
+
+class PipeTransport:
+    """Socket-like wrapper over a host-build process (stdin → UART1 RX, stderr ← UART1 TX)."""
+
+    def __init__(self, proc):
+        self.proc = proc
+        self.timeout = None
+
+    def sendall(self, data: bytes):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def settimeout(self, timeout):
+        self.timeout = timeout
+
+    def recv(self, n: int) -> bytes:
+        fd = self.proc.stderr.fileno()
+        ready, _, _ = select.select([fd], [], [], self.timeout)
+        if not ready:
+            raise socket.timeout()
+        return os.read(fd, n)
+
+    def close(self):
+        if self.proc.stdin and not self.proc.stdin.closed:
+            self.proc.stdin.close()
+
+
+def parse_sample_hdr(data: bytes):
+    """CAN 0x110 → (t0_ms, seq, count, period_ms)."""
+    return struct.unpack(">IHBB", data[:8])
+
+
+def parse_sample(data: bytes):
+    """CAN 0x111 → (dt_ms, rpm, throttle, coolant_c, battery_mv)."""
+    dt, rpm, thr, c10, mv = struct.unpack(">BHBhH", data[:8])
+    return dt, rpm, thr, c10 / 10.0, mv
+
+
+# ── Scenarios (scripts/scenarios/*.scn) ───────────────────
+# One event per line: <t_ms> <command> [arg]; '#' starts a comment.
+# "<t_ms> ramp <to> <duration_ms>" moves the throttle from its last
+# value to <to> in 1 % steps spread evenly over <duration_ms>; it is
+# expanded into throttle events here (and the same way by the GUI's
+# CampaignEngine), so runners only ever see single commands.
+SCENARIO_COMMANDS = {
+    "throttle":     lambda c, a: c.send(CMD_SET_THROTTLE, a),
+    "sample_rate":  lambda c, a: c.set_sample_rate(a),
+    "overheat":     lambda c, a: c.send(CMD_INJECT_OVERHEAT),
+    "sensor_disc":  lambda c, a: c.send(CMD_INJECT_SENSOR_DISC),
+    "voltage_drop": lambda c, a: c.send(CMD_INJECT_VOLT_DROP),
+    "clear":        lambda c, a: c.send(CMD_CLEAR_FAULTS),
+    "dtc_dump":     lambda c, a: c.send(CMD_DTC_DUMP),
+    "end":          None,   # stop stepping at t_ms
+}
+
+
+def ramp_events(t_ms: int, start: int, to: int, duration_ms: int) -> list:
+    """Throttle steps of a ramp: one per 1 %, the last at t_ms + duration_ms."""
+    steps = abs(to - start)
+    if steps == 0 or duration_ms <= 0:
+        return [(t_ms + max(duration_ms, 0), "throttle", to)]
+    sign = 1 if to > start else -1
+    return [(t_ms + duration_ms * k // steps, "throttle", start + sign * k)
+            for k in range(1, steps + 1)]
+
+
+def load_scenario(path: str) -> list:
+    """[(t_ms, command, arg)]; raises ValueError on a malformed file."""
+    events = []
+    last_t = 0
+    throttle = 0
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].split()
+            if not line:
+                continue
+            try:
+                t_ms, cmd = int(line[0]), line[1]
+                args = [int(a) for a in line[2:]]
+            except (IndexError, ValueError):
+                raise ValueError(f"{path}:{lineno}: expected '<t_ms> <command> [arg]'")
+            if cmd != "ramp" and cmd not in SCENARIO_COMMANDS:
+                raise ValueError(f"{path}:{lineno}: unknown command '{cmd}'")
+            if t_ms < last_t:
+                raise ValueError(f"{path}:{lineno}: events must be in time order")
+            last_t = t_ms
+            if cmd == "ramp":
+                if len(args) != 2 or not 0 <= args[0] <= 100:
+                    raise ValueError(f"{path}:{lineno}: expected '<t_ms> ramp <0-100> <duration_ms>'")
+                events += ramp_events(t_ms, throttle, args[0], args[1])
+                throttle = args[0]
+                continue
+            arg = args[0] if args else 0
+            if cmd == "throttle":
+                throttle = arg
+            events.append((t_ms, cmd, arg))
+    # Ramps may run past the lines after them
+    events.sort(key=lambda e: e[0])
+    if not events or events[-1][1] != "end":
+        raise ValueError(f"{path}: scenario must finish with an 'end' event")
+    return events
+
+
+def apply_scenario_event(ctrl: ControlLink, cmd: str, arg: int):
+    action = SCENARIO_COMMANDS[cmd]
+    if action:
+        action(ctrl, arg)
+
+
+# ── CAN traces ────────────────────────────────────────────
+TRACE_HEADER = "t_ms,can_id,data\n"
+
+
+def trace_line(ts: int, can_id: int, data: bytes) -> str:
+    return f"{ts},0x{can_id:03X},{data.hex().upper()}\n"
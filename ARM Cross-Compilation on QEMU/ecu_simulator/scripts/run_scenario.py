@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+run_scenario.py — deterministic ECU scenario runner.
+
+Puts the firmware in LOCKSTEP mode (virtual clock restarts at 0),
+then replays a scenario file: the virtual clock is stepped to each
+event's timestamp and the event's command is sent at exactly that
+virtual time. The CAN stream is decoded (compact format, which
+carries the virtual batch timestamp) and written as a trace:
+
+    t_ms,can_id,data
+    100,0x100,0320
+    ...
+
+The same scenario on the same firmware always gives the same trace,
+however fast the host runs it. Ten virtual minutes typically take a
+few seconds.
+
+Scenario file — one event per line, '#' starts a comment:
+    <t_ms> <command> [arg]
+Commands:
+    throttle <0-100>     sample_rate <Hz>
+    overheat             sensor_disc          voltage_drop
+    clear                dtc_dump             end   (stop stepping at t_ms)
+    ramp <0-100> <ms>    (throttle from its last value, 1 % steps over ms)
+
+Usage:
+    ./run_scenario.py scenarios/thermal_overheat.scn -o thermal.csv
+"""
+import argparse
+import socket
+import sys
+import threading
+import time
+
+import ecu_link as ecu
+
+
+class TraceWriter(threading.Thread):
+    """Decodes the CAN stream in the background and writes the trace."""
+
+    def __init__(self, sock: socket.socket, out):
+        super().__init__(daemon=True)
+        self.sock = sock
+        self.out = out
+        self.decoder = ecu.FrameDecoder(ecu.FORMAT_COBS_V1)
+        self.frames = 0
+        self.stop = threading.Event()
+
+    def run(self):
+        self.sock.settimeout(0.2)
+        while not self.stop.is_set():
+            try:
+                chunk = self.sock.recv(65536)
+            except socket.timeout:
+                continue
+            if not chunk:
+                break
+            for ts, can_id, data in self.decoder.feed(chunk):
+                self.out.write(ecu.trace_line(ts, can_id, data))
+                self.frames += 1
+
+
+def drain(sock: socket.socket, quiet: float = 0.3):
+    """Discards CAN bytes until the link has been quiet for `quiet` s."""
+    sock.settimeout(quiet)
+    try:
+        while sock.recv(65536):
+            pass
+    except socket.timeout:
+        pass
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("scenario")
+    ap.add_argument("-o", "--out", default="-", help="trace file (default stdout)")
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--ctrl-port", type=int, default=5001)
+    ap.add_argument("--can-port", type=int, default=5002, help="socat bridge of UART0")
+    ap.add_argument("--chunk", type=int, default=1000,
+                    help="max virtual ms per SIM_STEP (keeps the CAN stream flowing)")
+    args = ap.parse_args()
+
+    try:
+        events = ecu.load_scenario(args.scenario)
+    except ValueError as e:
+        sys.exit(str(e))
+    out = sys.stdout if args.out == "-" else open(args.out, "w", newline="\n")
+    out.write(ecu.TRACE_HEADER)
+
+    ctrl = ecu.ControlLink(args.host, args.ctrl_port)
+    can = socket.create_connection((args.host, args.can_port))
+
+    # Batch timestamps are only carried by the compact format
+    ctrl.set_wire_format(ecu.FORMAT_COBS_V1)
+    ctrl.sim_mode(ecu.CLOCK_LOCKSTEP)
+    # Nothing is sent until the first step; drop real-time leftovers
+    drain(can)
+
+    trace = TraceWriter(can, out)
+    trace.start()
+
+    started = time.monotonic()
+    now = 0
+    try:
+        for t_ms, cmd, arg in events:
+            while now < t_ms:
+                now = ctrl.sim_step(min(t_ms - now, args.chunk))
+            ecu.apply_scenario_event(ctrl, cmd, arg)
+            print(f"[SCN] t={now:>8} ms  {cmd} {arg}", file=sys.stderr)
+    finally:
+        ctrl.sim_mode(ecu.CLOCK_REALTIME)
+        # Let the last batches arrive before closing the trace
+        time.sleep(0.5)
+        trace.stop.set()
+        trace.join()
+        ctrl.close()
+        can.close()
+        if out is not sys.stdout:
+            out.close()
+
+    elapsed = time.monotonic() - started
+    print(f"[SCN] {now / 1000:.1f} s virtual in {elapsed:.1f} s "
+          f"({now / 1000 / max(elapsed, 1e-9):.0f}× real time), "
+          f"{trace.frames} frames, {trace.decoder.corrupt} corrupt packets",
+          file=sys.stderr)
+    return 0 if trace.decoder.corrupt == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())